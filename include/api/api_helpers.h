@@ -1,6 +1,12 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
+#include "model_catalog.h"
+#include "response_cache.h"
+#include "chat_race.h"
+#include "hedged_request.h"
+#include "error_classifier.h"
 
 /**
  * @brief Helper class for API validation operations.
@@ -45,10 +51,11 @@ public:
     static void displayChatStatus(const std::string& provider, const std::string& model, const std::string& apiUrl);
     
     /**
-     * Displays a progress message for model fetching.
+     * Displays where a model list came from (cache, revalidation or download).
      * @param provider The provider name
+     * @param catalog The catalog lookup result
      */
-    static void displayModelsFetchStatus(const std::string& provider);
+    static void displayModelCatalogStatus(const std::string& provider, const ModelCatalogResult& catalog);
     
     /**
      * Displays a progress message for chat request.
@@ -57,6 +64,60 @@ public:
      */
     static void displayChatRequestStatus(const std::string& provider, const std::string& model);
     
+    /**
+     * Displays that the outgoing conversation was trimmed to the token budget.
+     * @param sentMessages Messages in the request (including a summary, if any)
+     * @param totalMessages Messages in the full conversation
+     * @param tokenBudget The configured token budget
+     */
+    static void displayContextTrimmed(size_t sentMessages, size_t totalMessages, size_t tokenBudget);
+    
+    /**
+     * Displays that a chat reply was answered from the response cache.
+     * @param provider The provider name
+     * @param model The model name
+     * @param stats The cache counters after the lookup
+     */
+    static void displayCachedResponseStatus(const std::string& provider, const std::string& model,
+                                            const ResponseCacheStats& stats);
+    
+    /**
+     * Displays the contenders of a race before it starts.
+     * @param contenders The contenders
+     */
+    static void displayRaceStart(const std::vector<ModelTarget>& contenders);
+    
+    /**
+     * Displays the outcome and timing of every contender of a race.
+     * @param result The race outcome
+     */
+    static void displayRaceResult(const RaceResult& result);
+    
+    /**
+     * Displays that a hedge was sent, who won and the running counters.
+     * @param policy The hedging settings of the request
+     * @param outcome What happened to the hedge
+     * @param stats The counters after this request
+     */
+    static void displayHedgeResult(const HedgePolicy& policy, const HedgeOutcome& outcome, const HedgeStats& stats);
+    
+    /**
+     * Displays that a request failed and is sent to the next target of the chain.
+     * @param from The target that failed
+     * @param to The target tried next
+     * @param errorClass How the failure was classified
+     * @param errorMessage The error of the failed target
+     */
+    static void displayFailover(const ModelTarget& from, const ModelTarget& to, ErrorClass errorClass,
+                                const std::string& errorMessage);
+    
+    /**
+     * Displays that a request waited for the provider's rate limit.
+     * @param target The provider and model the request goes to
+     * @param waitedMs Time waited in milliseconds
+     */
+    static void displayRateLimitWait(const ModelTarget& target, double waitedMs);
+    
     /**
      * Displays an error message with optional response details.
      * @param errorMessage The main error message
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <ctime>
+#include <memory>
+#include <functional>
 #include <json/json.h>
 
 /**
@@ -25,25 +27,46 @@ struct ModelInfo {
 
 /**
  * @brief Request model for chat completion API calls.
+ *
+ * The JSON payload is built once when the request is constructed; the
+ * message array is moved into it when passed as an rvalue.
  */
 class ChatRequest {
 private:
     std::string model;
-    Json::Value messages;
+    Json::Value payload;
     
 public:
     /**
      * Constructs a chat request.
      * @param modelName The model to use for the chat
-     * @param chatMessages The message history for the chat
+     * @param chatMessages The message history for the chat (moved from if an rvalue)
      */
-    ChatRequest(const std::string& modelName, const Json::Value& chatMessages);
+    ChatRequest(const std::string& modelName, Json::Value chatMessages);
     
     /**
-     * Converts the request to a JSON payload.
-     * @return Json::Value containing the request payload
+     * Gets the JSON payload of the request.
+     * @return Reference to the request payload
      */
-    Json::Value toJson() const;
+    const Json::Value& toJson() const;
+    
+    /**
+     * Requests a Server-Sent-Events streamed response.
+     * @param enabled True to add "stream": true to the payload
+     */
+    void setStream(bool enabled);
+    
+    /**
+     * Checks if a streamed response is requested.
+     * @return True if streaming is enabled
+     */
+    bool isStream() const;
+    
+    /**
+     * Asks the server to report token usage at the end of a streamed response.
+     * @param enabled True to add "stream_options": {"include_usage": true}
+     */
+    void setIncludeUsage(bool enabled);
     
     /**
      * Gets the model name.
@@ -60,6 +83,7 @@ private:
     std::string content;
     bool isError;
     std::string errorMessage;
+    int completionTokens;
     
 public:
     /**
@@ -85,6 +109,120 @@ public:
      * @return The response content, or empty string if error
      */
     const std::string& getContent() const;
+    
+    /**
+     * Gets the number of generated tokens reported in the "usage" block.
+     * @return The completion token count, or -1 if the server did not report it
+     */
+    int getCompletionTokens() const;
+};
+
+/**
+ * @brief Incremental parser for streamed (Server-Sent-Events) chat completions.
+ *
+ * Raw body chunks are fed in as they arrive from the network; chunk boundaries
+ * may fall anywhere, including inside an event or a UTF-8 sequence. Every
+ * complete "data:" event is decoded and the text in choices[0].delta.content
+ * is handed to the delta callback immediately, while the full message is
+ * assembled for saving to history.
+ *
+ * If the server ignores "stream": true and answers with a plain JSON body,
+ * finish() falls back to parsing it like a ChatResponse.
+ */
+class ChatStreamParser {
+public:
+    /**
+     * Callback receiving each content delta as it is decoded.
+     */
+    using DeltaCallback = std::function<void(const std::string& delta)>;
+    
+    /**
+     * Constructs a stream parser.
+     * @param onDelta Callback invoked for every non-empty content delta
+     */
+    explicit ChatStreamParser(DeltaCallback onDelta);
+    
+    /**
+     * Feeds a raw chunk of the response body.
+     * @param data Pointer to the chunk data
+     * @param length Length of the chunk
+     * @return False if the stream failed and reading should stop
+     */
+    bool feed(const char* data, size_t length);
+    
+    /**
+     * Processes any buffered trailing data after the transfer ended.
+     */
+    void finish();
+    
+    /**
+     * Checks if the stream reported or caused an error.
+     * @return True if this is an error response
+     */
+    bool hasError() const;
+    
+    /**
+     * Gets the error message if the stream failed.
+     * @return The error message, or empty string if no error
+     */
+    const std::string& getErrorMessage() const;
+    
+    /**
+     * Gets the raw data received so far, for error reporting.
+     * @return The unparsed response text
+     */
+    const std::string& getRawResponse() const;
+    
+    /**
+     * Gets the assembled content of all deltas received so far.
+     * @return The response content
+     */
+    const std::string& getContent() const;
+    
+    /**
+     * Gets the finish reason reported by the server (e.g., "stop", "length").
+     * @return The finish reason, or empty string if none was reported
+     */
+    const std::string& getFinishReason() const;
+    
+    /**
+     * Checks if the terminating "[DONE]" event was received.
+     * @return True if the stream completed
+     */
+    bool isDone() const;
+    
+    /**
+     * Gets the number of generated tokens reported in the "usage" block.
+     * Most providers only send it in the last event (OpenAI-compatible servers
+     * when the request sets stream_options.include_usage).
+     * @return The completion token count, or -1 if the server did not report it
+     */
+    int getCompletionTokens() const;
+    
+private:
+    DeltaCallback onDelta;
+    std::unique_ptr<Json::CharReader> jsonReader;
+    std::string lineBuffer;
+    std::string eventData;
+    std::string rawResponse;
+    std::string content;
+    std::string finishReason;
+    std::string errorMessage;
+    bool isError;
+    bool done;
+    bool sawEvent;
+    int completionTokens;
+    
+    /**
+     * Processes a single line of the event stream (without line terminator).
+     * @param line The line to process
+     */
+    void processLine(const std::string& line);
+    
+    /**
+     * Dispatches the data collected for the current event.
+     */
+    void dispatchEvent();
 };
 
 /**
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <json/json.h>
+#include "model_target.h"
+
+/**
+ * @brief How a contender ended a race.
+ */
+enum class RaceOutcome {
+    Won,        // First complete, successful reply
+    Lost,       // Cancelled (or finished) after the winner
+    Failed      // Error before a winner was known
+};
+
+/**
+ * @brief Timing and outcome of one contender.
+ */
+struct RaceEntry {
+    ModelTarget contender;
+    RaceOutcome outcome = RaceOutcome::Failed;
+    double firstTokenMs = -1.0;     // -1 if no content arrived
+    double elapsedMs = 0.0;         // Until completion, failure or cancellation
+    std::string error;              // Set if the contender failed
+};
+
+/**
+ * @brief Outcome of a whole race.
+ */
+struct RaceResult {
+    std::vector<RaceEntry> entries; // In contender order
+    int winner = -1;                // Index into entries, -1 if every contender failed
+    std::string content;            // The winner's reply
+
+    /**
+     * Checks if any contender produced a reply.
+     * @return True if there is a winner
+     */
+    bool hasWinner() const { return winner >= 0; }
+};
+
+/**
+ * @brief Accumulated race results of one contender.
+ */
+struct RaceStats {
+    std::string label;
+    size_t races = 0;
+    size_t wins = 0;
+    size_t failures = 0;
+    double totalWinMs = 0.0;
+
+    /**
+     * Gets the mean time of the races won.
+     * @return Milliseconds, or 0 if none were won
+     */
+    double getMeanWinMs() const { return wins > 0 ? totalWinMs / static_cast<double>(wins) : 0.0; }
+};
+
+/**
+ * @brief Sends the same conversation to several providers/models at once and
+ *        keeps the first complete reply.
+ *
+ * Every contender streams its reply on its own thread, with the API URL and
+ * key of its own provider. The first contender to complete without an error
+ * wins; the requests of the others are cancelled at once (see
+ * HttpCancellation), including those still waiting for the first byte.
+ *
+ * Each race is appended to a log (~/.cache/aith/race.tsv), one line per
+ * contender: time, label, outcome, elapsed ms and first-token ms. readStats()
+ * aggregates it, so provider choice can follow measured latency.
+ */
+class ChatRace {
+public:
+    /**
+     * Runs a race.
+     * @param contenders The contenders
+     * @param messages The conversation to send to every contender
+     * @return The outcome, with the winner's reply
+     */
+    static RaceResult run(const std::vector<ModelTarget>& contenders, const Json::Value& messages);
+
+    /**
+     * Appends the outcome of a race to the race log.
+     * Failures only print a warning.
+     * @param result The race outcome
+     */
+    static void record(const RaceResult& result);
+
+    /**
+     * Aggregates the race log per contender.
+     * @return Stats ordered by wins, most first
+     */
+    static std::vector<RaceStats> readStats();
+
+    /**
+     * Gets the path of the race log.
+     * @return Path to race.tsv in the cache directory
+     */
+    static std::string getLogPath();
+
+    /**
+     * Gets the log name of an outcome.
+     * @param outcome The outcome
+     * @return "won", "lost" or "failed"
+     */
+    static const char* toString(RaceOutcome outcome);
+};
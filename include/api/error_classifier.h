@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <exception>
+
+/**
+ * @brief Kind of a failed API request, as far as the caller can act on it.
+ */
+enum class ErrorClass {
+    RateLimited,        // 429
+    Overloaded,         // 503, 529
+    ServerError,        // Other 5xx, 408
+    Connection,         // No response: connection failure or timeout
+    Auth,               // 401, 403
+    ModelUnavailable,   // The model does not exist or cannot serve chat completions
+    BadRequest,         // Other 4xx: the request itself was rejected
+    InvalidReply,       // The reply arrived but was unusable: an error event, or not a completion
+    Unknown             // Anything else (e.g. an unparsable reply)
+};
+
+/**
+ * @brief Decides how to react to a failed API request.
+ *
+ * One classification shared by chat failover, batch retries and the
+ * benchmark blacklist, so that they agree on what an error means:
+ * - retry: the same request to the same model may succeed shortly
+ * - fail over: another provider or model may succeed now
+ * - blacklist: the model will keep failing and should be skipped
+ *
+ * The HTTP status decides where there is one; the message is only inspected
+ * for the model errors that providers report with varying statuses.
+ */
+class ErrorClassifier {
+public:
+    /**
+     * Classifies a failure from its HTTP status and message.
+     * @param status The HTTP status (0 for no response, -1 if unknown)
+     * @param message The error message or response body
+     * @return The error class
+     */
+    static ErrorClass classify(int status, const std::string& message);
+
+    /**
+     * Classifies a caught exception (an HttpError carries its status).
+     * @param error The exception
+     * @return The error class
+     */
+    static ErrorClass classify(const std::exception& error);
+
+    /**
+     * Classifies an error found in a reply that arrived with a success status:
+     * an error event in a stream, or a body that is not a chat completion.
+     * @param message The error message
+     * @return ModelUnavailable if the message says so, else InvalidReply
+     */
+    static ErrorClass classifyReply(const std::string& message);
+
+    /**
+     * Checks if repeating the same request may succeed.
+     * @param errorClass The error class
+     * @return True for rate limiting, overload, server and connection errors
+     */
+    static bool isRetryable(ErrorClass errorClass);
+
+    /**
+     * Checks if another provider or model may succeed where this one failed.
+     * @param errorClass The error class
+     * @return True for everything but rejected requests and unknown errors
+     */
+    static bool shouldFailover(ErrorClass errorClass);
+
+    /**
+     * Checks if the model should be blacklisted.
+     * @param errorClass The error class
+     * @return True if the model is unavailable
+     */
+    static bool shouldBlacklist(ErrorClass errorClass);
+
+    /**
+     * Gets a short description of an error class.
+     * @param errorClass The error class
+     * @return E.g. "rate limited"
+     */
+    static const char* toString(ErrorClass errorClass);
+
+    /**
+     * Gets an identifier of an error class for metric labels.
+     * @param errorClass The error class
+     * @return E.g. "rate_limited"
+     */
+    static const char* toLabel(ErrorClass errorClass);
+
+private:
+    /**
+     * Checks if a message reports an unavailable model.
+     */
+    static bool isModelUnavailableMessage(const std::string& message);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <json/json.h>
+#include "error_classifier.h"
+#include "http_client.h"
+#include "http_retry.h"
+#include "model_target.h"
+
+/**
+ * @brief One target of a failover chain, ready to be sent to.
+ */
+struct FailoverRequest {
+    const ModelTarget& target;
+    size_t index;                           // Position in the chain; 0 is the selected model
+    std::string apiUrl;
+    std::string apiKey;
+    const Json::Value& payload;             // The request, naming the target's model
+    const HttpClient::Timeouts* timeouts;   // Per error class, see FailoverChain::getTimeouts
+    const RetryPolicy* retry;               // Retries only on the last target, one attempt before
+};
+
+/**
+ * @brief Outcome of sending to one target of a failover chain.
+ */
+struct FailoverResult {
+    bool succeeded = false;
+    bool delivered = false;     // Part of the reply already reached the user, so no failover
+    bool cancelled = false;     // The user went away; neither an error nor a reason to fail over
+    ErrorClass errorClass = ErrorClass::Unknown;
+    std::string errorMessage;
+
+    static FailoverResult success();
+    static FailoverResult failure(ErrorClass errorClass, const std::string& errorMessage, bool delivered = false);
+    static FailoverResult cancel();
+};
+
+/**
+ * @brief The targets a chat request is tried on, in order.
+ *
+ * The chain is the selected provider and model followed by its FALLBACK
+ * setting (provider config KEY@model, provider config, then main config),
+ * e.g. FALLBACK=groq:llama-3.1-70b-versatile,openrouter:meta-llama/llama-3.1-70b-instruct.
+ * Blacklisted and repeated fallbacks are left out; the selected model is
+ * always tried first.
+ *
+ * Each error class a timeout detects has its own, so a dead or stalled
+ * provider hands over instead of holding the request for the default 60 s:
+ * - FAILOVER_CONNECT_TIMEOUT_MS: connection failures, on every target (default 1000)
+ * - FAILOVER_READ_TIMEOUT_MS: longest silence of a streamed reply, while a
+ *   fallback is left (default 10000)
+ * - FAILOVER_RESPONSE_TIMEOUT_MS: longest wait for a buffered reply, which is
+ *   generated whole before its first byte, while a fallback is left (default 30000)
+ *
+ * A reply that arrives but is unusable (an error event in the stream, or a
+ * body that is not a completion) fails over as well.
+ */
+class FailoverChain {
+public:
+    /**
+     * @brief Sends the request to one target and reports how it went.
+     */
+    using Attempt = std::function<FailoverResult(const FailoverRequest& request)>;
+
+    static const int DEFAULT_CONNECT_TIMEOUT_MS;
+    static const int DEFAULT_READ_TIMEOUT_MS;
+    static const int DEFAULT_RESPONSE_TIMEOUT_MS;
+
+    /**
+     * Builds the chain for a provider and model.
+     * @param primary The selected provider and model
+     * @return The primary target followed by its usable fallbacks
+     * @throws std::invalid_argument if FALLBACK is malformed
+     */
+    static std::vector<ModelTarget> load(const ModelTarget& primary);
+
+    /**
+     * Gets the timeouts for a target: the connection timeout always, the
+     * read timeouts only while a fallback is left.
+     * @param target The target about to be sent to
+     * @param stream True if the reply is streamed
+     * @param hasFallback True if another target follows
+     * @return The timeouts
+     */
+    static HttpClient::Timeouts getTimeouts(const ModelTarget& target, bool stream, bool hasFallback);
+
+    /**
+     * Walks a chain until a target answers, for chat and the proxy alike.
+     *
+     * Each target waits for its provider's rate limit, is timed as a model
+     * request of the given source, and is blacklisted if the model is gone.
+     * A failure moves on to the next target if its class allows failover and
+     * nothing was delivered yet; the switch is shown on the console.
+     * @param chain The targets, from load()
+     * @param payload The request for the first target; the others get a copy naming their model
+     * @param stream True if the reply is streamed
+     * @param source The metrics source, e.g. "chat" or "proxy"
+     * @param attempt Sends to one target; an exception counts as a failure of its class
+     * @return The successful result, or the failure that ended the walk
+     * @throws The attempt's exception if the walk ends with it
+     */
+    static FailoverResult run(const std::vector<ModelTarget>& chain, const Json::Value& payload, bool stream,
+                              const std::string& source, const Attempt& attempt);
+};
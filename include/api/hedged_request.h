@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <json/json.h>
+#include "http_client.h"
+
+/**
+ * @brief Hedging settings for one provider and model.
+ */
+struct HedgePolicy {
+    bool enabled = false;           // HEDGE is set; latency samples are recorded
+    double delayMs = -1.0;          // Time without a first byte before hedging; -1 = not yet known
+    double percentile = 0.0;        // Percentile the delay was derived from; 0 if configured
+    std::string backupProvider;     // Where the hedge is sent
+    std::string backupModel;
+
+    /**
+     * Checks if a hedge may be sent for this request.
+     * @return True if hedging is enabled and the delay is known
+     */
+    bool isActive() const { return enabled && delayMs >= 0; }
+};
+
+/**
+ * @brief What happened to one hedged request.
+ */
+struct HedgeOutcome {
+    bool fired = false;             // The hedge was sent
+    bool hedgeWon = false;          // The hedge delivered the first byte
+    double firstByteMs = -1.0;      // Of the winner, from the start of the request
+};
+
+/**
+ * @brief Counters of hedged requests for one provider and model.
+ */
+struct HedgeStats {
+    uint64_t requests = 0;
+    uint64_t fired = 0;
+    uint64_t won = 0;
+};
+
+/**
+ * @brief Cuts tail latency by duplicating slow chat requests.
+ *
+ * When the first response byte of a request has not arrived after a delay,
+ * the same payload is sent again, to the same model or to a backup model.
+ * Whichever request delivers its first byte first is used and the other is
+ * cancelled (see HttpCancellation); only the winner's bytes reach the caller.
+ *
+ * Settings (provider config KEY@model, provider config, then main config):
+ * - HEDGE: true to enable hedging (default false)
+ * - HEDGE_AFTER_MS: fixed delay in milliseconds; without it the delay is
+ *   the HEDGE_PERCENTILE (default 95) of the recorded time to first byte of
+ *   the model (see LatencyHistory), once enough samples exist
+ * - HEDGE_MODEL: "model" or "provider:model" for the hedge (default: the same model)
+ *
+ * While hedging is enabled every request records its time to first byte, so
+ * the delay follows the measured distribution. The number of requests, fired
+ * hedges and hedge wins per provider/model is kept in
+ * ~/.cache/aith/hedge_stats, to weigh the extra requests against the latency
+ * saved.
+ */
+class HedgedRequest {
+public:
+    static const double DEFAULT_PERCENTILE;
+
+    /**
+     * Loads the hedging settings for a provider and model.
+     * @param provider The provider name
+     * @param model The model name
+     * @return The policy (disabled unless HEDGE is set)
+     */
+    static HedgePolicy loadPolicy(const std::string& provider, const std::string& model);
+
+    /**
+     * Sends a streaming chat request, hedging it if it is slow.
+     * @param provider The provider of the primary request
+     * @param apiUrl The API URL of the provider
+     * @param apiKey The API key of the provider
+     * @param payload The request payload (its "model" is the primary model)
+     * @param policy The hedging settings (must be enabled)
+     * @param timeouts Timeouts for both requests (nullptr for the defaults)
+     * @param retry Retry policy of the primary request, already charged to its rate limit
+     *              (nullptr for no retries); the hedge waits for its own provider's rate limit
+     * @param onChunk Callback receiving the winner's body chunks
+     * @return What happened to the hedge
+     * @throws std::runtime_error (HttpError) if the winning request fails, or both do
+     */
+    static HedgeOutcome send(const std::string& provider, const std::string& apiUrl, const std::string& apiKey,
+                             const Json::Value& payload, const HedgePolicy& policy,
+                             const HttpClient::Timeouts* timeouts, const RetryPolicy* retry,
+                             const HttpClient::ChunkCallback& onChunk);
+
+    /**
+     * Reads the hedging counters of a provider and model.
+     * @param provider The provider name
+     * @param model The model name
+     * @return The counters
+     */
+    static HedgeStats getStats(const std::string& provider, const std::string& model);
+
+private:
+    /**
+     * Adds one request to the counters of a provider and model, under a file lock.
+     */
+    static void recordStats(const std::string& provider, const std::string& model, const HedgeOutcome& outcome);
+
+    /**
+     * Gets the file holding the counters of all providers and models.
+     */
+    static std::string getStatsPath();
+};
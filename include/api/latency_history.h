@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Recent time-to-first-byte samples per provider and model, on disk.
+ *
+ * Every sample is the time from sending a chat request to its first response
+ * byte. The last MAX_SAMPLES samples of each provider/model are kept in
+ * ~/.cache/aith/latency/<provider>--<model>, one value in milliseconds per
+ * line, shared by all aith processes (updates hold an exclusive file lock).
+ *
+ * The samples are used to derive thresholds such as the hedging delay from
+ * the measured latency distribution instead of a fixed guess.
+ */
+class LatencyHistory {
+public:
+    static const size_t MAX_SAMPLES;
+    static const size_t MIN_SAMPLES;    // Fewer samples give no percentile
+
+    /**
+     * Adds a sample, dropping the oldest beyond MAX_SAMPLES.
+     * Failures are ignored; the history is advisory.
+     * @param provider The provider name
+     * @param model The model name
+     * @param firstByteMs Time to first byte in milliseconds
+     */
+    static void record(const std::string& provider, const std::string& model, double firstByteMs);
+
+    /**
+     * Reads the recorded samples, oldest first.
+     * @param provider The provider name
+     * @param model The model name
+     * @return The samples in milliseconds
+     */
+    static std::vector<double> read(const std::string& provider, const std::string& model);
+
+    /**
+     * Computes a percentile of the recorded samples (nearest rank).
+     * @param provider The provider name
+     * @param model The model name
+     * @param percentile The percentile, between 0 and 100
+     * @return The percentile in milliseconds, or -1 with fewer than MIN_SAMPLES samples
+     */
+    static double percentile(const std::string& provider, const std::string& model, double percentile);
+
+    /**
+     * Gets the file holding the samples of a provider and model.
+     * @param provider The provider name
+     * @param model The model name
+     * @return Path of the sample file
+     */
+    static std::string getPath(const std::string& provider, const std::string& model);
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include "api_models.h"
+
+/**
+ * @brief Selects models of a catalog by owner and id prefix.
+ * Empty fields match every model.
+ */
+struct ModelFilter {
+    std::string owner;    // Exact owner ("owned_by"), case-insensitive
+    std::string prefix;   // Leading part of the model id, case-sensitive
+
+    /**
+     * Checks if the filter selects every model.
+     * @return True if neither owner nor prefix is set
+     */
+    bool isEmpty() const;
+
+    /**
+     * Checks if a model is selected by the filter.
+     * @param model The model to check
+     * @return True if the model matches both owner and prefix
+     */
+    bool matches(const ModelInfo& model) const;
+};
+
+/**
+ * @brief Where the models of a catalog lookup came from.
+ */
+enum class ModelCatalogSource {
+    Cache,          // Fresh cache file, no request made
+    Revalidated,    // Cache was expired; the server confirmed it is unchanged (304)
+    Network,        // Downloaded and parsed the full model list
+    StaleCache      // Request failed; an expired cache file was used instead
+};
+
+/**
+ * @brief Result of a catalog lookup.
+ */
+struct ModelCatalogResult {
+    std::vector<ModelInfo> models;
+    ModelCatalogSource source = ModelCatalogSource::Network;
+    time_t fetchedAt = 0;   // When the model list was last confirmed by the API
+};
+
+/**
+ * @brief Per-provider on-disk cache of the provider's model list.
+ *
+ * The "/models" response of some providers is several hundred KB of JSON.
+ * The catalog keeps only the fields aith uses (id, owner, creation time) in
+ * a compact tab-separated file under ~/.cache/aith/models/<provider>.tsv,
+ * so listing models and starting a benchmark read a small file instead of
+ * making a request and parsing the whole JSON document.
+ *
+ * Cache lifetime:
+ * - Younger than MODEL_CACHE_TTL seconds (provider config, then main config,
+ *   default 3600): used as is. 0 always revalidates.
+ * - Expired: revalidated with If-None-Match / If-Modified-Since when the server
+ *   sent an ETag or Last-Modified; a 304 only refreshes the timestamp.
+ * - Request failed: an expired cache is still used, with a warning.
+ * - A changed API_URL or refresh = true ignores the cache.
+ *
+ * The blacklist flag is not cached; it is applied on every load so that
+ * blacklist changes show up immediately.
+ */
+class ModelCatalog {
+public:
+    static const long DEFAULT_TTL_SECONDS;
+
+    /**
+     * Gets the models of a provider, from the cache when possible.
+     * @param provider The provider name
+     * @param apiUrl The provider's API base URL
+     * @param apiKey The API key for authentication
+     * @param refresh True to ignore the cache and download the list
+     * @return The models and where they came from
+     * @throws std::runtime_error if the list cannot be downloaded or parsed and no cache exists
+     */
+    static ModelCatalogResult load(const std::string& provider, const std::string& apiUrl,
+                                   const std::string& apiKey, bool refresh = false);
+
+    /**
+     * Selects the models matching a filter.
+     * @param models The models to filter
+     * @param filter The filter to apply
+     * @return The matching models, in their original order
+     */
+    static std::vector<ModelInfo> filter(const std::vector<ModelInfo>& models, const ModelFilter& filter);
+
+    /**
+     * Gets the cache lifetime for a provider.
+     * Read from MODEL_CACHE_TTL in the provider config, falling back to the main config.
+     * @param provider The provider name
+     * @return Lifetime in seconds (0 = always revalidate)
+     */
+    static long getTtlSeconds(const std::string& provider);
+
+    /**
+     * Gets the path of a provider's cache file.
+     * @param provider The provider name
+     * @return Path to the cache file
+     */
+    static std::string getCachePath(const std::string& provider);
+
+private:
+    /**
+     * @brief Content of a cache file.
+     */
+    struct CacheFile {
+        std::string url;            // API base URL the list was fetched from
+        time_t fetchedAt = 0;
+        std::string etag;
+        std::string lastModified;
+        std::vector<ModelInfo> models;
+    };
+
+    /**
+     * Reads a cache file, reusing the parsed content while the file is unchanged.
+     * @param path Path to the cache file
+     * @param cache Receives the content
+     * @return False if the file is missing or malformed
+     */
+    static bool readCache(const std::string& path, CacheFile& cache);
+
+    /**
+     * Parses a cache file from disk.
+     * @param path Path to the cache file
+     * @param cache Receives the content
+     * @return False if the file is missing or malformed
+     */
+    static bool parseCache(const std::string& path, CacheFile& cache);
+
+    /**
+     * Writes a cache file atomically (temporary file + rename).
+     * If the write fails, a warning is printed, the previous file stays in
+     * place, and the listing is still returned to the caller.
+     * @param path Path to the cache file
+     * @param cache The content to write
+     */
+    static void writeCache(const std::string& path, const CacheFile& cache);
+
+    /**
+     * Downloads the model list, revalidating the cached copy when it has validators.
+     * @param provider The provider name
+     * @param apiUrl The provider's API base URL
+     * @param apiKey The API key for authentication
+     * @param cached The cached copy to revalidate (nullptr if none is usable)
+     * @param notModified Set to true if the server confirmed the cached copy (304)
+     * @return The new cache content, stamped with the current time
+     * @throws std::runtime_error if the request fails or the response cannot be parsed
+     */
+    static CacheFile fetch(const std::string& provider, const std::string& apiUrl,
+                           const std::string& apiKey, const CacheFile* cached, bool& notModified);
+
+    /**
+     * Sets the blacklist flag of every model.
+     * @param provider The provider name
+     * @param models The models to update
+     */
+    static void applyBlacklist(const std::string& provider, std::vector<ModelInfo>& models);
+
+    /**
+     * Replaces characters that would break the line format (tabs, newlines).
+     * @param value The value to sanitize
+     * @return The value safe to store in one field
+     */
+    static std::string sanitizeField(const std::string& value);
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief A model at a specific provider, written "provider:model".
+ *
+ * Used wherever requests go to other providers than the current one
+ * (race contenders, hedge targets, failover chains). Only the first ':'
+ * separates, so model ids may contain ':' (e.g. "openrouter:meta-llama/x:free").
+ */
+struct ModelTarget {
+    std::string provider;
+    std::string model;
+
+    /**
+     * Gets the "provider:model" label of the target.
+     * @return The label
+     */
+    std::string getLabel() const { return provider + ":" + model; }
+
+    /**
+     * Parses a "provider:model" target; "provider" alone uses its default model.
+     * @param spec The target, e.g. "groq:llama-3.1-8b-instant"
+     * @return The target
+     * @throws std::invalid_argument if the provider is empty or has no default model
+     */
+    static ModelTarget parse(const std::string& spec);
+
+    /**
+     * Parses a comma-separated list of targets; blank items are skipped.
+     * @param specs The targets, e.g. "groq:a, openrouter:b"
+     * @return The targets in order
+     * @throws std::invalid_argument if a target is malformed
+     */
+    static std::vector<ModelTarget> parseList(const std::string& specs);
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <json/json.h>
+#include "http_retry.h"
+
+/**
+ * @brief Request and token limits for one provider.
+ */
+struct RateLimits {
+    double requestsPerMinute = 0.0;     // 0 = unlimited
+    double tokensPerMinute = 0.0;       // 0 = unlimited
+
+    /**
+     * Checks if requests to the provider are limited at all.
+     * @return True if either limit is set
+     */
+    bool isEnabled() const { return requestsPerMinute > 0 || tokensPerMinute > 0; }
+};
+
+/**
+ * @brief Token buckets per provider, shared by all aith processes.
+ *
+ * Parallel aith processes (batch scripts, several terminals) would each send
+ * at full speed and collect 429s together. Every chat, batch and benchmark
+ * request, and every retry of one, first takes one request and its estimated
+ * tokens from the provider's buckets, and waits while they are empty. The
+ * provider config (or the main config, for every provider) sets their size:
+ * - RATE_LIMIT_RPM: requests per minute
+ * - RATE_LIMIT_TPM: tokens per minute (prompt estimate plus max_tokens)
+ *
+ * The buckets live in a small memory-mapped file,
+ * ~/.cache/aith/ratelimit/<provider>, updated under an exclusive file lock,
+ * so all processes draw from the same budget. Both refill continuously at
+ * their per-minute rate up to one minute's worth.
+ *
+ * The buckets also follow what the provider reports, with or without limits
+ * in the config: the remaining counts of its x-ratelimit-* headers lower the
+ * buckets, and an exhausted limit or a 429 pauses every process until the
+ * reported reset.
+ *
+ * All methods are thread-safe; failures to use the state file only disable
+ * limiting, never a request.
+ */
+class RateLimiter {
+public:
+    /**
+     * Loads the limits of a provider from its config.
+     * @param provider The provider name
+     * @return The limits (disabled unless configured)
+     */
+    static RateLimits loadLimits(const std::string& provider);
+
+    /**
+     * Waits until the provider's buckets allow a request, then takes from them.
+     * Also hooks the request's retry policy, so that each retry takes from
+     * the buckets again and the rate limit headers of the responses update them.
+     * @param provider The provider name
+     * @param payload The chat request payload, for the token estimate
+     * @param retry The retry policy the request is sent with
+     * @return Time waited in milliseconds
+     */
+    static double acquire(const std::string& provider, const Json::Value& payload, RetryPolicy& retry);
+
+    /**
+     * Adjusts the provider's buckets to the rate limit state it reported.
+     * @param provider The provider name
+     * @param rateLimit The state from the response headers
+     */
+    static void update(const std::string& provider, const HttpRateLimit& rateLimit);
+
+    /**
+     * Estimates the tokens a chat request counts against a token limit.
+     * @param payload The chat request payload
+     * @return The estimated prompt tokens plus the requested completion tokens
+     */
+    static size_t estimateTokens(const Json::Value& payload);
+
+    /**
+     * Gets the state file of a provider's buckets.
+     * @param provider The provider name
+     * @return Path of the state file
+     */
+    static std::string getPath(const std::string& provider);
+
+private:
+    /**
+     * Waits until the provider's buckets allow a request, then takes from them.
+     * @param provider The provider name
+     * @param estimatedTokens The tokens the request counts against a token limit
+     * @return Time waited in milliseconds
+     */
+    static double take(const std::string& provider, size_t estimatedTokens);
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <json/json.h>
+
+/**
+ * @brief Hit and miss counters of the response cache.
+ */
+struct ResponseCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+/**
+ * @brief Opt-in, content-addressed on-disk cache of chat completions.
+ *
+ * Scripted pipelines often send the same conversation to the same model
+ * many times. With RESPONSE_CACHE=true in the config, the assistant reply is
+ * stored under the SHA-256 of the provider's API URL and the canonical
+ * request payload, and an identical request is answered from disk without
+ * a network round trip.
+ *
+ * Layout (under ~/.cache/aith/responses):
+ * - <sha256>.entry: "aith-response 1<TAB><expires-at>" line, then the reply
+ * - stats: hit and miss counters, shared by all aith processes
+ *
+ * Settings (provider config, then main config):
+ * - RESPONSE_CACHE_TTL: lifetime of new entries in seconds (default 86400)
+ * - RESPONSE_CACHE_MAX_MB: size bound of all entries (default 64)
+ *
+ * The modification time of an entry is its last use; when a store pushes the
+ * cache over its size bound the least recently used entries are removed.
+ * The global --no-cache flag bypasses the cache for one run (no lookup, no
+ * store). Entries are written to a temporary file and renamed, so concurrent
+ * aith processes never read a partial entry.
+ */
+class ResponseCache {
+public:
+    static const long DEFAULT_TTL_SECONDS;
+    static const long DEFAULT_MAX_MB;
+
+    /**
+     * Checks if the cache is used for this run.
+     * @return True if RESPONSE_CACHE is enabled and --no-cache was not given
+     */
+    static bool isEnabled();
+
+    /**
+     * Disables the cache for this run (the --no-cache flag).
+     * @param bypass True to skip lookups and stores
+     */
+    static void setBypass(bool bypass);
+
+    /**
+     * Computes the cache key of a request.
+     * The "stream" member is left out, so streamed and buffered requests share entries.
+     * @param apiUrl The provider's API base URL
+     * @param payload The chat completion request payload
+     * @return Lowercase hex SHA-256 of the URL and the canonical payload
+     */
+    static std::string makeKey(const std::string& apiUrl, const Json::Value& payload);
+
+    /**
+     * Looks up a stored reply and counts a hit or a miss.
+     * A hit marks the entry as most recently used; expired entries are removed.
+     * @param key The cache key
+     * @param content Receives the stored reply on a hit
+     * @return True on a hit
+     */
+    static bool lookup(const std::string& key, std::string& content);
+
+    /**
+     * Stores a reply and evicts least recently used entries above the size bound.
+     * A reply that cannot be written is not cached; a warning is printed
+     * and the chat goes on.
+     * @param provider The provider name (selects TTL and size bound)
+     * @param key The cache key
+     * @param content The assistant reply
+     */
+    static void store(const std::string& provider, const std::string& key, const std::string& content);
+
+    /**
+     * Reads the hit and miss counters.
+     * @return The counters of all runs so far
+     */
+    static ResponseCacheStats getStats();
+
+    /**
+     * Gets the directory holding the cache entries.
+     * @return Path to the cache directory
+     */
+    static std::string getCacheDir();
+
+private:
+    static constexpr const char* ENTRY_MAGIC = "aith-response 1";
+    static constexpr const char* ENTRY_EXTENSION = ".entry";
+
+    /**
+     * Gets the flag set by --no-cache.
+     * @return Reference to the process-wide flag
+     */
+    static std::atomic<bool>& bypassFlag();
+
+    /**
+     * Adds to the shared counters under an exclusive file lock.
+     * @param hits Hits to add
+     * @param misses Misses to add
+     */
+    static void recordStats(uint64_t hits, uint64_t misses);
+
+    /**
+     * Parses the content of the counters file.
+     * @param content Lines of "hits N" and "misses N"
+     * @return The counters (0 for missing lines)
+     */
+    static ResponseCacheStats parseStats(const std::string& content);
+
+    /**
+     * Removes least recently used entries until the cache fits its bound.
+     * @param maxBytes The size bound in bytes
+     */
+    static void evict(uint64_t maxBytes);
+
+    /**
+     * Gets the path of an entry.
+     * @param key The cache key
+     * @return Path to the entry file
+     */
+    static std::string getEntryPath(const std::string& key);
+};
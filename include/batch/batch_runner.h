@@ -0,0 +1,157 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <unordered_set>
+#include <json/json.h>
+#include "http_retry.h"
+
+/**
+ * @brief Options for one batch run.
+ */
+struct BatchOptions {
+    std::string inputPath;          // JSONL input file, "-" for standard input
+    std::string outputPath;         // JSONL output file, empty for standard output
+    std::string resumePath;         // File of completed ids, empty to disable resuming
+    std::string model;              // Model for lines without one, empty for the provider default
+    size_t concurrency = 4;
+    int maxRetries = -1;            // Retries after the first attempt, -1 for the provider's RETRY_MAX_ATTEMPTS
+    bool completionOrder = false;   // Write results as they finish instead of in input order
+};
+
+/**
+ * @brief One line of the batch input.
+ */
+struct BatchJob {
+    size_t lineNumber = 0;
+    std::string id;
+    std::string model;
+    Json::Value payload;            // Chat request payload; null if the line is invalid
+    std::string error;              // Why the line is invalid
+};
+
+/**
+ * @brief Outcome of one batch job.
+ */
+struct BatchResult {
+    std::string id;
+    std::string model;
+    std::string content;
+    std::string error;              // Empty on success
+    int completionTokens = -1;      // -1 if the server did not report usage
+    size_t attempts = 0;
+    double latencyMs = 0.0;         // Of the final attempt
+
+    /**
+     * Checks if the job produced a reply.
+     * @return True if no error occurred
+     */
+    bool isSuccess() const { return error.empty(); }
+};
+
+/**
+ * @brief Totals of a batch run.
+ */
+struct BatchSummary {
+    size_t total = 0;               // Lines in the input
+    size_t skipped = 0;             // Already completed according to the resume file
+    size_t succeeded = 0;
+    size_t failed = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Runs many independent chat requests from a JSONL file in one process.
+ *
+ * Each input line is a JSON object:
+ *   {"id": "q1", "prompt": "text", "system": "optional", "model": "optional"}
+ *   {"id": "q2", "messages": [{"role": "user", "content": "text"}], "params": {"temperature": 0}}
+ * The id defaults to the line number; "params" members are copied into the
+ * request payload. History, the default prompt and the response cache are
+ * not used.
+ *
+ * Each output line is a JSON object with "id", "model", "content" or
+ * "error", "attempts", "latency_ms" and, if reported, "completion_tokens".
+ *
+ * Requests are sent by a fixed pool of worker threads over the shared
+ * HttpClient connection pool, so the configuration, the API key and the TLS
+ * connections are set up once for the whole batch. Transient failures
+ * (connection failures, 429, 502, 503) are retried by HttpClient with the
+ * provider's retry policy, honoring Retry-After (see HttpRetry). Every
+ * request first waits for the provider's shared rate limit (see RateLimiter).
+ *
+ * With a resume file, the id of every successful job is appended to it once
+ * its output line has been written; a later run with the same resume file
+ * skips those ids and appends to the output. Failed jobs are not recorded,
+ * so a resumed run retries them.
+ */
+class BatchRunner {
+public:
+    static const size_t DEFAULT_CONCURRENCY;
+    static const size_t MAX_CONCURRENCY;
+
+    /**
+     * Runs a batch.
+     * @param options The batch options
+     * @param apiKey The API key for authentication
+     * @return The totals of the run
+     * @throws std::runtime_error if the input, output or resume file cannot be opened
+     */
+    static BatchSummary run(const BatchOptions& options, const std::string& apiKey);
+
+    /**
+     * Reads all jobs from a JSONL input.
+     * Blank lines are ignored; malformed lines become invalid jobs.
+     * @param inputPath The input file, "-" for standard input
+     * @param defaultModel Model for lines without one
+     * @return The jobs in input order
+     * @throws std::runtime_error if the input cannot be opened
+     */
+    static std::vector<BatchJob> readJobs(const std::string& inputPath, const std::string& defaultModel);
+
+    /**
+     * Parses one input line into a job.
+     * @param line The JSON line
+     * @param lineNumber The 1-based line number, used as the default id
+     * @param defaultModel Model if the line has none
+     * @return The job (with error set if the line is invalid)
+     */
+    static BatchJob parseJob(const std::string& line, size_t lineNumber, const std::string& defaultModel);
+
+    /**
+     * Sends one job; HttpClient retries the transient failures.
+     * @param job The job to send (must be valid)
+     * @param provider The provider name, for its rate limit
+     * @param apiUrl The provider API URL
+     * @param apiKey The API key for authentication
+     * @param retry The retry policy
+     * @return The result
+     */
+    static BatchResult execute(const BatchJob& job, const std::string& provider, const std::string& apiUrl,
+                               const std::string& apiKey, const RetryPolicy& retry);
+
+    /**
+     * Formats a result as one output line (without the newline).
+     * @param result The result
+     * @return The JSON line
+     */
+    static std::string formatResult(const BatchResult& result);
+
+    /**
+     * Reads the ids recorded in a resume file.
+     * @param resumePath The resume file (may not exist yet)
+     * @return The completed ids
+     */
+    static std::unordered_set<std::string> readCompletedIds(const std::string& resumePath);
+
+    /**
+     * Rewrites the output of an interrupted run so that it keeps one line per
+     * completed id. Lines of failed jobs, and of jobs written but not yet
+     * recorded in the resume file, are dropped because this run sends them again.
+     * @param outputPath The output file (may not exist yet)
+     * @param completed The ids read from the resume file
+     * @throws std::runtime_error if the output cannot be rewritten
+     */
+    static void compactOutput(const std::string& outputPath, const std::unordered_set<std::string>& completed);
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <cstddef>
+#include <string>
+#include "batch_runner.h"
+
+/**
+ * @brief Writes batch results from concurrent workers as JSONL.
+ *
+ * In input order mode a result that finishes early is held back until all
+ * results before it have been written, so the output is still streamed but
+ * matches the input order. In completion order mode every result is written
+ * as soon as it arrives.
+ *
+ * Each line is flushed before the id of a successful result is appended to
+ * the resume log, so an interruption never loses a line. A line whose id did
+ * not reach the log is removed on resume by BatchRunner::compactOutput.
+ *
+ * All methods are thread-safe.
+ */
+class BatchWriter {
+public:
+    /**
+     * Creates a writer.
+     * @param output Stream receiving the JSONL results
+     * @param resumeLog Stream receiving completed ids, or nullptr
+     * @param completionOrder True to write results as they arrive
+     */
+    BatchWriter(std::ostream& output, std::ostream* resumeLog, bool completionOrder);
+
+    /**
+     * Writes a result, or holds it back until the results before it are written.
+     * @param sequence Position of the job among the jobs of this run (0-based)
+     * @param result The result
+     */
+    void write(size_t sequence, const BatchResult& result);
+
+    /**
+     * Gets the number of results written so far.
+     * @return Written results, including failed ones
+     */
+    size_t getWritten() const;
+
+    /**
+     * Gets the number of failed results written so far.
+     * @return Written results with an error
+     */
+    size_t getFailed() const;
+
+private:
+    /**
+     * Writes one result and records it in the resume log. Caller holds the mutex.
+     */
+    void writeLine(const BatchResult& result);
+
+    std::ostream& output_;
+    std::ostream* resumeLog_;
+    bool completionOrder_;
+
+    mutable std::mutex mutex_;
+    size_t nextSequence_;                       // Next result to write in input order
+    std::map<size_t, BatchResult> pending_;     // Finished results waiting for earlier ones
+    size_t written_;
+    size_t failed_;
+};
@@ -5,12 +5,17 @@
 #include <vector>
 #include <chrono>
 #include "benchmark_config.h"
+#include "benchmark_statistics.h"
+#include "http_timings.h"
 #include "performance_timer.h"
 #include "benchmark_reporter.h"
 #include "benchmark_runner.h"
 
 /**
  * Structure to store benchmark result for a single model
+ * With several iterations, responseTimeMs is the median (p50) of the
+ * successful requests and success means at least one request succeeded.
+ * The streaming metrics are medians over the successful requests as well.
  */
 struct BenchmarkResult {
     std::string provider;
@@ -19,6 +24,19 @@ struct BenchmarkResult {
     bool success;
     std::string errorMessage;
     std::string timestamp;
+    size_t iterations = 0;              // Timed requests made
+    size_t successfulIterations = 0;    // Timed requests that succeeded
+    double successRate = 0.0;           // successfulIterations / iterations
+    LatencyStatistics latency;          // Statistics over the successful requests
+    bool streamed = false;              // Measured with a streamed response
+    double connectTimeMs = 0.0;         // Connection setup (DNS + TCP + TLS; 0 when reused)
+    double timeToFirstTokenMs = 0.0;    // Until the first content token arrived
+    int outputTokens = 0;               // Generated tokens
+    bool outputTokensEstimated = false; // Token count estimated from the text (no usage block)
+    double tokensPerSecond = 0.0;       // Generation speed after the first token
+    HttpTimings timings;                // Per-phase HTTP timings (medians over successful requests)
+    int retries = 0;                    // Requests repeated by the retry policy, over all timed requests
+    double backoffMs = 0.0;             // Time waited before those retries (not part of the latencies)
 };
 
 /**
@@ -26,19 +44,19 @@ struct BenchmarkResult {
  * @param provider The provider name
  * @param model The model name
  * @param apiKey The API key for authentication
- * @param testPrompt The prompt to use for testing
+ * @param options Prompt, iterations and warm-up requests for the test
  * @return BenchmarkResult with timing and success information
  */
 BenchmarkResult runModelBenchmark(const std::string &provider, const std::string &model, 
-                                  const std::string &apiKey, const std::string &testPrompt = "");
+                                  const std::string &apiKey, const BenchmarkOptions &options);
 
 /**
  * Runs benchmark tests on all available models for the current provider
  * @param apiKey The API key for authentication
- * @param testPrompt The prompt to use for testing
+ * @param options Prompt, concurrency, iterations and warm-up for the run
  * @return Vector of BenchmarkResult sorted by response time
  */
-std::vector<BenchmarkResult> runAllModelsBenchmark(const std::string &apiKey, const std::string &testPrompt = "");
+std::vector<BenchmarkResult> runAllModelsBenchmark(const std::string &apiKey, const BenchmarkOptions &options);
 
 /**
  * Displays benchmark results in a formatted table
@@ -2,6 +2,32 @@
 #define BENCHMARK_CONFIG_H
 
 #include <string>
+#include <cstddef>
+#include "model_catalog.h"
+
+/**
+ * Metric used to rank benchmark results
+ */
+enum class BenchmarkSortKey {
+    TotalTime,          // Median total response time (default)
+    TimeToFirstToken,   // Median time to the first streamed token
+    ConnectTime,        // Median connection setup time
+    TokensPerSecond     // Median output tokens per second (highest first)
+};
+
+/**
+ * Options for a benchmark run, as given on the command line
+ */
+struct BenchmarkOptions {
+    std::string testPrompt;     // Prompt sent to every model (empty = use default)
+    size_t concurrency = 1;     // Number of models tested in parallel
+    size_t iterations = 1;      // Timed requests per model
+    size_t warmup = 0;          // Untimed requests per model before the timed ones
+    bool stream = false;        // Stream responses to measure connect time, TTFT and tokens/s
+    BenchmarkSortKey sortBy = BenchmarkSortKey::TotalTime;
+    bool refreshModels = false; // Download the model list instead of using the cached catalog
+    ModelFilter modelFilter;    // Only benchmark models matching this owner / id prefix
+};
 
 /**
  * Configuration management for benchmark operations
@@ -14,6 +40,8 @@ public:
     static const int DEFAULT_MAX_TOKENS;
     static const std::string TEMP_FILE_PREFIX;
     static const std::string TEMP_HISTORY_PREFIX;
+    static const size_t DEFAULT_CONCURRENCY;
+    static const size_t MAX_CONCURRENCY;
     
     /**
      * Get the default test prompt for benchmarks
@@ -27,6 +55,51 @@ public:
      */
     static int getMaxTokens();
     
+    /**
+     * Get the concurrency cap for a provider
+     * Read from BENCHMARK_CONCURRENCY in the provider config, falling back to
+     * the main config. Never exceeds MAX_CONCURRENCY.
+     * @param provider The provider name
+     * @return Maximum number of parallel requests for the provider
+     */
+    static size_t getConcurrencyLimit(const std::string& provider);
+    
+    /**
+     * Resolve the number of worker threads for a benchmark run
+     * @param requested Concurrency requested on the command line
+     * @param provider The provider name (for the per-provider cap)
+     * @param modelCount Number of models to test
+     * @return Number of workers, at least 1 and at most modelCount
+     */
+    static size_t resolveConcurrency(size_t requested, const std::string& provider, size_t modelCount);
+    
+    /**
+     * Parse a sort metric name
+     * @param name One of "total", "ttft", "connect" or "tps"
+     * @return The sort key
+     * @throws std::invalid_argument for unknown names
+     */
+    static BenchmarkSortKey parseSortKey(const std::string& name);
+    
+    /**
+     * Check if a sort metric is only measured in streaming mode
+     * @param key The sort key
+     * @return True for time to first token, connect time and tokens/s
+     */
+    static bool requiresStreaming(BenchmarkSortKey key);
+    
+    /**
+     * Estimate the number of tokens in a text
+     * Used when the server does not report token usage. Counts with the
+     * model's local BPE vocabulary if one is installed (see TokenCounter),
+     * otherwise assumes about one token per 4 characters.
+     * @param text The generated text
+     * @param provider The provider name
+     * @param model The model that generated the text
+     * @return Estimated token count
+     */
+    static int estimateTokenCount(const std::string& text, const std::string& provider, const std::string& model);
+    
     /**
      * Get the temporary file prefix for benchmark payloads
      * @return Temporary file prefix
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+#include <atomic>
 
 // Forward declaration to avoid circular dependency
 struct BenchmarkResult;
@@ -17,6 +19,10 @@ struct BenchmarkResult;
  *   BenchmarkReporter::displayTestStart("model-name");
  *   BenchmarkReporter::displayTestResult(result);
  *   BenchmarkReporter::displayResults(results);
+ *
+ * Progress output is serialized by an output mutex. In concurrent mode the
+ * start of a test prints nothing and each result is printed as one complete
+ * "Testing <model>... ✓ (...)" line, so lines from parallel tests never mix.
  */
 class BenchmarkReporter {
 public:
@@ -33,6 +39,19 @@ public:
      */
     static void displayTestResult(const BenchmarkResult& result);
 
+    /**
+     * Switch progress output between sequential and concurrent layout
+     * @param enabled True while tests run in parallel
+     */
+    static void setConcurrentMode(bool enabled);
+
+    /**
+     * Get the mutex that serializes progress output
+     * Hold it to print other messages between progress lines.
+     * @return The output mutex
+     */
+    static std::mutex& getOutputMutex();
+
     // Batch operation reporting
     /**
      * Display header information for a benchmark run
@@ -55,6 +74,19 @@ public:
      */
     static void displayNoModelsError(const std::string& provider);
 
+    /**
+     * Display how many requests are sent to each model
+     * @param iterations Timed requests per model
+     * @param warmup Untimed warm-up requests per model
+     */
+    static void displayIterations(size_t iterations, size_t warmup);
+
+    /**
+     * Display the number of parallel workers
+     * @param workerCount Number of models tested at the same time
+     */
+    static void displayConcurrency(size_t workerCount);
+
     // Complete results display
     /**
      * Display complete benchmark results with summary
@@ -63,6 +95,24 @@ public:
     static void displayResults(const std::vector<BenchmarkResult>& results);
 
 private:
+    /**
+     * Check if progress output uses the concurrent layout
+     * @return True while tests run in parallel
+     */
+    static bool isConcurrentMode();
+
+    /**
+     * Get the storage of the concurrent mode flag
+     */
+    static std::atomic<bool>& getConcurrentModeFlag();
+
+    /**
+     * Format the outcome of a single test ("✓ (...)" or "✗ (...)")
+     * @param result The benchmark result
+     * @return Formatted outcome without trailing newline
+     */
+    static std::string formatTestOutcome(const BenchmarkResult& result);
+
     // Internal formatting methods
     /**
      * Display successful test results
@@ -70,6 +120,26 @@ private:
      */
     static void displaySuccessfulResults(const std::vector<BenchmarkResult>& successful);
 
+    /**
+     * Display successful results as a table of latency statistics
+     * Used when models were tested with more than one iteration.
+     * @param successful Vector of successful results
+     */
+    static void displayStatisticsTable(const std::vector<BenchmarkResult>& successful);
+
+    /**
+     * Display successful streamed results with connect time, TTFT and tokens/s
+     * @param successful Vector of successful results
+     */
+    static void displayStreamingTable(const std::vector<BenchmarkResult>& successful);
+
+    /**
+     * Display the per-phase HTTP timings of successful results
+     * Shown when the global --timings flag is set.
+     * @param successful Vector of successful results
+     */
+    static void displayTimingsTable(const std::vector<BenchmarkResult>& successful);
+
     /**
      * Display failed test results
      * @param failed Vector of failed results
@@ -90,6 +160,28 @@ private:
      */
     static std::string formatResponseTime(double timeMs);
 
+    /**
+     * Format a token throughput
+     * @param tokensPerSecond Tokens per second
+     * @return Formatted throughput string
+     */
+    static std::string formatThroughput(double tokensPerSecond);
+
+    /**
+     * Format a success rate as a percentage
+     * @param rate Success rate in the range [0, 1]
+     * @return Formatted percentage string
+     */
+    static std::string formatSuccessRate(double rate);
+
+    /**
+     * Format the retries made for a model or a whole run
+     * @param retries Requests repeated by the retry policy
+     * @param backoffMs Time waited before the retries
+     * @return E.g. "2 retries, 1250.00ms backoff"
+     */
+    static std::string formatRetries(int retries, double backoffMs);
+
     /**
      * Format a model entry for results display
      * @param result The benchmark result
@@ -98,6 +190,15 @@ private:
      */
     static std::string formatModelEntry(const BenchmarkResult& result, size_t index = 0);
 
+    /**
+     * Build the "model (provider)" labels of a results table
+     * @param results The results, one table row each
+     * @param labelWidth Receives the model column width (the longest label, at least "Model")
+     * @return One label per result
+     */
+    static std::vector<std::string> formatModelLabels(const std::vector<BenchmarkResult>& results,
+                                                      size_t& labelWidth);
+
     /**
      * Print a visual separator line
      */
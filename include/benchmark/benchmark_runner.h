@@ -3,9 +3,13 @@
 #include <string>
 #include <vector>
 #include <json/json.h>
+#include "http_timings.h"
+#include "model_catalog.h"
 
 // Forward declarations to avoid circular dependencies
 struct BenchmarkResult;
+struct BenchmarkOptions;
+enum class BenchmarkSortKey;
 struct ModelInfo;
 
 /**
@@ -17,40 +21,51 @@ struct ModelInfo;
  * 
  * Usage:
  *   BenchmarkResult result = BenchmarkRunner::runSingleModel(provider, model, apiKey);
- *   std::vector<BenchmarkResult> results = BenchmarkRunner::runAllModels(apiKey);
+ *   std::vector<BenchmarkResult> results = BenchmarkRunner::runAllModels(apiKey, options);
+ *
+ * runAllModels() tests up to options.concurrency models at a time (capped per
+ * provider by BENCHMARK_CONCURRENCY). Workers take the next untested model from
+ * a shared counter and store each result at the model's position, so the
+ * results are in a deterministic order before they are sorted.
  */
 class BenchmarkRunner {
 public:
     // Core execution methods
     /**
      * Execute a benchmark test on a single model
+     * Sends options.warmup untimed requests followed by options.iterations
+     * timed ones and summarizes the timed requests.
      * @param provider The provider name
      * @param model The model name
      * @param apiKey The API key for authentication
-     * @param testPrompt The prompt to use for testing (empty = use default)
-     * @return BenchmarkResult with timing and success information
+     * @param options Test prompt (empty = use default), iterations and warm-up
+     * @return BenchmarkResult with timing statistics and success information
      */
     static BenchmarkResult runSingleModel(const std::string& provider, 
                                          const std::string& model, 
                                          const std::string& apiKey,
-                                         const std::string& testPrompt = "");
+                                         const BenchmarkOptions& options);
 
     /**
      * Execute benchmark tests on all available models for the current provider
      * @param apiKey The API key for authentication
-     * @param testPrompt The prompt to use for testing (empty = use default)
+     * @param options Test prompt (empty = use default), concurrency, iterations and warm-up
      * @return Vector of benchmark results for all tested models
      */
     static std::vector<BenchmarkResult> runAllModels(const std::string& apiKey,
-                                                    const std::string& testPrompt = "");
+                                                    const BenchmarkOptions& options);
 
     // Model discovery
     /**
      * Get all available models for the current provider
+     * Read from the on-disk model catalog while it is fresh.
      * @param apiKey The API key for authentication
+     * @param refresh True to ignore the cached catalog and download the list
+     * @param filter Only return models matching this owner / id prefix
      * @return Vector of available model names
      */
-    static std::vector<std::string> getAvailableModels(const std::string& apiKey);
+    static std::vector<std::string> getAvailableModels(const std::string& apiKey, bool refresh = false,
+                                                       const ModelFilter& filter = ModelFilter());
 
 private:
     // Helper orchestration methods
@@ -66,11 +81,35 @@ private:
         const std::string& provider,
         size_t& blacklistedCount);
 
+    /**
+     * Test models on a pool of worker threads
+     * @param provider The provider name
+     * @param models Models to test
+     * @param apiKey The API key
+     * @param options The benchmark options
+     * @param workerCount Number of worker threads (at least 2)
+     * @return One result per model, in the order of models
+     */
+    static std::vector<BenchmarkResult> runModelsConcurrently(const std::string& provider,
+                                                             const std::vector<std::string>& models,
+                                                             const std::string& apiKey,
+                                                             const BenchmarkOptions& options,
+                                                             size_t workerCount);
+
     /**
      * Sort benchmark results according to configuration settings
      * @param results Vector of results to sort in-place
+     * @param sortBy Metric to rank successful results by
+     */
+    static void sortResults(std::vector<BenchmarkResult>& results, BenchmarkSortKey sortBy);
+
+    /**
+     * Get the value of a sort metric for a result
+     * @param result The benchmark result
+     * @param sortBy The sort metric
+     * @return The metric value; smaller is better for every metric
      */
-    static void sortResults(std::vector<BenchmarkResult>& results);
+    static double getSortValue(const BenchmarkResult& result, BenchmarkSortKey sortBy);
 
     /**
      * Create a benchmark result with error information
@@ -84,13 +123,31 @@ private:
                                             const std::string& errorMessage);
 
     /**
-     * Execute the core API request workflow for a single model
+     * Combine the timed requests of a model into one result
+     * @param provider The provider name
+     * @param model The model name
+     * @param trials Results of the individual timed requests
+     * @return BenchmarkResult with latency statistics and success rate
+     */
+    static BenchmarkResult summarizeTrials(const std::string& provider,
+                                          const std::string& model,
+                                          const std::vector<BenchmarkResult>& trials);
+
+    /**
+     * Combine the timing breakdowns of several requests
+     * @param samples Timing breakdowns of the successful requests
+     * @return Median of each phase; byte counts and reuse of the last request
+     */
+    static HttpTimings summarizeTimings(const std::vector<HttpTimings>& samples);
+
+    /**
+     * Execute a single timed API request for a model
      * @param provider The provider name
      * @param model The model name
      * @param apiKey The API key
      * @param testPrompt The test prompt
      * @param apiUrl The API URL
-     * @return BenchmarkResult with execution details
+     * @return BenchmarkResult of this one request (no progress output)
      */
     static BenchmarkResult executeModelRequest(const std::string& provider,
                                               const std::string& model,
@@ -98,6 +155,22 @@ private:
                                               const std::string& testPrompt,
                                               const std::string& apiUrl);
 
+    /**
+     * Execute a single timed API request with a streamed response
+     * Records connect time, time to first token, total time and output tokens.
+     * @param provider The provider name
+     * @param model The model name
+     * @param apiKey The API key
+     * @param testPrompt The test prompt
+     * @param apiUrl The API URL
+     * @return BenchmarkResult of this one request (no progress output)
+     */
+    static BenchmarkResult executeStreamingRequest(const std::string& provider,
+                                                  const std::string& model,
+                                                  const std::string& apiKey,
+                                                  const std::string& testPrompt,
+                                                  const std::string& apiUrl);
+
     /**
      * Extract model IDs from ModelsListResponse for benchmarking
      * @param response The models list response from API
@@ -111,11 +184,4 @@ private:
      * @return JSON messages array for chat completion
      */
     static Json::Value buildBenchmarkMessages(const std::string& testPrompt);
-
-    /**
-     * Determine if a model should be blacklisted based on error message
-     * @param errorMessage The error message from API response
-     * @return True if the model should be blacklisted
-     */
-    static bool shouldBlacklistModel(const std::string& errorMessage);
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Summary statistics over the latency samples of one model
+ * All times are in milliseconds; every field is 0 when there are no samples.
+ */
+struct LatencyStatistics {
+    size_t samples = 0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double stddevMs = 0.0;
+};
+
+/**
+ * Computes latency statistics for repeated benchmark trials
+ *
+ * Percentiles are interpolated linearly between the two closest ranks, so
+ * they stay meaningful for the small sample counts a benchmark produces.
+ * The standard deviation is the sample (n - 1) standard deviation.
+ *
+ * Usage:
+ *   LatencyStatistics stats = BenchmarkStatistics::summarize(samplesMs);
+ */
+class BenchmarkStatistics {
+public:
+    /**
+     * Summarize a set of latency samples
+     * @param samplesMs Latencies in milliseconds (taken by value and sorted)
+     * @return Statistics over the samples
+     */
+    static LatencyStatistics summarize(std::vector<double> samplesMs);
+
+    /**
+     * Get a percentile from sorted samples
+     * @param sortedSamples Samples in ascending order (must not be empty)
+     * @param percentile Percentile in the range [0, 100]
+     * @return The interpolated percentile value
+     */
+    static double percentile(const std::vector<double>& sortedSamples, double percentile);
+};
@@ -6,7 +6,9 @@
  * High-precision performance timer for measuring operation durations
  * 
  * This class provides a clean interface for timing operations, hiding the
- * complexity of std::chrono and providing millisecond precision timing.
+ * complexity of std::chrono. It uses the monotonic steady clock, so results
+ * are not affected by system clock adjustments, and reports milliseconds as
+ * a fractional value with the clock's full (nanosecond) resolution.
  * 
  * Usage:
  *   PerformanceTimer timer;
@@ -53,7 +55,7 @@ public:
     bool isRunning() const;
 
 private:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = std::chrono::steady_clock;
     using TimePoint = std::chrono::time_point<Clock>;
 
     TimePoint m_startTime;
@@ -61,7 +63,7 @@ private:
     bool m_isRunning;
 
     /**
-     * Calculate duration between two time points in milliseconds
+     * Calculate duration between two time points in fractional milliseconds
      */
     double calculateDurationMs(const TimePoint& start, const TimePoint& end) const;
 };
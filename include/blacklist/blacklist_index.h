@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <unordered_set>
+#include <ctime>
+#include <sys/types.h>
+
+/**
+ * @brief Process-wide hash index of blacklisted (provider, model) pairs.
+ *
+ * Checking a model against the blacklist used to read and parse the whole
+ * blacklist file on every call. The index parses the file once per process
+ * and answers lookups from an unordered_set. Before each lookup the file is
+ * stat()ed; the index is reloaded only when its modification time or size
+ * has changed (e.g. edited by hand or by another aith process).
+ *
+ * Add and Remove operations update the index in place after writing the
+ * file, so the next lookup does not have to reload it.
+ *
+ * All methods are thread-safe.
+ */
+class BlacklistIndex {
+public:
+    /**
+     * @brief Checks if a model is blacklisted for a provider.
+     * @param provider The provider name
+     * @param model The model name
+     * @return True if the pair is in the blacklist file
+     */
+    static bool contains(const std::string& provider, const std::string& model);
+
+    /**
+     * @brief Reloads the index if the blacklist file changed since it was loaded.
+     * Call right before modifying the file so that update() starts from the
+     * current content.
+     */
+    static void synchronize();
+
+    /**
+     * @brief Records a change made to the blacklist file by this process.
+     * Must be called right after the file was written (following a
+     * synchronize() or contains() before the write); the index then adopts
+     * the new file signature instead of reloading.
+     * @param provider The provider name
+     * @param model The model name
+     * @param blacklisted True if the pair was added, false if it was removed
+     */
+    static void update(const std::string& provider, const std::string& model, bool blacklisted);
+
+    /**
+     * @brief Drops the index so that the next lookup reloads the file.
+     */
+    static void invalidate();
+
+private:
+    /**
+     * @brief Identifies a version of the blacklist file.
+     */
+    struct FileSignature {
+        bool exists = false;
+        off_t size = 0;
+        time_t mtimeSec = 0;
+        long mtimeNsec = 0;
+
+        bool operator==(const FileSignature& other) const {
+            return exists == other.exists && size == other.size &&
+                   mtimeSec == other.mtimeSec && mtimeNsec == other.mtimeNsec;
+        }
+        bool operator!=(const FileSignature& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Shared index state, guarded by its mutex.
+     */
+    struct State {
+        std::mutex mutex;
+        std::unordered_set<std::string> entries;
+        FileSignature signature;
+        std::string path;
+        bool loaded = false;
+    };
+
+    static State& getState();
+
+    /**
+     * @brief Reloads the index if the file changed since it was loaded.
+     * @param state The index state (mutex must be held)
+     */
+    static void refreshIfChanged(State& state);
+
+    /**
+     * @brief Reads the current signature of a file.
+     * @param path Path to the file
+     * @return The file signature (exists == false if the file is missing)
+     */
+    static FileSignature readSignature(const std::string& path);
+
+    /**
+     * @brief Builds the lookup key for a (provider, model) pair.
+     */
+    static std::string makeKey(const std::string& provider, const std::string& model);
+};
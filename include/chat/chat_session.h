@@ -0,0 +1,80 @@
+#ifndef CHAT_SESSION_H
+#define CHAT_SESSION_H
+
+#include <string>
+#include <json/json.h>
+
+/**
+ * @brief In-memory conversation for one chat turn or an interactive session.
+ *
+ * The session reads the history file once, keeps the conversation inside the
+ * request payload it sends, and writes only the messages added during the
+ * turn, in one append, when persist() is called.
+ *
+ * The payload's "messages" array is the conversation itself: the system
+ * prompt (if any) is placed first, loaded messages are moved in behind it and
+ * new messages are appended by move. Building the request only updates the
+ * model and stream fields, so the message array is never copied.
+ *
+ * Usage:
+ *   ChatSession session(historyPath, systemPrompt);
+ *   session.addMessage("user", prompt);
+ *   HttpClient::post(url, apiKey, session.buildRequestPayload(model, false));
+ *   session.addMessage("assistant", reply);
+ *   session.persist();
+ */
+class ChatSession {
+public:
+    /**
+     * Loads a conversation from its history file.
+     * A missing or unreadable file starts an empty conversation.
+     * @param historyPath Path to the history file
+     * @param systemPrompt System prompt to send first (empty string to skip); never persisted
+     */
+    ChatSession(const std::string& historyPath, const std::string& systemPrompt);
+
+    /**
+     * Appends a message to the conversation.
+     * @param role The role of the message (e.g., "user", "assistant")
+     * @param content The message content
+     */
+    void addMessage(const std::string& role, const std::string& content);
+
+    /**
+     * Updates and returns the chat completion request payload.
+     * @param model The model to use
+     * @param stream Whether to request a streamed response
+     * @return Reference to the payload, valid until the session changes
+     */
+    const Json::Value& buildRequestPayload(const std::string& model, bool stream);
+
+    /**
+     * Writes the messages added since the last persist to the history file.
+     * @throws std::runtime_error if the history file cannot be written
+     */
+    void persist();
+
+    /**
+     * Drops the messages added since the last persist, e.g. a prompt that got no answer.
+     */
+    void discardUnsaved();
+
+    /**
+     * Gets the conversation messages, including the system prompt if set.
+     * @return Reference to the message array
+     */
+    const Json::Value& getMessages() const;
+
+    /**
+     * Gets the path of the history file backing this session.
+     * @return The history file path
+     */
+    const std::string& getHistoryPath() const;
+
+private:
+    std::string historyPath_;
+    Json::Value payload_;                 // Request payload; "messages" holds the conversation
+    Json::ArrayIndex persistedCount_;     // Messages (incl. system prompt) already on disk or never stored
+};
+
+#endif // CHAT_SESSION_H
@@ -0,0 +1,138 @@
+#ifndef CONTEXT_WINDOW_H
+#define CONTEXT_WINDOW_H
+
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <json/json.h>
+#include "bpe_tokenizer.h"
+
+/**
+ * @brief Fits the outgoing conversation into a per-provider/model token budget.
+ *
+ * Without a budget every turn sends the whole conversation, so the payload,
+ * the prompt processing time and the cost grow with every message until the
+ * model's context limit is hit. With a budget the request payload is trimmed;
+ * the history file itself is never changed.
+ *
+ * The trimmed conversation is built as:
+ *   leading system messages (the system prompt) - always kept
+ *   rolling summary of the older messages       - "summarize" policy only
+ *   the last CONTEXT_KEEP_TURNS turns           - kept verbatim
+ * If that still exceeds the budget, the oldest kept messages are dropped too,
+ * but never the latest one.
+ *
+ * The rolling summary is stored next to the history file ("<history>.summary")
+ * together with the number of messages it covers. It is reused as long as the
+ * summary plus the messages after it fit the budget; only then is it extended
+ * with the messages that fell out of the kept turns, so most turns cost no
+ * extra request.
+ *
+ * Settings (provider config, then main config; the provider config may also
+ * use KEY@model, e.g. CONTEXT_TOKEN_BUDGET@llama-3.1-8b-instant=6000):
+ * - CONTEXT_TOKEN_BUDGET: estimated prompt tokens per request (0 = unlimited, default)
+ * - CONTEXT_KEEP_TURNS: user turns always sent verbatim (default 4)
+ * - CONTEXT_POLICY: "summarize" (default) or "drop"
+ *
+ * Tokens are counted with the model's local BPE vocabulary (see TokenCounter),
+ * or estimated from the text length if none is installed.
+ */
+class ContextWindow {
+public:
+    static const size_t DEFAULT_KEEP_TURNS;
+
+    /**
+     * @brief Trimming settings for one provider and model.
+     */
+    struct Policy {
+        size_t tokenBudget = 0;     // 0 disables trimming
+        size_t keepTurns = DEFAULT_KEEP_TURNS;
+        bool summarize = true;      // false drops the older messages instead
+        std::shared_ptr<const BpeTokenizer> tokenizer;  // nullptr estimates from length
+
+        /**
+         * Checks if the outgoing conversation is trimmed at all.
+         * @return True if a token budget is set
+         */
+        bool isEnabled() const { return tokenBudget > 0; }
+    };
+
+    /**
+     * Produces a summary from a summarization prompt (e.g. by asking the model).
+     * Throws on failure; trimming then falls back to dropping messages.
+     */
+    using Summarizer = std::function<std::string(const Json::Value& messages)>;
+
+    /**
+     * Loads the trimming settings for a provider and model.
+     * @param provider The provider name
+     * @param model The model name
+     * @return The policy (disabled unless CONTEXT_TOKEN_BUDGET is set)
+     */
+    static Policy loadPolicy(const std::string& provider, const std::string& model);
+
+    /**
+     * Builds a payload whose conversation fits the budget.
+     * @param payload The full request payload (its "messages" are the whole conversation)
+     * @param policy The trimming settings
+     * @param historyPath Path of the history file; the summary is stored next to it
+     * @param summarize Summarizer used by the "summarize" policy
+     * @param trimmed Receives the trimmed payload if trimming was needed
+     * @return True if the payload was trimmed, false if it already fits
+     */
+    static bool fit(const Json::Value& payload, const Policy& policy, const std::string& historyPath,
+                    const Summarizer& summarize, Json::Value& trimmed);
+
+    /**
+     * Gets the path of the rolling summary of a history file.
+     * @param historyPath Path of the history file
+     * @return Path of the summary file
+     */
+    static std::string getSummaryPath(const std::string& historyPath);
+
+private:
+    /**
+     * @brief Rolling summary of the first messages of a conversation.
+     */
+    struct Summary {
+        Json::ArrayIndex covered = 0;   // Conversation messages (after the system prompt) summarized
+        std::string text;
+    };
+
+    /**
+     * Reads the rolling summary of a history file.
+     * @return A summary with covered == 0 if there is none
+     */
+    static Summary readSummary(const std::string& path);
+
+    /**
+     * Writes the rolling summary of a history file.
+     * Failures only print a warning.
+     */
+    static void writeSummary(const std::string& path, const Summary& summary);
+
+    /**
+     * Asks the summarizer to extend a summary with further messages.
+     * @param previous The summary so far (empty if none)
+     * @param messages The conversation messages
+     * @param begin First message to add
+     * @param end One past the last message to add
+     * @param summarize The summarizer
+     * @return The new summary text
+     */
+    static std::string extendSummary(const std::string& previous, const Json::Value& messages,
+                                     Json::ArrayIndex begin, Json::ArrayIndex end,
+                                     const Summarizer& summarize);
+
+    /**
+     * Finds where the last turns to keep verbatim start.
+     * @param messages The conversation messages
+     * @param first Index of the first conversation message (after the system prompt)
+     * @param keepTurns Number of user turns to keep
+     * @return Index of the first kept message
+     */
+    static Json::ArrayIndex findTailStart(const Json::Value& messages, Json::ArrayIndex first, size_t keepTurns);
+};
+
+#endif // CONTEXT_WINDOW_H
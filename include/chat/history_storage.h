@@ -0,0 +1,142 @@
+#ifndef HISTORY_STORAGE_H
+#define HISTORY_STORAGE_H
+
+#include <string>
+#include <json/json.h>
+
+/**
+ * @brief Append-only, line-delimited storage for conversation histories.
+ *
+ * Each message is stored as one compact JSON object per line (JSON Lines),
+ * so adding a message appends a single line instead of parsing and
+ * rewriting the whole conversation. Appends go through O_APPEND in a single
+ * write() call and are optionally followed by fdatasync() when HISTORY_FSYNC
+ * is enabled in the config.
+ *
+ * Files written by older versions (one pretty-printed JSON array, ".json")
+ * are still read transparently; read() detects the format from the first
+ * non-whitespace character. migrate() converts such a file to the new format.
+ */
+class HistoryStorage {
+public:
+    // File extensions of the current and the legacy history format
+    static const std::string EXTENSION;
+    static const std::string LEGACY_EXTENSION;
+
+    /**
+     * Reads all messages of a history file in either format.
+     * Lines that cannot be parsed (e.g. from an interrupted write) are skipped.
+     * @param path Path to the history file
+     * @return Json::Value array of messages
+     * @throws std::runtime_error if the file cannot be read or a legacy file cannot be parsed
+     */
+    static Json::Value read(const std::string& path);
+
+    /**
+     * Reads all messages of a history file and appends them to an existing array.
+     * Messages are moved into the array, so no intermediate copy is made.
+     * @param path Path to the history file
+     * @param messages Json::Value array to append the messages to
+     * @throws std::runtime_error if the file cannot be read or a legacy file cannot be parsed
+     */
+    static void readInto(const std::string& path, Json::Value& messages);
+
+    /**
+     * Finds the first message with the given role without loading the whole file.
+     * @param path Path to the history file
+     * @param role The role to look for (e.g., "user")
+     * @return The content of the first matching message, or empty string if none
+     */
+    static std::string findFirstMessage(const std::string& path, const std::string& role);
+
+    /**
+     * Appends a single message to a history file, creating it if needed.
+     * @param path Path to the history file
+     * @param message The message object to append
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void append(const std::string& path, const Json::Value& message);
+
+    /**
+     * Appends several messages to a history file in one write.
+     * @param path Path to the history file
+     * @param messages Json::Value array of messages
+     * @param first Index of the first message in the array to append
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void appendAll(const std::string& path, const Json::Value& messages,
+                          Json::ArrayIndex first = 0);
+
+    /**
+     * Writes a complete history file, replacing any existing content.
+     * @param path Path to the history file
+     * @param messages Json::Value array of messages
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void write(const std::string& path, const Json::Value& messages);
+
+    /**
+     * Converts a legacy JSON array history file to the line-delimited format.
+     * The legacy file is removed once the new file has been written; its
+     * rolling summary is moved to the new file.
+     * @param legacyPath Path to the legacy ".json" file
+     * @param targetPath Path of the ".jsonl" file to create
+     * @throws std::runtime_error if the legacy file cannot be read or the target written
+     */
+    static void migrate(const std::string& legacyPath, const std::string& targetPath);
+
+    /**
+     * Moves a history file together with its rolling summary, so an archived
+     * conversation keeps its summary and a new one under the old name does
+     * not inherit it.
+     * @param oldPath Current path of the history file
+     * @param newPath New path of the history file
+     * @return True if the history file was moved
+     */
+    static bool rename(const std::string& oldPath, const std::string& newPath);
+
+    /**
+     * Checks if a filename has a history file extension (current or legacy).
+     * @param filename The filename to check
+     * @return True for ".jsonl" and ".json" files
+     */
+    static bool isHistoryFile(const std::string& filename);
+
+    /**
+     * Removes the history file extension (current or legacy) from a filename.
+     * @param filename The filename to strip
+     * @return The filename without extension
+     */
+    static std::string stripExtension(const std::string& filename);
+
+private:
+    /**
+     * Serializes messages into newline-terminated compact JSON lines.
+     * @param messages Json::Value array of messages
+     * @param first Index of the first message to serialize
+     * @return The serialized lines
+     */
+    static std::string serializeLines(const Json::Value& messages, Json::ArrayIndex first = 0);
+
+    /**
+     * Appends raw data to a file with a single O_APPEND write.
+     * @param path Path to the file
+     * @param data The data to append
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void appendRaw(const std::string& path, const std::string& data);
+
+    /**
+     * Checks if file content uses the legacy JSON array format.
+     * @param content The file content
+     * @return True if the first non-whitespace character is '['
+     */
+    static bool isLegacyFormat(const std::string& content);
+
+    /**
+     * Checks if a string ends with the given suffix.
+     */
+    static bool endsWith(const std::string& text, const std::string& suffix);
+};
+
+#endif // HISTORY_STORAGE_H
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "command.h"
+#include "core/application_setup.h"
+#include "batch/batch_runner.h"
+
+/**
+ * @brief Command to run the prompts of a JSONL file concurrently.
+ *
+ * Usage:
+ *   ./aith batch <input.jsonl|-> [-o output.jsonl] [--concurrency N]
+ *                [--order input|completion] [--resume FILE] [--retries N] [--model NAME]
+ *
+ * The whole batch runs in one process: the configuration and API key are
+ * loaded once and the requests share pooled connections. Results are written
+ * as JSONL to the output file (standard output by default); the summary goes
+ * to standard error. See BatchRunner for the line formats.
+ */
+class BatchCommand : public Command {
+public:
+    /**
+     * @brief Constructs a BatchCommand with the provided configuration.
+     *
+     * @param commandArgs Command arguments ("batch" followed by options and the input)
+     * @param config Application configuration containing the API key
+     */
+    BatchCommand(const std::vector<std::string>& commandArgs,
+                 const ApplicationSetup::Config& config);
+
+    /**
+     * @brief Executes the batch command.
+     *
+     * @throws std::invalid_argument if the arguments are malformed
+     * @throws std::runtime_error if the batch cannot be run or any job failed
+     */
+    void execute() override;
+
+    /**
+     * @brief Validates that an input is given and the options are well-formed.
+     *
+     * @throws std::invalid_argument for missing or malformed arguments
+     */
+    void validateArgs() const override;
+
+    /**
+     * @brief Gets the command name.
+     *
+     * @return "batch"
+     */
+    std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Parses the batch options from the command arguments.
+     *
+     * @return The batch options
+     * @throws std::invalid_argument on unknown options, missing values or a missing input
+     */
+    BatchOptions parseOptions() const;
+
+    /**
+     * @brief Parses a non-negative count option value.
+     *
+     * @param option The option name (for error messages)
+     * @param value The value to parse
+     * @param minimum The smallest accepted value
+     * @return The parsed count
+     * @throws std::invalid_argument if the value is not a valid count
+     */
+    static size_t parseCount(const std::string& option, const std::string& value, size_t minimum);
+};
@@ -3,6 +3,7 @@
 
 #include "command.h"
 #include "application_setup.h"
+#include "benchmark_config.h"
 
 /**
  * @class BenchmarkCommand
@@ -11,6 +12,9 @@
  * This command handles the execution of benchmark tests on AI models.
  * It supports both "test" and "benchmark" as command aliases and allows
  * for custom test prompts to be specified.
+ *
+ * Usage: aith benchmark [--concurrency N] [--iterations N] [--warmup N]
+ *                       [--stream] [--sort total|ttft|connect|tps] ["prompt"]
  */
 class BenchmarkCommand : public Command {
 public:
@@ -48,11 +52,25 @@ private:
     ApplicationSetup::Config config_;
     
     /**
-     * @brief Gets the test prompt to use for benchmarking
+     * @brief Parses the benchmark options from the command arguments
      * 
-     * @return The test prompt (default or user-specified)
+     * The first argument that is not an option is the test prompt.
+     * 
+     * @return The benchmark options (default prompt if none was given)
+     * @throws std::invalid_argument for unknown options or invalid values
+     */
+    BenchmarkOptions parseOptions() const;
+    
+    /**
+     * @brief Parses the integer value of a counting option
+     * 
+     * @param option The option name, used in error messages
+     * @param value The option value
+     * @param minimum Smallest accepted value
+     * @return The parsed count
+     * @throws std::invalid_argument if the value is not an integer >= minimum
      */
-    std::string getTestPrompt() const;
+    static size_t parseCount(const std::string& option, const std::string& value, size_t minimum);
     
     /**
      * @brief Default test prompt used when no custom prompt is provided
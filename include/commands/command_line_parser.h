@@ -25,9 +25,9 @@ public:
     /**
      * @brief Parses command line arguments and processes special flags.
      * 
-     * Processes special arguments like --provider/--p and sets up the
-     * ProviderManager accordingly. Returns the remaining arguments for
-     * command processing.
+     * Processes special arguments like --provider/--p, --timings, --no-cache and
+     * --trace and sets up the ProviderManager, HttpClient, ResponseCache and Trace
+     * accordingly. Returns the remaining arguments for command processing.
      * 
      * @param argc Argument count
      * @param argv Argument values
@@ -35,6 +35,14 @@ public:
      */
     static ParsedArgs parseArguments(int argc, char* argv[]);
 
+    /**
+     * @brief Parses command line arguments without the program name.
+     * 
+     * @param args Argument values after the program name
+     * @return ParsedArgs structure containing processed results
+     */
+    static ParsedArgs parseArguments(std::vector<std::string> args);
+
 private:
     /**
      * @brief Checks if an argument starts with a specific prefix.
@@ -16,7 +16,7 @@
  * For the 'view' and 'reuse' subcommands, target can be:
  * - "current" or "." - Use the current active history file
  * - "latest" - Use the most recently modified history file
- * - filename - Use a specific history file (e.g., "conversation_20240101_120000.json")
+ * - filename - Use a specific history file (e.g., "conversation_20240101_120000.jsonl")
  * 
  * The command will:
  * - List all files in the history directory (list subcommand)
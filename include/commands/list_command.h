@@ -2,6 +2,7 @@
 
 #include "command.h"
 #include "core/application_setup.h"
+#include "api/model_catalog.h"
 
 /**
  * @brief Command to list available AI models for the current provider.
@@ -11,7 +12,11 @@
  * API infrastructure to fetch and display model information.
  * 
  * Usage:
- *   ./aith list
+ *   ./aith list [--refresh] [--owner OWNER] [--prefix PREFIX]
+ * 
+ * Models are read from the on-disk model catalog while it is fresh;
+ * --refresh downloads the list again. --owner and --prefix filter the
+ * catalog locally.
  * 
  * The command will:
  * - Validate API configuration
@@ -24,7 +29,7 @@ public:
     /**
      * @brief Constructs a ListCommand with the provided configuration.
      * 
-     * @param commandArgs Command arguments (unused for list command)
+     * @param commandArgs Command arguments (options after "list")
      * @param config Application configuration containing API key, provider, and other settings
      */
     ListCommand(const std::vector<std::string>& commandArgs,
@@ -57,4 +62,14 @@ public:
      * @return "list"
      */
     std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Parses the list options.
+     * 
+     * @param filter Receives the --owner / --prefix filter
+     * @param refresh Set to true by --refresh
+     * @throws std::invalid_argument on unknown options or missing values
+     */
+    void parseOptions(ModelFilter& filter, bool& refresh) const;
 };
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "command.h"
+#include "core/application_setup.h"
+
+/**
+ * @brief Command to send one prompt to several providers/models and keep the fastest reply.
+ *
+ * Usage:
+ *   ./aith race "prompt" -m provider:model -m provider:model...
+ *   ./aith race --stats
+ *
+ * "-m provider" alone uses the provider's default model. The prompt continues
+ * the current conversation; only the winning reply is added to it. The
+ * outcome of every race is recorded, and --stats shows the wins, failures and
+ * mean winning time per contender.
+ */
+class RaceCommand : public Command {
+public:
+    /**
+     * @brief Constructs a RaceCommand with the provided configuration.
+     *
+     * @param commandArgs Command arguments ("race" followed by the prompt and options)
+     * @param config Application configuration containing the history paths
+     */
+    RaceCommand(const std::vector<std::string>& commandArgs,
+                const ApplicationSetup::Config& config);
+
+    /**
+     * @brief Executes the race command.
+     *
+     * @throws std::invalid_argument if the arguments are malformed
+     * @throws std::runtime_error if the race cannot be run
+     */
+    void execute() override;
+
+    /**
+     * @brief Validates the prompt and the contenders.
+     *
+     * @throws std::invalid_argument without a prompt or with fewer than two contenders
+     */
+    void validateArgs() const override;
+
+    /**
+     * @brief Gets the command name.
+     *
+     * @return "race"
+     */
+    std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Splits the arguments into the prompt, the contenders and --stats.
+     *
+     * @param prompt Receives the prompt
+     * @param contenders Receives the contender specs
+     * @return True if --stats was given
+     * @throws std::invalid_argument on unknown options or missing values
+     */
+    bool parseArgs(std::string& prompt, std::vector<std::string>& contenders) const;
+
+    /**
+     * @brief Prints the accumulated race results per contender.
+     */
+    static void displayStats();
+};
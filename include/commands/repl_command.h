@@ -0,0 +1,109 @@
+#pragma once
+
+#include "command.h"
+#include "core/application_setup.h"
+#include "chat/chat_session.h"
+#include "markdown/streaming_markdown_renderer.h"
+#include <memory>
+
+/**
+ * @brief Interactive chat session that stays in one process between turns.
+ *
+ * Usage:
+ *   ./aith repl [model]
+ *
+ * Every line is sent as a prompt that continues the current conversation.
+ * Unlike one aith process per prompt, the REPL keeps everything a turn needs
+ * alive: the parsed config files, the pooled (already connected) HTTPS
+ * connection, the conversation in memory and the markdown renderer. A turn
+ * only appends the new messages to the history file.
+ *
+ * Lines starting with '/' are commands:
+ *   /model [NAME]       Show or switch the model
+ *   /provider [NAME]    Show or switch the provider (and its default model)
+ *   /new [prompt]       Start a new conversation, with the prompt or the next line
+ *   /history            Show the conversation so far
+ *   /help               List the commands
+ *   /exit, /quit        Leave (as does end of input)
+ */
+class ReplCommand : public Command {
+public:
+    /**
+     * @brief Constructs a ReplCommand with the provided configuration.
+     *
+     * @param commandArgs Command arguments ("repl" and an optional model)
+     * @param config Application configuration containing the history paths
+     */
+    ReplCommand(const std::vector<std::string>& commandArgs,
+                const ApplicationSetup::Config& config);
+
+    /**
+     * @brief Reads and answers prompts until /exit or end of input.
+     *
+     * @throws std::invalid_argument if the arguments are malformed
+     */
+    void execute() override;
+
+    /**
+     * @brief Validates the optional model argument.
+     *
+     * @throws std::invalid_argument with more than one argument
+     */
+    void validateArgs() const override;
+
+    /**
+     * @brief Gets the command name.
+     *
+     * @return "repl"
+     */
+    std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Runs a slash command.
+     *
+     * @param line The input line, starting with '/'
+     * @return False if the session should end
+     */
+    bool runCommand(const std::string& line);
+
+    /**
+     * @brief Sends a prompt and renders the reply.
+     *
+     * A prompt that gets no reply is dropped from the conversation again.
+     *
+     * @param prompt The user's prompt
+     */
+    void sendPrompt(const std::string& prompt);
+
+    /**
+     * @brief Switches to another provider and its default model.
+     *
+     * The conversation continues; nothing changes if the provider has no API key.
+     *
+     * @param name The provider name
+     */
+    void switchProvider(const std::string& name);
+
+    /**
+     * @brief Prints the provider, model and conversation in use.
+     */
+    void displayStatus() const;
+
+    /**
+     * @brief Prints the conversation so far.
+     */
+    void displayHistory() const;
+
+    /**
+     * @brief Prints the available commands.
+     */
+    static void displayHelp();
+
+    ApplicationSetup::Config config_;
+    std::string model_;
+    std::string systemPrompt_;
+    std::unique_ptr<ChatSession> session_;
+    StreamingMarkdownRenderer renderer_;
+    bool startNew_ = false;         // The next prompt starts a new conversation
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "command.h"
+#include "core/application_setup.h"
+#include "server/proxy_server.h"
+
+/**
+ * @brief Command to run aith as a local OpenAI-compatible proxy.
+ *
+ * Usage:
+ *   ./aith serve [--listen HOST:PORT] [--threads N] [--max-per-client N] [--token TOKEN]
+ *
+ * Serves /v1/chat/completions and /v1/models on 127.0.0.1:8080 by default,
+ * forwarding to the configured providers (see ProxyServer). Runs until
+ * interrupted. A non-loopback address needs a token (--token, or SERVE_TOKEN
+ * in the config, which keeps it out of the process list).
+ */
+class ServeCommand : public Command {
+public:
+    /**
+     * @brief Constructs a ServeCommand with the provided configuration.
+     *
+     * @param commandArgs Command arguments ("serve" followed by the options)
+     * @param config Application configuration
+     */
+    ServeCommand(const std::vector<std::string>& commandArgs,
+                 const ApplicationSetup::Config& config);
+
+    /**
+     * @brief Starts the proxy and serves until the process ends.
+     *
+     * @throws std::invalid_argument if the options are malformed
+     * @throws std::runtime_error if the address cannot be bound
+     */
+    void execute() override;
+
+    /**
+     * @brief Validates the options.
+     *
+     * @throws std::invalid_argument on unknown options or bad values
+     */
+    void validateArgs() const override;
+
+    /**
+     * @brief Gets the command name.
+     *
+     * @return "serve"
+     */
+    std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Reads the listen address, thread count, per-client limit and token.
+     *
+     * @return The server options
+     * @throws std::invalid_argument on unknown options, bad values, or a
+     *         non-loopback address without a token
+     */
+    ProxyOptions parseArgs() const;
+
+    /**
+     * @brief Parses a positive number option value.
+     *
+     * @param option The option name, for the error message
+     * @param value The value to parse
+     * @return The number
+     * @throws std::invalid_argument if the value is not a positive number
+     */
+    static int parsePositive(const std::string& option, const std::string& value);
+};
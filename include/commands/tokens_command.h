@@ -0,0 +1,86 @@
+#pragma once
+
+#include "command.h"
+#include "core/application_setup.h"
+#include "tokenizer/bpe_tokenizer.h"
+#include <memory>
+
+/**
+ * @brief Command to count the tokens of files and conversations offline.
+ *
+ * Usage:
+ *   ./aith tokens [--tokenizer NAME|PATH] <target>...
+ *
+ * Each target can be:
+ * - "history" or "current" - the current conversation
+ * - "-" - standard input
+ * - a path to a file; history files (.jsonl/.json) are counted per message
+ * - the name of a file in the history directory
+ *
+ * The vocabulary is chosen as for the current provider and default model
+ * (see TokenCounter); --tokenizer overrides it. Without a vocabulary the
+ * counts are estimates. No network request is made.
+ */
+class TokensCommand : public Command {
+public:
+    /**
+     * @brief Constructs a TokensCommand with the provided configuration.
+     *
+     * @param commandArgs Command arguments ("tokens" followed by options and targets)
+     * @param config Application configuration containing provider and history paths
+     */
+    TokensCommand(const std::vector<std::string>& commandArgs,
+                  const ApplicationSetup::Config& config);
+
+    /**
+     * @brief Executes the tokens command.
+     *
+     * Prints the token count of every target, the total and the counting speed.
+     *
+     * @throws std::invalid_argument if no target is given or an option is malformed
+     * @throws std::runtime_error if a target or the vocabulary cannot be read
+     */
+    void execute() override;
+
+    /**
+     * @brief Validates that at least one target is given.
+     *
+     * @throws std::invalid_argument if no target is given or an option is malformed
+     */
+    void validateArgs() const override;
+
+    /**
+     * @brief Gets the command name.
+     *
+     * @return "tokens"
+     */
+    std::string getCommandName() const override;
+
+private:
+    /**
+     * @brief Splits the arguments into the --tokenizer value and the targets.
+     *
+     * @param tokenizerName Receives the --tokenizer value (empty if not given)
+     * @return The targets
+     * @throws std::invalid_argument on unknown options or missing values
+     */
+    std::vector<std::string> parseArgs(std::string& tokenizerName) const;
+
+    /**
+     * @brief Resolves a target to a file path ("-" stays as is).
+     *
+     * @param target The target as given on the command line
+     * @return The path to read
+     * @throws std::runtime_error if the target does not exist
+     */
+    std::string resolveTarget(const std::string& target) const;
+
+    /**
+     * @brief Counts the tokens of one target and prints the result.
+     *
+     * @param target The target as given on the command line
+     * @param tokenizer The tokenizer (nullptr to estimate)
+     * @return The number of tokens
+     */
+    size_t countTarget(const std::string& target, const BpeTokenizer* tokenizer) const;
+};
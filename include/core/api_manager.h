@@ -2,6 +2,11 @@
 #define API_MANAGER_H
 
 #include <string>
+#include <vector>
+#include "api/model_catalog.h"
+
+class ChatSession;
+class StreamingMarkdownRenderer;
 
 /**
  * @brief API management service for AITH application.
@@ -14,9 +19,13 @@ class ApiManager {
 public:
     /**
      * Lists all available models from the configured provider.
+     * The list comes from the on-disk model catalog while it is fresh.
      * @param apiKey The API key for authentication
+     * @param filter Only list models matching this owner / id prefix
+     * @param refresh True to ignore the cached catalog and download the list
      */
-    static void listModels(const std::string &apiKey);
+    static void listModels(const std::string &apiKey, const ModelFilter &filter = ModelFilter(),
+                           bool refresh = false);
     
     /**
      * Sends a chat request to the specified model.
@@ -29,6 +38,29 @@ public:
     static void chat(const std::string &prompt, const std::string &model, 
                      const std::string &apiKey, const std::string &currentHistory, 
                      bool newChat);
+    
+    /**
+     * Sends the conversation of a session to a model of the current provider
+     * and adds the reply to it (failover, hedging, caching as for chat).
+     * The session stays usable for further turns.
+     * @param session The conversation, ending with the new user message
+     * @param selectedModel The model to use for the chat
+     * @param apiKey The API key for authentication
+     * @param renderer Renderer for the reply, kept across turns by the caller (nullptr for a new one)
+     * @return True if the reply was added to the session and persisted
+     */
+    static bool send(ChatSession &session, const std::string &selectedModel, const std::string &apiKey,
+                     StreamingMarkdownRenderer *renderer = nullptr);
+    
+    /**
+     * Sends a prompt to several providers/models at once and keeps the first reply.
+     * Only the winning reply is rendered and added to the history.
+     * @param prompt The input string to send to every contender
+     * @param contenderSpecs The contenders as "provider:model" (or "provider")
+     * @param currentHistory The path to the history file
+     */
+    static void race(const std::string &prompt, const std::vector<std::string> &contenderSpecs,
+                     const std::string &currentHistory);
 };
 
 #endif // API_MANAGER_H
@@ -46,6 +46,39 @@ public:
     int run(int argc, char* argv[]);
 
 private:
+    /**
+     * @brief Runs a command line in this process
+     * 
+     * @param commandLine The arguments after the program name
+     * @return Exit code (0 for success, non-zero for errors)
+     */
+    int runCommandLine(const std::vector<std::string>& commandLine);
+    
+    /**
+     * @brief Runs this process as aithd until it is stopped
+     * 
+     * Each forwarded command line runs in a forked child of the daemon.
+     * 
+     * @return Exit code of the daemon
+     */
+    int runDaemon();
+    
+    /**
+     * @brief Handles "aith daemon [start | status | stop]"
+     * 
+     * @param args The complete argument list including the command
+     * @return Exit code (0 for success, non-zero for errors)
+     */
+    int runDaemonCommand(const std::vector<std::string>& args);
+    
+    /**
+     * @brief Checks if a command line may be handed to a running aithd
+     * 
+     * @param commandLine The arguments after the program name
+     * @return False for daemon control, the REPL, the proxy, --trace, or with AITH_NO_DAEMON set
+     */
+    static bool isForwardable(const std::vector<std::string>& commandLine);
+
     /**
      * @brief Displays usage information to the user
      * 
@@ -77,6 +110,9 @@ private:
      */
     void reportError(const std::string& message) const;
     
+    // True in a child forked by aithd to run one command
+    bool forkedByDaemon_ = false;
+    
     // Non-copyable and non-movable to ensure single instance semantics
     ApplicationController(const ApplicationController&) = delete;
     ApplicationController& operator=(const ApplicationController&) = delete;
@@ -113,4 +113,12 @@ private:
      * @param config The application configuration to update
      */
     static void migrateLegacyCurrentHistory(Config& config);
+    
+    /**
+     * Converts the current conversation from the legacy JSON array file
+     * (current_<name>.json) to the line-delimited format (current_<name>.jsonl).
+     * 
+     * @param config The application configuration
+     */
+    static void migrateCurrentHistoryFormat(const Config& config);
 };
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 // Forward declarations
 class BlacklistFileManager;
@@ -24,6 +25,10 @@ struct BlacklistEntry {
  * This class manages the blacklist of AI models that should not be used.
  * It provides a high-level interface for blacklist operations, delegating
  * to specialized operation classes through the factory pattern.
+ *
+ * Add and remove are serialized within the process, so concurrent callers
+ * (e.g. parallel benchmark workers auto-blacklisting models) cannot
+ * interleave their writes to the blacklist file.
  */
 class BlacklistManager {
 public:
@@ -56,4 +61,11 @@ public:
      * @return A vector of BlacklistEntry structures
      */
     static std::vector<BlacklistEntry> getBlacklistedModels();
+
+private:
+    /**
+     * Gets the mutex that serializes modifications of the blacklist file.
+     * @return The process-wide write mutex
+     */
+    static std::mutex& getWriteMutex();
 };
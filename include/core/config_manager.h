@@ -10,6 +10,10 @@
  * environment variables and configuration files. It handles both main
  * configuration (~/.config/aith/config) and provider-specific configurations
  * (~/.config/aith/{provider}.conf).
+ *
+ * Each config file is parsed once per process and kept in memory; a lookup
+ * only checks the file's modification time and size, and re-reads the file
+ * when it changed, so long-running sessions still see edits.
  */
 class ConfigManager {
 public:
@@ -37,6 +41,48 @@ public:
      */
     static std::string getProviderConfigValue(const std::string &provider, const std::string &key);
 
+    /**
+     * Gets a configuration value for one model of a provider.
+     * Checks the provider config for KEY@model, then the provider config for
+     * KEY, then the main config for KEY.
+     * @param provider The provider name
+     * @param model The model name
+     * @param key The configuration key to look for
+     * @return The configuration value or empty string if not found
+     */
+    static std::string getModelConfigValue(const std::string &provider, const std::string &model,
+                                           const std::string &key);
+
+    /**
+     * Gets a numeric setting of a provider, or of one of its models.
+     * Checks the provider config for KEY, then the main config for KEY; with a
+     * model, the provider config for KEY@model comes first (as getModelConfigValue).
+     * @param provider The provider name
+     * @param key The configuration key to look for
+     * @param defaultValue The value to use if the key is unset, malformed or negative
+     * @param model The model name, or empty for a provider-wide setting
+     * @return The configured number or the default
+     */
+    static double getProviderNumber(const std::string &provider, const std::string &key, double defaultValue,
+                                    const std::string &model = "");
+
+    /**
+     * Gets a boolean configuration value from environment variable or main config file.
+     * Accepts true/false, yes/no, on/off and 1/0 (case-insensitive).
+     * @param key The configuration key to look for
+     * @param defaultValue The value to use if the key is unset or unrecognized
+     * @return The configured flag or the default
+     */
+    static bool getConfigFlag(const std::string &key, bool defaultValue);
+
+    /**
+     * Checks whether a provider has a config file of its own.
+     * Names that could point outside the config directory ('/', a leading '.') never do.
+     * @param provider The provider name
+     * @return True if ~/.config/aith/<provider>.conf (in any supported case) exists
+     */
+    static bool hasProviderConfig(const std::string &provider);
+
     /**
      * Gets the default prompt content from the defaultprompt file.
      * Reads from ~/.config/aith/defaultprompt if it exists.
@@ -50,10 +96,16 @@ public:
      */
     static std::string getConfigDir();
 
+    /**
+     * Gets the cache directory path ($XDG_CACHE_HOME/aith or ~/.cache/aith)
+     * @return The cache directory path
+     */
+    static std::string getCacheDir();
+
 private:
     
     /**
-     * Reads a configuration value from a specific file.
+     * Reads a configuration value from a specific file, through the parsed file cache.
      * @param configPath The path to the configuration file
      * @param key The configuration key to look for
      * @return The configuration value or empty string if not found
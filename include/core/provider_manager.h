@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "http_retry.h"
 
 /**
  * @brief Provider/Agent management for AI application.
@@ -42,6 +43,14 @@ public:
      */
     static std::string getDefaultModel();
     
+    /**
+     * Gets the default model for a provider.
+     * Checks provider-specific config first, then falls back to main config.
+     * @param provider The provider name
+     * @return The default model name
+     */
+    static std::string getDefaultModel(const std::string &provider);
+    
     /**
      * Gets the API URL for the current provider.
      * Checks provider-specific config first, then falls back to main config.
@@ -49,6 +58,14 @@ public:
      */
     static std::string getApiUrl();
     
+    /**
+     * Gets the API URL for a provider.
+     * Checks provider-specific config first, then falls back to main config.
+     * @param provider The provider name
+     * @return The API URL
+     */
+    static std::string getApiUrl(const std::string &provider);
+    
     /**
      * Gets the API key for the current provider.
      * Checks for the API key in the following order:
@@ -59,6 +76,24 @@ public:
      * @return The API key or empty string if not found
      */
     static std::string getApiKey();
+    
+    /**
+     * Gets the API key for a provider, in the same order as getApiKey().
+     * Lets several providers be used side by side in one process.
+     * @param provider The provider name
+     * @return The API key or empty string if not found
+     */
+    static std::string getApiKey(const std::string &provider);
+    
+    /**
+     * Gets the retry policy for a provider.
+     * Reads RETRY_MAX_ATTEMPTS, RETRY_BASE_MS and RETRY_MAX_MS from the
+     * provider-specific config first, then from the main config; unset or
+     * malformed values keep the RetryPolicy defaults.
+     * @param provider The provider name
+     * @return The retry policy
+     */
+    static RetryPolicy getRetryPolicy(const std::string &provider);
 
 private:
     /**
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+/**
+ * @brief Hands aith invocations to a running aithd.
+ *
+ * forward() connects to the daemon socket and, if a compatible daemon
+ * accepts the command, waits for its exit status while the daemon writes to
+ * this process's terminal. Without a daemon (no socket, a stale socket, a
+ * different protocol version) nothing has run yet, and the caller executes
+ * the command in-process as usual. Setting AITH_NO_DAEMON disables
+ * forwarding.
+ */
+class DaemonClient {
+public:
+    /**
+     * Checks if commands may be forwarded at all.
+     * @return False if AITH_NO_DAEMON is set
+     */
+    static bool isEnabled();
+
+    /**
+     * Lets the daemon run a command line, if one is running.
+     * @param args The command line arguments after the program name
+     * @param exitCode Receives the command's exit status when forwarded
+     * @return False if no daemon took the command; it has not run
+     */
+    static bool forward(const std::vector<std::string>& args, int& exitCode);
+
+    /**
+     * Sends a control request ("status" or "stop") to the daemon.
+     * @param control The request
+     * @param reply Receives the daemon's answer
+     * @return False if no daemon is running
+     */
+    static bool control(const std::string& control, Json::Value& reply);
+};
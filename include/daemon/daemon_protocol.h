@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+/**
+ * @brief Messages between aith and the aithd daemon on its Unix socket.
+ *
+ * Every message is a JSON object preceded by its length (4 bytes, network
+ * byte order). File descriptors travel alongside a message as SCM_RIGHTS
+ * ancillary data.
+ *
+ * Exchange for one command line:
+ *   client -> {"version", "args", "cwd", "env"}   + stdin, stdout, stderr
+ *   daemon -> {"accepted": true}                  (or {"error": ...}; the client runs the command itself)
+ *   daemon -> {"exit": N}                         once the command has finished
+ *
+ * Control requests carry {"version", "control": "status" | "stop"} instead
+ * of "args" and are answered with one message.
+ */
+class DaemonProtocol {
+public:
+    static const int VERSION;
+
+    /**
+     * Gets the path of the daemon socket.
+     * $XDG_RUNTIME_DIR/aith/aithd.sock when set, otherwise ~/.cache/aith/aithd.sock.
+     * @return The socket path
+     */
+    static std::string getSocketPath();
+
+    /**
+     * Connects to the daemon socket.
+     * @return The connected socket, or -1 if no daemon is listening
+     */
+    static int connectToDaemon();
+
+    /**
+     * Sends a message, with optional file descriptors.
+     * @param socket The connected socket
+     * @param message The message
+     * @param fds Descriptors to pass along (may be empty)
+     * @return False if the message could not be sent completely
+     */
+    static bool send(int socket, const Json::Value& message, const std::vector<int>& fds = {});
+
+    /**
+     * Receives a message and any file descriptors sent with it.
+     * @param socket The connected socket
+     * @param message Receives the message
+     * @param fds Receives the passed descriptors, owned by the caller (nullptr to close them)
+     * @return False if the connection closed or the message is malformed
+     */
+    static bool receive(int socket, Json::Value& message, std::vector<int>* fds = nullptr);
+
+private:
+    /**
+     * Writes a buffer completely, retrying on interrupts.
+     * @return False on error or a closed connection
+     */
+    static bool writeAll(int socket, const char* data, size_t length);
+
+    /**
+     * Reads a buffer completely, retrying on interrupts.
+     * @return False on error or a closed connection
+     */
+    static bool readAll(int socket, char* data, size_t length);
+};
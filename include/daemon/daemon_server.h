@@ -0,0 +1,107 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+#include <json/json.h>
+
+/**
+ * @brief The aithd daemon: runs the commands of other aith processes from one long-lived process.
+ *
+ * Each aith invocation otherwise starts cold: it parses the config files,
+ * loads the blacklist index and the tokenizer vocabulary. aithd keeps all of
+ * that in memory and forks a child per command, which starts with those
+ * caches already filled. A client passes its command line, working
+ * directory, environment and its stdin, stdout and stderr descriptors over
+ * the Unix socket; the child takes them over as its own, so output, colors
+ * and terminal detection behave as if aith ran in the client's terminal,
+ * and the daemon replies with the child's exit status.
+ *
+ * Commands run concurrently, each in its own process, so one command's
+ * options, environment and working directory never reach another, nor the
+ * daemon. A client that goes away (Ctrl-C) interrupts its command with
+ * SIGINT. The children's request metrics are added to the daemon's, which
+ * writes METRICS_FILE. Only processes of the same user are served.
+ */
+class DaemonServer {
+public:
+    /**
+     * @brief Runs one command line; returns its exit status.
+     */
+    using CommandRunner = std::function<int(const std::vector<std::string>& args)>;
+
+    /**
+     * @brief Fills or refreshes the daemon's caches before a command is forked.
+     */
+    using WarmUp = std::function<void()>;
+
+    /**
+     * Listens on the daemon socket and serves clients until stopped
+     * (aith daemon stop, SIGINT or SIGTERM); then waits for running commands.
+     * @param runCommand Runs a forwarded command line in a child process
+     * @param warmUp Loads what the children should find in memory
+     * @return Exit status of the daemon
+     */
+    static int run(const CommandRunner& runCommand, const WarmUp& warmUp);
+
+    static const size_t MAX_RUNNING_COMMANDS;
+
+private:
+    /**
+     * @brief A forwarded command running in a child process.
+     */
+    struct RunningCommand {
+        pid_t pid;
+        int client;             // The client's connection, -1 once it went away
+        int resultPipe;         // Receives the child's metrics; end of file when it exits
+        std::string metrics;
+    };
+
+    /**
+     * Creates the listening socket, replacing a stale socket file.
+     * @param path The socket path
+     * @return The socket, or -1 after printing why it failed
+     */
+    static int openListener(const std::string& path);
+
+    /**
+     * Checks that a client runs as the same user as the daemon.
+     * @param client The accepted connection
+     * @return True if the client may use the daemon
+     */
+    static bool isPeerTrusted(int client);
+
+    /**
+     * Reads a client's request; answers control requests and starts commands.
+     * @param client The accepted connection (ownership passes to this method)
+     * @param listener The listening socket, closed in the child
+     * @param running The running commands; a started command is added
+     * @param runCommand Runs a forwarded command line
+     * @param warmUp Refreshes the caches before forking
+     * @return False if the client asked the daemon to stop
+     */
+    static bool serve(int client, int listener, std::vector<RunningCommand>& running,
+                      const CommandRunner& runCommand, const WarmUp& warmUp);
+
+    /**
+     * Forks a child that runs a forwarded command on the client's descriptors,
+     * working directory and environment.
+     * @param request The client's request
+     * @param fds The client's stdin, stdout and stderr; closed in the daemon
+     * @param client The client's connection
+     * @param listener The listening socket, closed in the child
+     * @param running The running commands; their descriptors are closed in the child
+     * @param runCommand Runs the command line
+     * @return The new command, or pid -1 if fork failed
+     */
+    static RunningCommand start(const Json::Value& request, const std::vector<int>& fds, int client, int listener,
+                                const std::vector<RunningCommand>& running, const CommandRunner& runCommand);
+
+    /**
+     * Reaps a child whose result pipe reached end of file, adds its metrics
+     * and sends the exit status to its client.
+     * @param command The finished command; its descriptors are closed
+     */
+    static void finish(RunningCommand& command);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mutex>
+#include <httplib.h>
+
+/**
+ * @brief Lets one thread abort an HTTP request running on another.
+ *
+ * Pass the same object to HttpClient::postStream and call cancel() from any
+ * thread: the socket of the request in flight is shut down, so the request
+ * returns right away even while it is still waiting for the response, and a
+ * request started after cancel() is not sent at all. A cancelled request
+ * returns normally without throwing; its connection is not reused.
+ *
+ * An object cancels once and is meant for a single request.
+ */
+class HttpCancellation {
+public:
+    HttpCancellation() = default;
+    HttpCancellation(const HttpCancellation&) = delete;
+    HttpCancellation& operator=(const HttpCancellation&) = delete;
+
+    /**
+     * Aborts the request, or the next one started with this object.
+     */
+    void cancel();
+
+    /**
+     * Checks if cancel() has been called.
+     * @return True once cancelled
+     */
+    bool isCancelled() const;
+
+private:
+    friend class HttpClient;
+
+    /**
+     * Registers the client about to send the request.
+     * @param client The client sending the request
+     * @return False if already cancelled; the request must not be sent
+     */
+    bool attach(httplib::Client& client);
+
+    /**
+     * Unregisters the client once its request has returned.
+     */
+    void detach();
+
+    mutable std::mutex mutex_;
+    httplib::Client* client_ = nullptr;
+    bool cancelled_ = false;
+};
@@ -4,6 +4,12 @@
 #include <json/json.h>
 #include <httplib.h>
 #include <memory>
+#include <functional>
+#include <atomic>
+#include "http_timings.h"
+#include "http_error.h"
+#include "http_cancellation.h"
+#include "http_retry.h"
 
 /**
  * @brief Modern HTTP client for making API requests.
@@ -11,20 +17,73 @@
  * This class provides static methods for making HTTP requests using the
  * high-performance httplib library. Offers excellent performance, detailed
  * error handling, automatic SSL/TLS support, and enhanced security.
+ *
+ * Clients are borrowed from HttpConnectionPool, so consecutive requests to
+ * the same scheme+host reuse the keep-alive connection instead of repeating
+ * the TCP and TLS handshakes.
+ *
+ * Every request can report a per-phase timing breakdown (DNS, connect, TLS,
+ * request write, time to first byte, transfer) through an optional
+ * HttpTimings output. With setTimingsEnabled(true) (the global --timings
+ * flag) requests whose caller did not ask for the breakdown print it to stderr.
+ *
+ * Failed requests throw HttpError, a std::runtime_error carrying the HTTP
+ * status (0 for connection errors and timeouts). POST requests given a
+ * RetryPolicy are repeated first on failures that are safe to repeat (see
+ * HttpRetry); the error of the last attempt is thrown.
  */
 class HttpClient {
 public:
+    /**
+     * Per-request timeouts; 0 keeps the default for that phase.
+     * Lets callers with somewhere else to go (e.g. a failover chain) give up
+     * long before the defaults.
+     */
+    struct Timeouts {
+        int connectMs = 0;
+        int readMs = 0;     // Longest wait for the next response bytes, including the first
+    };
+
     // HTTP client methods using httplib library
     /**
      * Performs an HTTP GET request using httplib library.
      * Offers excellent performance, error handling, and security.
      * @param url The complete URL to make the GET request to
      * @param apiKey The API key for Bearer token authentication
+     * @param timings Optional output for the request's timing breakdown
      * @return The response body as a string
      * @throws std::runtime_error if the request fails
      * @throws std::invalid_argument if the URL format is invalid
      */
-    static std::string get(const std::string& url, const std::string& apiKey);
+    static std::string get(const std::string& url, const std::string& apiKey,
+                           HttpTimings* timings = nullptr);
+
+    /**
+     * Result of a conditional GET request
+     */
+    struct ConditionalResponse {
+        bool notModified = false;   // Server answered 304; body is empty
+        std::string body;           // Response body (200 only)
+        std::string etag;           // ETag validator of the response, if any
+        std::string lastModified;   // Last-Modified validator of the response, if any
+    };
+
+    /**
+     * Performs an HTTP GET request revalidating a cached copy.
+     * Sends If-None-Match / If-Modified-Since for the validators that are
+     * non-empty; a 304 response is reported as notModified instead of failing.
+     * @param url The complete URL to make the GET request to
+     * @param apiKey The API key for Bearer token authentication
+     * @param etag ETag of the cached copy (empty if unknown)
+     * @param lastModified Last-Modified of the cached copy (empty if unknown)
+     * @param timings Optional output for the request's timing breakdown
+     * @return The response with its validators
+     * @throws std::runtime_error if the request fails
+     * @throws std::invalid_argument if the URL format is invalid
+     */
+    static ConditionalResponse getConditional(const std::string& url, const std::string& apiKey,
+                                              const std::string& etag, const std::string& lastModified,
+                                              HttpTimings* timings = nullptr);
     
     /**
      * Performs an HTTP POST request with JSON payload using httplib library.
@@ -32,12 +91,65 @@ public:
      * @param url The complete URL to make the POST request to
      * @param apiKey The API key for Bearer token authentication
      * @param payload The JSON payload to send in the request body
+     * @param timings Optional output for the request's timing breakdown
+     * @param timeouts Optional timeouts replacing the defaults for this request
+     * @param retry Optional policy repeating the request on retryable failures
      * @return The response body as a string
      * @throws std::runtime_error if the request fails
      * @throws std::invalid_argument if the URL format is invalid
      */
     static std::string post(const std::string& url, const std::string& apiKey, 
-                           const Json::Value& payload);
+                           const Json::Value& payload, HttpTimings* timings = nullptr,
+                           const Timeouts* timeouts = nullptr, const RetryPolicy* retry = nullptr);
+
+    /**
+     * Callback receiving raw response body chunks as they arrive.
+     * Return false to stop the transfer early; postStream then returns normally.
+     */
+    using ChunkCallback = std::function<bool(const char* data, size_t length)>;
+
+    /**
+     * Performs a streaming HTTP POST request with JSON payload.
+     * The response body is not buffered; each chunk is handed to the callback
+     * as soon as it is read from the socket (e.g. Server-Sent-Events).
+     * @param url The complete URL to make the POST request to
+     * @param apiKey The API key for Bearer token authentication
+     * @param payload The JSON payload to send in the request body
+     * @param onChunk Callback invoked for each received body chunk
+     * @param timings Optional output for the request's timing breakdown
+     * @param cancellation Optional handle to abort the request from another thread;
+     *                     a cancelled request returns normally
+     * @param timeouts Optional timeouts replacing the defaults for this request
+     * @param retry Optional policy repeating the request on retryable failures,
+     *              as long as no data was delivered
+     * @throws std::runtime_error if the request fails or returns an error status
+     * @throws std::invalid_argument if the URL format is invalid
+     */
+    static void postStream(const std::string& url, const std::string& apiKey,
+                           const Json::Value& payload, const ChunkCallback& onChunk,
+                           HttpTimings* timings = nullptr, HttpCancellation* cancellation = nullptr,
+                           const Timeouts* timeouts = nullptr, const RetryPolicy* retry = nullptr);
+
+    /**
+     * Enables or disables printing the timing breakdown of every request.
+     * Requests that pass an HttpTimings output are not printed; their caller
+     * reports the timings itself.
+     * @param enabled True to print timings to stderr
+     */
+    static void setTimingsEnabled(bool enabled);
+
+    /**
+     * Checks if the timing breakdown of every request is printed.
+     * @return True if timings are enabled
+     */
+    static bool isTimingsEnabled();
+
+    /**
+     * Formats a timing breakdown as a single line.
+     * @param timings The timing breakdown
+     * @return Human readable phases, byte counts and connection reuse
+     */
+    static std::string formatTimings(const HttpTimings& timings);
 
 private:
     // HTTP client configuration constants
@@ -45,6 +157,10 @@ private:
     static constexpr int READ_TIMEOUT_SECONDS = 60;
     static constexpr int WRITE_TIMEOUT_SECONDS = 60;
 
+    // A reused keep-alive socket that the server already closed fails almost
+    // immediately; failures within this window are retried on a fresh connection
+    static constexpr int STALE_CONNECTION_WINDOW_MS = 1000;
+
     // Utility methods for httplib implementation
     /**
      * Configures HTTP client with timeouts and performance settings.
@@ -62,6 +178,112 @@ private:
      */
     static void validateResponse(const httplib::Result& response, 
                                const std::string& operation);
+
+    /**
+     * Validates an HTTP status code and throws appropriate errors.
+     * @param status The HTTP status code
+     * @param body The response body to include in error messages
+     * @param operation The operation name for error messages (e.g., "GET", "POST")
+     * @throws std::runtime_error if the status indicates failure
+     */
+    static void validateStatus(int status, const std::string& body,
+                               const std::string& operation);
+
+    /**
+     * Serializes a JSON payload into a request body.
+     * @param payload The JSON payload
+     * @return The serialized JSON string
+     */
+    static std::string serializePayload(const Json::Value& payload);
+
+    /**
+     * Sends a request on a pooled client for the given base URL.
+     * If a reused client fails right away, its socket was probably closed by
+     * the server while idle, so the request is retried once on a fresh
+     * connection (see isStaleConnectionError for which failures qualify).
+     * @param baseUrl The scheme and host to send the request to
+     * @param sendRequest Function performing the request on the given client
+     * @param idempotent True if the request may reach the server twice (GET)
+     * @param canRetry Optional check vetoing the retry (e.g. once streamed data was delivered)
+     * @param cancellation Optional handle the sending client is registered with
+     * @param timeouts Optional timeouts applied to the client for this request only
+     * @return The HTTP result of the (last) attempt (Error::Canceled if cancelled before sending)
+     */
+    static httplib::Result sendPooled(const std::string& baseUrl,
+                                      const std::function<httplib::Result(httplib::Client&)>& sendRequest,
+                                      bool idempotent, const std::function<bool()>& canRetry = nullptr,
+                                      HttpCancellation* cancellation = nullptr,
+                                      const Timeouts* timeouts = nullptr);
+
+    /**
+     * Sends a request on a pooled client, measuring its phases when asked to.
+     * Timing is only set up if a timings output is given or timings are enabled.
+     * @param baseUrl The scheme and host to send the request to
+     * @param request The request to send
+     * @param timings Optional output for the timing breakdown
+     * @param canRetry Optional check vetoing the stale-connection retry
+     * @param cancellation Optional handle to abort the request from another thread
+     * @param timeouts Optional timeouts replacing the defaults for this request
+     * @return The HTTP result of the (last) attempt
+     */
+    static httplib::Result sendTimed(const std::string& baseUrl, const httplib::Request& request,
+                                     HttpTimings* timings, const std::function<bool()>& canRetry = nullptr,
+                                     HttpCancellation* cancellation = nullptr,
+                                     const Timeouts* timeouts = nullptr);
+
+    /**
+     * Sends a request like sendTimed, repeating it while the retry policy allows.
+     * The attempts and the backoff are added to the timings output; with
+     * timings enabled, the report is printed once, after the last attempt.
+     * @param baseUrl The scheme and host to send the request to
+     * @param request The request to send
+     * @param timings Optional output for the timing breakdown
+     * @param canRetry Optional check vetoing any repetition
+     * @param cancellation Optional handle to abort the request from another thread
+     * @param timeouts Optional timeouts replacing the defaults for this request
+     * @param retry Optional retry policy (nullptr sends once)
+     * @return The HTTP result of the last attempt
+     */
+    static httplib::Result sendRetried(const std::string& baseUrl, const httplib::Request& request,
+                                       HttpTimings* timings, const std::function<bool()>& canRetry,
+                                       HttpCancellation* cancellation, const Timeouts* timeouts,
+                                       const RetryPolicy* retry);
+
+    /**
+     * Prints the timing breakdown of a request to stderr.
+     * @param method The HTTP method
+     * @param url The request URL
+     * @param timings The timing breakdown
+     */
+    static void reportTimings(const std::string& method, const std::string& url,
+                              const HttpTimings& timings);
+
+    /**
+     * Passes the rate limit headers of a response to the retry policy's hook, if it has one.
+     * Responses without such headers are not reported.
+     * @param retry The retry policy of the request
+     * @param response The response
+     */
+    static void reportRateLimit(const RetryPolicy& retry, const httplib::Response& response);
+
+    /**
+     * Gets the flag enabling the timing report for every request.
+     * @return Reference to the process-wide flag
+     */
+    static std::atomic<bool>& timingsEnabled();
+
+    /**
+     * Determines whether a failed request on a reused client looks like a
+     * stale keep-alive socket rather than a genuine network or server failure.
+     * A read error means the request was written and may have been processed,
+     * so only idempotent requests are repeated after one; a POST is repeated
+     * only if writing it failed.
+     * @param error The httplib error of the failed request
+     * @param elapsedMs How long the failed attempt took
+     * @param idempotent True if the request may reach the server twice
+     * @return True if the request should be retried on a fresh connection
+     */
+    static bool isStaleConnectionError(httplib::Error error, double elapsedMs, bool idempotent);
     
     /**
      * Parses a full URL into base URL and path components.
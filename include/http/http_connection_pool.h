@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <httplib.h>
+
+/**
+ * @brief Process-wide pool of keep-alive HTTP clients.
+ *
+ * httplib::Client keeps its socket open between requests when keep-alive is
+ * enabled, but only for as long as the client object lives. This pool keeps
+ * idle clients alive per scheme+host (the baseUrl returned by
+ * HttpClient::parseUrl) so that consecutive requests to the same provider
+ * reuse the established TCP + TLS connection instead of paying the handshake
+ * on every call.
+ *
+ * Each leased client is used exclusively by one caller at a time, so the pool
+ * is safe to use from multiple threads. Idle clients that exceed the idle
+ * timeout are treated as stale and discarded, and at most MAX_IDLE_PER_HOST
+ * idle clients are kept for each host.
+ *
+ * Usage:
+ *   auto lease = HttpConnectionPool::acquire(baseUrl);
+ *   auto response = lease.client().Get(path, headers);
+ *   if (!response) lease.markBroken();
+ */
+class HttpConnectionPool {
+public:
+    /**
+     * @brief Exclusive, RAII-managed handle to a pooled client.
+     *
+     * The client is returned to the pool when the lease is destroyed,
+     * unless it has been marked broken.
+     */
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        /**
+         * Gets the leased HTTP client.
+         * @return Reference to the client
+         */
+        httplib::Client& client() { return *client_; }
+
+        /**
+         * Checks if the client was taken from the idle pool.
+         * A reused client may hold a warm connection; a fresh one still needs
+         * to be configured by the caller.
+         * @return True if the client was reused, false if newly created
+         */
+        bool isReused() const { return reused_; }
+
+        /**
+         * Marks the client as unusable so that it is discarded instead of
+         * being returned to the pool (e.g. after a connection error).
+         */
+        void markBroken() { broken_ = true; }
+
+    private:
+        friend class HttpConnectionPool;
+
+        Lease(const std::string& baseUrl, std::unique_ptr<httplib::Client> client, bool reused);
+
+        /**
+         * Returns the client to the pool (or discards it) and empties the lease.
+         */
+        void release();
+
+        std::string baseUrl_;
+        std::unique_ptr<httplib::Client> client_;
+        bool reused_;
+        bool broken_;
+    };
+
+    /**
+     * Acquires a client for the given base URL.
+     * Returns a warm idle client when one is available, otherwise creates a new one.
+     * @param baseUrl The scheme and host to connect to (e.g., "https://api.groq.com")
+     * @param freshConnection If true, always creates a new client (e.g. after a stale socket)
+     * @return Lease owning the client until it goes out of scope
+     */
+    static Lease acquire(const std::string& baseUrl, bool freshConnection = false);
+
+    /**
+     * Closes and discards all idle clients.
+     */
+    static void clear();
+
+    /**
+     * Gets the number of idle clients currently pooled for a base URL.
+     * @param baseUrl The scheme and host to look up
+     * @return Number of idle clients
+     */
+    static size_t idleCount(const std::string& baseUrl);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Pool limits
+    static constexpr size_t MAX_IDLE_PER_HOST = 32;  // Enough for a full batch or benchmark worker pool
+    static constexpr int IDLE_TIMEOUT_SECONDS = 30;
+
+    struct IdleClient {
+        std::unique_ptr<httplib::Client> client;
+        Clock::time_point lastUsed;
+    };
+
+    /**
+     * Returns a client to the idle pool, evicting the oldest one if the host is full.
+     * @param baseUrl The scheme and host the client is connected to
+     * @param client The client to return
+     */
+    static void release(const std::string& baseUrl, std::unique_ptr<httplib::Client> client);
+
+    /**
+     * Checks whether an idle client has been unused long enough that the
+     * server has likely closed its connection.
+     * @param idle The idle client to check
+     * @param now The current time
+     * @return True if the client should be discarded
+     */
+    static bool isStale(const IdleClient& idle, Clock::time_point now);
+
+    static std::mutex& getMutex();
+    static std::unordered_map<std::string, std::vector<IdleClient>>& getIdleClients();
+};
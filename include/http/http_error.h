@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Error raised by HttpClient when a request fails.
+ *
+ * Carries the HTTP status so that callers can tell transient failures
+ * (rate limiting, server errors, connection failures) from permanent ones
+ * without parsing the message. Derives from std::runtime_error, so existing
+ * handlers keep working.
+ */
+class HttpError : public std::runtime_error {
+public:
+    /**
+     * Creates an HTTP error.
+     * @param message The error message
+     * @param status The HTTP status code (0 if no response was received)
+     */
+    HttpError(const std::string& message, int status)
+        : std::runtime_error(message), status_(status) {}
+
+    /**
+     * Gets the HTTP status code.
+     * @return The status code, or 0 for connection errors and timeouts
+     */
+    int getStatus() const { return status_; }
+
+    /**
+     * Checks if retrying the same request may succeed.
+     * @return True for connection errors, 408, 429 and 5xx responses
+     */
+    bool isTransient() const {
+        return status_ == 0 || status_ == 408 || status_ == 429 || status_ >= 500;
+    }
+
+private:
+    int status_;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <httplib.h>
+#include "http_timings.h"
+
+/**
+ * @brief Measures the phases of one request sent on an httplib client.
+ *
+ * httplib has no timing API, so the timer hooks into the points it does
+ * expose and records a timestamp at each of them:
+ * - DNS: when the client has no open socket, the host is resolved here
+ *   (timed) and handed to httplib through its host-to-address map, one
+ *   address at a time: send() moves on to the next address when connecting
+ *   fails, as httplib does when it resolves the host itself.
+ * - Connect: the socket options callback runs only when httplib creates a
+ *   new socket, which also tells whether the connection was reused.
+ * - TLS: an OpenSSL info callback on the client's SSL_CTX reports the start
+ *   and end of the handshake.
+ * - Request write: the body is sent through a content provider, which
+ *   httplib only calls after the headers were written.
+ * - First byte / transfer: the response handler runs when the response
+ *   headers have been parsed; the body follows until send() returns.
+ *
+ * The hooks are installed on the client in the constructor and removed in the
+ * destructor, so a pooled client carries no timer state between requests.
+ *
+ * Usage:
+ *   HttpTimings timings;
+ *   HttpRequestTimer timer(client, timings);
+ *   auto result = timer.send(request);
+ */
+class HttpRequestTimer {
+public:
+    /**
+     * Starts timing and installs the connection hooks on the client.
+     * @param client The client the request will be sent on
+     * @param timings Receives the breakdown when finish() is called
+     */
+    HttpRequestTimer(httplib::Client& client, HttpTimings& timings);
+
+    /**
+     * Removes the hooks from the client.
+     */
+    ~HttpRequestTimer();
+
+    HttpRequestTimer(const HttpRequestTimer&) = delete;
+    HttpRequestTimer& operator=(const HttpRequestTimer&) = delete;
+
+    /**
+     * Sends a request on the client with timing hooks, then finishes timing.
+     * A connection failure is retried on the host's other resolved addresses.
+     * @param request The request to send
+     * @return The result of the last attempt
+     */
+    httplib::Result send(const httplib::Request& request);
+
+    /**
+     * Creates a copy of the request with timing hooks added.
+     * The body is moved to a content provider and the response handler and
+     * content receiver are wrapped; the original callbacks are still called.
+     * @param request The request to send
+     * @return The instrumented request; send this one instead
+     */
+    httplib::Request instrument(const httplib::Request& request);
+
+    /**
+     * Stops timing and computes the phase durations.
+     * @param result The result of sending the instrumented request
+     */
+    void finish(const httplib::Result& result);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    httplib::Client& client_;
+    HttpTimings& timings_;
+    std::string body_;
+
+    Clock::time_point start_;
+    Clock::time_point dnsEnd_;
+    Clock::time_point socketCreated_;
+    Clock::time_point tlsStart_;
+    Clock::time_point tlsEnd_;
+    Clock::time_point writeStart_;
+    Clock::time_point writeEnd_;
+    Clock::time_point firstByte_;
+    size_t bytesReceived_;
+    std::vector<std::string> addresses_;    // Resolved addresses of the host, in getaddrinfo order
+    size_t addressIndex_;                   // The address currently pinned
+
+    /**
+     * Resolves the client's host and pins its first address for this request.
+     * Skipped when the client has an open socket that httplib will reuse.
+     */
+    void resolveHost();
+
+    /**
+     * Pins the next resolved address of the host.
+     * @return False if no address is left
+     */
+    bool pinNextAddress();
+
+    /**
+     * Installs the OpenSSL info callback on the client's SSL context.
+     */
+    void attachTls();
+
+    /**
+     * Removes the OpenSSL info callback and its data from the client's SSL context.
+     */
+    void detachTls();
+
+    /**
+     * Gets the duration between two recorded timestamps.
+     * @return Milliseconds from begin to end, or 0 if either was not recorded
+     */
+    static double msBetween(const Clock::time_point& begin, const Clock::time_point& end);
+
+    /**
+     * Checks if a timestamp was recorded.
+     */
+    static bool isSet(const Clock::time_point& point);
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    /**
+     * OpenSSL info callback recording the handshake start and end.
+     */
+    static void onTlsInfo(const SSL* ssl, int where, int ret);
+
+    /**
+     * Gets the SSL_CTX ex-data slot holding the active timer.
+     */
+    static int getTlsDataIndex();
+#endif
+};
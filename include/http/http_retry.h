@@ -0,0 +1,119 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <httplib.h>
+
+/**
+ * @brief Rate limit state reported by the headers of one response.
+ *
+ * Values the response does not carry are -1. Remaining counts and resets are
+ * taken from x-ratelimit-remaining-{requests,tokens} and
+ * x-ratelimit-reset-{requests,tokens} (Groq, OpenAI); OpenRouter's
+ * x-ratelimit-remaining / x-ratelimit-reset count as requests.
+ */
+struct HttpRateLimit {
+    int status = 0;
+    double remainingRequests = -1.0;
+    double remainingTokens = -1.0;
+    double resetRequestsMs = -1.0;      // Until the request limit is replenished
+    double resetTokensMs = -1.0;        // Until the token limit is replenished
+    double retryAfterMs = -1.0;         // Delay asked for by a 429/503 response
+
+    /**
+     * Checks if the response said anything about rate limits.
+     * @return True if no value was reported
+     */
+    bool isEmpty() const {
+        return remainingRequests < 0 && remainingTokens < 0 && retryAfterMs < 0 && status != 429;
+    }
+};
+
+/**
+ * @brief When and how often HttpClient repeats a failed request.
+ */
+struct RetryPolicy {
+    int maxAttempts = 3;            // Including the first; 1 disables retrying
+    int baseBackoffMs = 500;        // Upper bound of the first backoff
+    int maxBackoffMs = 30000;       // Cap of every backoff; a longer Retry-After gives up
+
+    // Set by the sender to keep a shared rate limit (see RateLimiter::attach); empty does nothing
+    std::function<void()> beforeRetry;                      // Runs before each repeated attempt
+    std::function<void(const HttpRateLimit&)> onRateLimit;  // Receives the rate limit headers of each response
+
+    /**
+     * Checks if a failed request may be repeated at all.
+     * @return True if more than one attempt is allowed
+     */
+    bool isEnabled() const { return maxAttempts > 1; }
+};
+
+/**
+ * @brief Retry decisions for HttpClient.
+ *
+ * Only failures that are safe to repeat for a POST are retried: the
+ * connection could not be opened (the request never reached the server),
+ * 429 Too Many Requests, 502 Bad Gateway and 503 Service Unavailable.
+ * Timeouts after the request was sent and other errors are not, since the
+ * server may already be generating (and billing) the completion.
+ *
+ * The wait before attempt n+1 is the delay the server asked for, if any
+ * (Retry-After, retry-after-ms, or the x-ratelimit-reset-* header of the
+ * exhausted limit on a 429), otherwise "full jitter": a uniformly random
+ * delay between 0 and min(maxBackoffMs, baseBackoffMs * 2^(n-1)), which
+ * keeps concurrent clients from retrying in lockstep. A server delay above
+ * maxBackoffMs ends the retries, so the caller can fail over instead.
+ */
+class HttpRetry {
+public:
+    /**
+     * Checks if a request may be repeated after this result.
+     * @param response The result of the failed attempt
+     * @return True for connection failures, 429, 502 and 503
+     */
+    static bool isRetryable(const httplib::Result& response);
+
+    /**
+     * Gets the delay the server asked for before the next request.
+     * @param response The response of the failed attempt
+     * @return The delay in milliseconds, or -1 if the headers name none
+     */
+    static double getServerDelayMs(const httplib::Response& response);
+
+    /**
+     * Reads the rate limit headers of a response.
+     * @param response The response
+     * @return The reported rate limit state
+     */
+    static HttpRateLimit getRateLimit(const httplib::Response& response);
+
+    /**
+     * Gets the wait before the next attempt.
+     * @param policy The retry policy
+     * @param attempt The attempt that just failed (1-based)
+     * @param serverDelayMs The delay the server asked for, or -1
+     * @return The delay in milliseconds, or -1 to give up
+     */
+    static double getDelayMs(const RetryPolicy& policy, int attempt, double serverDelayMs);
+
+    /**
+     * Parses a rate limit reset duration such as "6s", "120ms" or "2m59.56s".
+     * @param value The header value
+     * @return The duration in milliseconds, or -1 if malformed
+     */
+    static double parseDurationMs(const std::string& value);
+
+private:
+    /**
+     * Parses a Retry-After value: delay seconds or an HTTP date.
+     * @return The delay in milliseconds, or -1 if malformed
+     */
+    static double parseRetryAfterMs(const std::string& value);
+
+    /**
+     * Parses an x-ratelimit-reset value: a duration, or an epoch timestamp
+     * in seconds or milliseconds (OpenRouter).
+     * @return The delay in milliseconds, or -1 if malformed
+     */
+    static double parseResetMs(const std::string& value);
+};
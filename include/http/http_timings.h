@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Timing breakdown of a single HTTP request.
+ *
+ * Each phase is a duration in milliseconds; together they add up to totalMs.
+ * Phases that did not happen are 0: on a reused keep-alive connection there
+ * is no DNS lookup, TCP connect or TLS handshake, and requests without a body
+ * (GET) count the request write as part of the time to first byte.
+ *
+ * A retried request reports the phases of its last attempt, plus the number
+ * of attempts, the time spent waiting between them, and how long after the
+ * first attempt the last one started.
+ */
+struct HttpTimings {
+    double dnsMs = 0.0;             ///< Host name resolution
+    double connectMs = 0.0;         ///< TCP connect
+    double tlsMs = 0.0;             ///< TLS handshake
+    double requestWriteMs = 0.0;    ///< Sending the request headers and body
+    double firstByteMs = 0.0;       ///< Waiting for the response headers after the request was sent
+    double transferMs = 0.0;        ///< Receiving the response body
+    double totalMs = 0.0;           ///< Whole request
+    size_t bytesSent = 0;           ///< Request body bytes
+    size_t bytesReceived = 0;       ///< Response body bytes
+    bool connectionReused = false;  ///< Sent on an already open keep-alive connection
+    int attempts = 1;               ///< Attempts made, including retries
+    double backoffMs = 0.0;         ///< Waiting between attempts (not part of totalMs)
+    double retriedMs = 0.0;         ///< Earlier attempts and backoff, before the last attempt started
+
+    /**
+     * Gets the time spent setting up the connection.
+     * @return DNS + connect + TLS time in milliseconds
+     */
+    double setupMs() const { return dnsMs + connectMs + tlsMs; }
+};
@@ -0,0 +1,150 @@
+#ifndef STREAMING_MARKDOWN_RENDERER_H
+#define STREAMING_MARKDOWN_RENDERER_H
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include "markdown/terminal_markdown_renderer.h"
+
+/**
+ * @brief Incremental markdown renderer for streamed responses.
+ *
+ * Markdown arrives in arbitrary chunks while a response is being generated.
+ * Re-rendering the whole document on every chunk would be quadratic, so the
+ * input is split into two parts:
+ *
+ * - Committed blocks: complete top-level blocks (a paragraph followed by a
+ *   blank line, a closed code fence, a heading, ...). Each one is rendered
+ *   exactly once and written to the terminal for good.
+ * - The tail: the trailing block that is still being filled (an open
+ *   paragraph, list, code fence or table). Only this part is re-parsed, and
+ *   on a terminal it is redrawn in place as new text arrives.
+ *
+ * Blocks are only committed at top-level boundaries, where all RenderState
+ * nesting (lists, blockquotes, tables) has been closed. Rendering each
+ * committed segment with a fresh RenderState therefore gives the same result
+ * as rendering the complete document in one pass, and the BlockHandlerFactory
+ * handlers see exactly the same block sequence.
+ *
+ * When the output is not a terminal, the tail is not drawn at all; each block
+ * is written once it is committed and the rest is written by flush().
+ */
+class StreamingMarkdownRenderer {
+public:
+    /**
+     * @brief Creates a streaming renderer writing to the given stream.
+     * @param out The stream to write rendered output to
+     * @param redrawTail Whether to draw the open tail block in place (requires a terminal)
+     */
+    StreamingMarkdownRenderer(std::ostream& out, bool redrawTail);
+
+    /**
+     * @brief Creates a streaming renderer writing to stdout.
+     * The tail is redrawn in place only when stdout is a terminal.
+     */
+    StreamingMarkdownRenderer();
+
+    /**
+     * @brief Feeds the next chunk of markdown.
+     * Commits any blocks completed by this chunk and refreshes the tail.
+     * @param chunk The markdown text to append
+     */
+    void feed(const std::string& chunk);
+
+    /**
+     * @brief Renders everything that has not been committed yet.
+     * Call once after the last chunk; the renderer is empty afterwards.
+     */
+    void flush();
+
+    /**
+     * @brief Configure word wrapping settings
+     * @param enabled Whether to enable word wrapping
+     */
+    void setWordWrappingEnabled(bool enabled) { renderer_.setWordWrappingEnabled(enabled); }
+
+    /**
+     * @brief Set custom terminal width for word wrapping
+     * @param width Terminal width in characters (0 for auto-detection)
+     */
+    void setCustomTerminalWidth(size_t width) { renderer_.setCustomTerminalWidth(width); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Minimum time between two redraws of the tail
+    static constexpr int REDRAW_INTERVAL_MS = 50;
+
+    TerminalMarkdownRenderer renderer_;
+    std::ostream& out_;
+    bool redrawTail_;
+
+    std::string pending_;        // Markdown not yet committed
+    size_t scanPos_;             // Start of the first line in pending_ not yet scanned
+    bool afterBlankLine_;        // Last scanned line was blank
+    bool inFence_;               // Inside a fenced code block
+    bool fenceAtTopLevel_;       // The open fence started at column 0
+    char fenceChar_;             // '`' or '~' of the open fence
+    size_t fenceLength_;         // Length of the open fence marker
+
+    size_t tailRows_;            // Terminal rows currently occupied by the drawn tail
+    bool tailTooTall_;           // Tail no longer fits on screen; stop redrawing it
+    Clock::time_point lastRedraw_;
+
+    /**
+     * @brief Scans newly completed lines for the last safe commit position.
+     * @return Offset in pending_ up to which all blocks are complete (0 if none)
+     */
+    size_t findCommitBoundary();
+
+    /**
+     * @brief Renders and writes the first length bytes of pending_ for good.
+     * @param length Number of bytes to commit
+     */
+    void commit(size_t length);
+
+    /**
+     * @brief Re-renders the tail and draws it in place of the previous one.
+     */
+    void redrawTail();
+
+    /**
+     * @brief Erases the previously drawn tail from the terminal.
+     */
+    void clearTail();
+
+    /**
+     * @brief Counts the terminal rows a rendered text occupies.
+     * @param rendered The rendered text (may contain ANSI sequences)
+     * @return Number of rows occupied, including wrapped lines
+     */
+    size_t countRows(const std::string& rendered) const;
+
+    /**
+     * @brief Gets the terminal width and height.
+     * @param width Receives the width in columns
+     * @param height Receives the height in rows
+     */
+    void getTerminalSize(size_t& width, size_t& height) const;
+
+    // Line classification helpers for the block boundary scan
+    static bool isBlankLine(const std::string& text, size_t start, size_t end);
+    static bool isListMarkerLine(const std::string& text, size_t start, size_t end);
+    static bool isAtxHeadingLine(const std::string& text, size_t start, size_t end);
+    static size_t countIndent(const std::string& text, size_t start, size_t end);
+
+    /**
+     * @brief Parses a code fence marker (``` or ~~~) indented by at most 3 spaces.
+     * @param text The text containing the line
+     * @param start Start of the line
+     * @param end End of the line (exclusive)
+     * @param fenceChar Receives the fence character
+     * @param fenceLength Receives the length of the marker
+     * @param infoStart Receives the position after the marker
+     * @return True if the line starts with a fence marker
+     */
+    static bool parseFence(const std::string& text, size_t start, size_t end,
+                           char& fenceChar, size_t& fenceLength, size_t& infoStart);
+};
+
+#endif // STREAMING_MARKDOWN_RENDERER_H
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Process-wide request metrics in the Prometheus text format.
+ *
+ * Collected series:
+ * - aith_http_requests_total{host,method,status}: every HTTP attempt, status
+ *   "error" when no response arrived
+ * - aith_http_request_duration_seconds{host}: histogram of those attempts
+ * - aith_http_sent_bytes_total / aith_http_received_bytes_total{host}
+ * - aith_http_connections_total{host,reused}: pooled connection use; the
+ *   reuse ratio is also exported as a gauge
+ * - aith_http_requests_in_flight{host}
+ * - aith_model_requests_total{source,provider,model,result}: chat, benchmark
+ *   and proxy requests per target; result is "ok", the error class, or
+ *   "cancelled" when the client went away
+ * - aith_model_request_duration_seconds{source,provider,model}: histogram
+ * - aith_model_requests_in_flight{source}
+ * - aith_response_cache_lookups_total{result}, plus the hit ratio
+ *
+ * Recording never takes a lock: every thread writes only its own shard of
+ * counters (relaxed atomic stores), and render() sums the shards. A thread
+ * that exits hands its shard to the next new thread, so totals are kept and
+ * short-lived worker threads do not grow memory.
+ */
+class Metrics {
+public:
+    /**
+     * @brief Times one model request and counts it in flight until destroyed.
+     *
+     * The outcome is recorded when the object goes away: "ok" after
+     * succeed(), the given class after fail(), "unknown" otherwise.
+     */
+    class ModelRequest {
+    public:
+        /**
+         * Starts a request.
+         * @param source What sent it: "chat", "benchmark" or "proxy"
+         * @param provider The provider name
+         * @param model The model name
+         */
+        ModelRequest(const std::string& source, const std::string& provider, const std::string& model);
+        ~ModelRequest();
+
+        ModelRequest(const ModelRequest&) = delete;
+        ModelRequest& operator=(const ModelRequest&) = delete;
+
+        /**
+         * Marks the request as answered.
+         */
+        void succeed() { result_ = "ok"; }
+
+        /**
+         * Marks the request as failed.
+         * @param errorClass The error class label, see ErrorClassifier::toLabel
+         */
+        void fail(const char* errorClass) { result_ = errorClass; }
+
+    private:
+        std::string source_;
+        std::string provider_;
+        std::string model_;
+        const char* result_ = "unknown";
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Counts an HTTP request in flight until destroyed.
+     */
+    class HttpInFlight {
+    public:
+        explicit HttpInFlight(const std::string& host);
+        ~HttpInFlight();
+
+        HttpInFlight(const HttpInFlight&) = delete;
+        HttpInFlight& operator=(const HttpInFlight&) = delete;
+
+    private:
+        std::string host_;
+    };
+
+    /**
+     * Records one HTTP attempt.
+     * @param host The server's base URL
+     * @param method The HTTP method
+     * @param status The response status, or 0 if none arrived
+     * @param seconds Time until the response was complete or the attempt failed
+     * @param bytesSent Request body bytes
+     * @param bytesReceived Response body bytes
+     */
+    static void recordHttpRequest(const std::string& host, const std::string& method, int status,
+                                  double seconds, size_t bytesSent, size_t bytesReceived);
+
+    /**
+     * Adds streamed response bytes, which recordHttpRequest cannot see.
+     * @param host The server's base URL
+     * @param bytes Bytes received
+     */
+    static void recordHttpReceived(const std::string& host, size_t bytes);
+
+    /**
+     * Records that a request was sent on a new or a reused pooled connection.
+     * @param host The server's base URL
+     * @param reused True for a kept-alive connection
+     */
+    static void recordConnection(const std::string& host, bool reused);
+
+    /**
+     * Records a completed model request without a ModelRequest scope.
+     * @param source What sent it
+     * @param provider The provider name
+     * @param model The model name
+     * @param seconds Request duration
+     * @param result "ok" or the error class label
+     */
+    static void recordModelRequest(const std::string& source, const std::string& provider,
+                                   const std::string& model, double seconds, const char* result);
+
+    /**
+     * Records a response cache lookup.
+     * @param hit True if the reply came from the cache
+     */
+    static void recordCacheLookup(bool hit);
+
+    /**
+     * Renders all series in the Prometheus text exposition format.
+     * @return The metrics page
+     */
+    static std::string render();
+
+    /**
+     * Rewrites a file with render() periodically, on a background thread.
+     * Does nothing if an export is already running.
+     * @param path The file to write (replaced atomically)
+     * @param intervalSeconds Seconds between writes
+     */
+    static void startFileExport(const std::string& path, int intervalSeconds);
+
+    /**
+     * Stops the file export after writing the final values.
+     */
+    static void stopFileExport();
+
+    /**
+     * Writes render() to a file through a temporary file and a rename.
+     * @param path The file to write
+     * @return False if the file cannot be written
+     */
+    static bool writeFile(const std::string& path);
+
+    /**
+     * Zeroes every series. A forked process calls this first, so that its
+     * snapshot() holds only the requests it made itself.
+     */
+    static void reset();
+
+    /**
+     * Serializes the counters and histograms recorded so far, for merge() in
+     * another process. Gauges are left out; they are back at zero when a
+     * command has finished.
+     * @return The series as JSON text
+     */
+    static std::string snapshot();
+
+    /**
+     * Adds the series of another process's snapshot() to this thread's shard.
+     * @param snapshot The serialized series
+     * @return False if the snapshot cannot be parsed
+     */
+    static bool merge(const std::string& snapshot);
+
+    static const int DEFAULT_EXPORT_INTERVAL_SECONDS;
+};
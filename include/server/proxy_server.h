@@ -0,0 +1,171 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <httplib.h>
+#include <json/json.h>
+#include "model_target.h"
+
+/**
+ * @brief Settings of the local proxy server.
+ */
+struct ProxyOptions {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    int threads = 8;            // Requests handled at the same time
+    int maxPerClient = 4;       // Requests in flight per client; more get 429
+    std::string token;          // Bearer token every request must carry; empty for none
+};
+
+/**
+ * @brief Local OpenAI-compatible gateway in front of the configured providers.
+ *
+ * Other tools point their OpenAI client at http://HOST:PORT/v1 and get
+ * aith's provider config, failover chain, blacklist, rate limits, retries
+ * and response cache without knowing any provider key:
+ * - POST /v1/chat/completions: the "model" is "provider:model" or a model of
+ *   the default provider. The request body is forwarded as is (apart from
+ *   the model) on HttpClient's pooled connections. Streamed requests are
+ *   passed through chunk by chunk; an error after the stream has started is
+ *   sent as a final "data: {"error": ...}" event.
+ * - GET /v1/models: the model catalog of the default provider, or of
+ *   ?provider=NAME, without blacklisted models.
+ * - GET /metrics: request metrics in the Prometheus text format (see Metrics).
+ *
+ * With options.token set, every request must carry it as its bearer token
+ * and is answered with 401 otherwise; a server on a non-loopback address
+ * must have one, since it spends the provider keys on behalf of its clients.
+ *
+ * Requests run on a pool of options.threads workers. A client is identified
+ * by its address; requests beyond options.maxPerClient in flight are
+ * answered with 429 and Retry-After.
+ * Buffered answers carry X-Aith-Provider and X-Aith-Model headers naming the
+ * target that replied; streamed ones name the first target, as the headers
+ * are sent before any failover.
+ */
+class ProxyServer {
+public:
+    /**
+     * Creates a server; nothing listens until run() is called.
+     * @param options Address, worker threads and per-client limit
+     */
+    explicit ProxyServer(const ProxyOptions& options);
+
+    /**
+     * Listens and serves requests until the process ends.
+     * @return False if the address cannot be bound
+     */
+    bool run();
+
+    /**
+     * Checks if a host name or address only accepts local connections.
+     * @param host The listen host
+     * @return True for localhost, 127.0.0.0/8 and ::1
+     */
+    static bool isLoopback(const std::string& host);
+
+private:
+    /**
+     * @brief One request in flight for a client; released when destroyed.
+     */
+    class ClientSlot;
+
+    /**
+     * Reserves a request slot for a client.
+     * @param clientId The client's identity
+     * @return The slot, or nullptr if the client is at its limit
+     */
+    std::shared_ptr<ClientSlot> acquireSlot(const std::string& clientId);
+
+    /**
+     * Handles POST /v1/chat/completions.
+     */
+    void handleChatCompletions(const httplib::Request& request, httplib::Response& response);
+
+    /**
+     * Handles GET /v1/models.
+     */
+    void handleModels(const httplib::Request& request, httplib::Response& response);
+
+    /**
+     * Sends a buffered request along the failover chain and answers with the first reply.
+     * @param chain The targets to try, in order
+     * @param payload The client's request body
+     * @param cacheKey Response cache key, or empty if caching is off
+     * @param response Receives the reply or the last error
+     */
+    static void forwardBuffered(const std::vector<ModelTarget>& chain, const Json::Value& payload,
+                                const std::string& cacheKey, httplib::Response& response);
+
+    /**
+     * Streams a request along the failover chain into the client's connection.
+     * @param chain The targets to try, in order
+     * @param payload The client's request body
+     * @param cacheKey Response cache key, or empty if caching is off
+     * @param sink The client's connection
+     */
+    static void forwardStreamed(const std::vector<ModelTarget>& chain, const Json::Value& payload,
+                                const std::string& cacheKey, httplib::DataSink& sink);
+
+    /**
+     * Finds the provider and model a request names.
+     * @param model "provider:model", or a model id of the default provider
+     * @return The target
+     * @throws std::invalid_argument if no model is given or configured
+     */
+    static ModelTarget resolveTarget(const std::string& model);
+
+    /**
+     * Checks a request's bearer token against options.token.
+     * @param request The client's request
+     * @return True if no token is configured or the request carries it
+     */
+    bool isAuthorized(const httplib::Request& request) const;
+
+    /**
+     * Gets the identity a per-client limit applies to. The Authorization
+     * header is not used: the client chooses it freely.
+     * @param request The client's request
+     * @return The remote address
+     */
+    static std::string getClientId(const httplib::Request& request);
+
+    /**
+     * Builds an OpenAI-style error body.
+     * @param message The error message
+     * @param type The error type, e.g. "invalid_request_error"
+     * @return The error object
+     */
+    static Json::Value makeError(const std::string& message, const std::string& type);
+
+    /**
+     * Answers a request with an OpenAI-style error.
+     * @param response The response to fill
+     * @param status The HTTP status
+     * @param message The error message
+     * @param type The error type
+     */
+    static void sendError(httplib::Response& response, int status, const std::string& message,
+                          const std::string& type);
+
+    /**
+     * Builds a chat completion object around cached content.
+     * @param model The model the content came from
+     * @param content The assistant message
+     * @return The completion object
+     */
+    static Json::Value makeCompletion(const std::string& model, const std::string& content);
+
+    /**
+     * Serializes JSON compactly.
+     */
+    static std::string toJson(const Json::Value& value);
+
+    ProxyOptions options_;
+    httplib::Server server_;
+    std::mutex clientsMutex_;
+    std::map<std::string, int> activeRequests_;     // Client id -> requests in flight
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+/**
+ * @brief Byte-level BPE tokenizer using a local vocabulary file.
+ *
+ * Vocabularies use the tiktoken format: one "<base64 token bytes> <rank>"
+ * pair per line (e.g. cl100k_base.tiktoken, o200k_base.tiktoken). The rank
+ * of a token is also its id and its merge priority.
+ *
+ * Text is first split into pieces (contractions, letter runs with an optional
+ * leading character, runs of up to three digits, punctuation runs and
+ * whitespace), approximating the cl100k pre-tokenizer byte by byte: every
+ * byte of a multi-byte UTF-8 sequence counts as a letter. Each piece is then
+ * looked up as a whole, which resolves most words with a single hash lookup,
+ * and only otherwise merged pair by pair, lowest rank first.
+ *
+ * Token bytes are stored in one contiguous buffer and the rank table is keyed
+ * by string_view into it, so lookups never allocate.
+ *
+ * Instances are immutable after loading and can be shared between threads.
+ */
+class BpeTokenizer {
+public:
+    /**
+     * Loads a vocabulary file.
+     * @param path Path to a tiktoken-format vocabulary file
+     * @return The tokenizer, named after the file (without extension)
+     * @throws std::runtime_error if the file cannot be read or contains no tokens
+     */
+    static std::shared_ptr<const BpeTokenizer> load(const std::string& path);
+
+    /**
+     * Encodes text into token ids.
+     * @param text The text to encode
+     * @return The token ids
+     */
+    std::vector<uint32_t> encode(std::string_view text) const;
+
+    /**
+     * Counts the tokens of a text without building the id list.
+     * @param text The text to count
+     * @return The number of tokens
+     */
+    size_t count(std::string_view text) const;
+
+    /**
+     * Gets the vocabulary name.
+     * @return The file name without directory and extension
+     */
+    const std::string& getName() const;
+
+    /**
+     * Gets the number of tokens in the vocabulary.
+     * @return The vocabulary size
+     */
+    size_t getVocabularySize() const;
+
+private:
+    static constexpr uint32_t NO_RANK = UINT32_MAX;
+
+    std::string name_;
+    std::string tokenBytes_;    // All token byte sequences, back to back
+    std::unordered_map<std::string_view, uint32_t> ranks_;
+
+    BpeTokenizer() = default;
+
+    /**
+     * Splits text into the pieces that are encoded independently.
+     * @param text The text to split
+     * @param onPiece Called with each piece in order
+     */
+    template<typename Callback>
+    static void splitPieces(std::string_view text, Callback&& onPiece);
+
+    /**
+     * Merges a piece and reports the boundaries of its tokens.
+     * @param piece The piece to merge
+     * @param boundaries Receives the start offset of every token plus the piece length
+     */
+    void mergePiece(std::string_view piece, std::vector<size_t>& boundaries) const;
+
+    /**
+     * Looks up the rank of a byte sequence.
+     * @param bytes The bytes to look up
+     * @return The rank, or NO_RANK if the sequence is not a token
+     */
+    uint32_t rankOf(std::string_view bytes) const;
+
+    /**
+     * Decodes one base64 field of a vocabulary line.
+     * @param encoded The base64 text
+     * @param decoded Receives the decoded bytes
+     * @return False if the text is not valid base64
+     */
+    static bool decodeBase64(std::string_view encoded, std::string& decoded);
+};
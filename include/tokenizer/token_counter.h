@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+#include <json/json.h>
+#include "bpe_tokenizer.h"
+
+/**
+ * @brief Token counting for a provider and model, offline.
+ *
+ * Selects the BPE vocabulary configured with TOKENIZER (provider config
+ * KEY@model, provider config, then main config). The value is either a
+ * vocabulary name, looked up as ~/.config/aith/tokenizers/<name>.tiktoken,
+ * or a path to a vocabulary file. Without a setting, cl100k_base is used if
+ * its file is installed.
+ *
+ * Loaded vocabularies are kept for the lifetime of the process. When no
+ * vocabulary is available the count falls back to an estimate of one token
+ * per CHARS_PER_ESTIMATED_TOKEN characters. Counting never makes a network
+ * request.
+ *
+ * All methods are thread-safe.
+ */
+class TokenCounter {
+public:
+    static const std::string DEFAULT_VOCABULARY;
+    static const size_t CHARS_PER_ESTIMATED_TOKEN;
+
+    // Tokens a chat message costs beyond its content (role and separators)
+    static const size_t MESSAGE_OVERHEAD_TOKENS;
+
+    /**
+     * Gets the tokenizer for a provider and model.
+     * @param provider The provider name
+     * @param model The model name
+     * @return The tokenizer, or nullptr if no vocabulary is configured or installed
+     */
+    static std::shared_ptr<const BpeTokenizer> forModel(const std::string& provider, const std::string& model);
+
+    /**
+     * Gets a tokenizer by vocabulary name or path.
+     * @param nameOrPath Vocabulary name or path to a vocabulary file
+     * @return The tokenizer (cached after the first load)
+     * @throws std::runtime_error if the vocabulary cannot be loaded
+     */
+    static std::shared_ptr<const BpeTokenizer> byName(const std::string& nameOrPath);
+
+    /**
+     * Counts the tokens of a text.
+     * @param text The text to count
+     * @param tokenizer The tokenizer (nullptr to estimate)
+     * @return The token count
+     */
+    static size_t count(std::string_view text, const BpeTokenizer* tokenizer);
+
+    /**
+     * Counts the tokens of a chat message, including its framing.
+     * @param message The message object with a "content" string
+     * @param tokenizer The tokenizer (nullptr to estimate)
+     * @return The token count
+     */
+    static size_t countMessage(const Json::Value& message, const BpeTokenizer* tokenizer);
+
+    /**
+     * Estimates the tokens of a text from its length.
+     * @param text The text to estimate
+     * @return The estimated token count
+     */
+    static size_t estimate(std::string_view text);
+
+    /**
+     * Gets the directory holding vocabulary files.
+     * @return Path to the tokenizer directory
+     */
+    static std::string getVocabularyDir();
+
+private:
+    /**
+     * Resolves a vocabulary name to a file path.
+     * Values containing a '/' are used as paths.
+     */
+    static std::string resolvePath(const std::string& nameOrPath);
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scoped timing spans written as a Chrome/Perfetto trace.
+ *
+ * Code marks regions with TRACE_SCOPE("Name"); a span covers the rest of
+ * the enclosing block. The macro compiles to nothing unless the build is
+ * configured with -DAITH_TRACING=ON, so release builds carry no cost.
+ *
+ * In a tracing build, `--trace out.json` calls start(); spans are then
+ * buffered per thread and finish() writes them as "complete" events with
+ * the process and thread ids. Open the file in ui.perfetto.dev or
+ * chrome://tracing; spans on the same thread nest by time.
+ */
+class Trace {
+public:
+    /**
+     * @brief Records the time between its construction and destruction.
+     */
+    class Span {
+    public:
+        /**
+         * Starts a span if tracing is running.
+         * @param name The span name; must outlive the trace (a string literal)
+         */
+        explicit Span(const char* name) : name_(name), startUs_(isEnabled() ? now() : -1) {}
+
+        ~Span() {
+            if (startUs_ >= 0) {
+                record(name_, startUs_, now());
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name_;
+        int64_t startUs_;
+    };
+
+    /**
+     * Checks if this build was compiled with trace spans.
+     * @return True if built with AITH_TRACING
+     */
+    static bool isAvailable();
+
+    /**
+     * Starts recording spans; the calling thread is named "main".
+     * @param path The trace file finish() writes
+     */
+    static void start(const std::string& path);
+
+    /**
+     * Checks if spans are being recorded.
+     */
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Stops recording and writes the trace file, if start() was called.
+     * @return False if the file cannot be written
+     */
+    static bool finish();
+
+private:
+    /**
+     * Gets the current time in microseconds.
+     */
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Adds a finished span to the calling thread's buffer.
+     */
+    static void record(const char* name, int64_t startUs, int64_t endUs);
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+#ifdef AITH_TRACING
+#define AITH_TRACE_CONCAT_INNER(a, b) a##b
+#define AITH_TRACE_CONCAT(a, b) AITH_TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Span AITH_TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) do { } while (false)
+#endif
@@ -2,6 +2,7 @@
 #define CONFIG_FILE_HANDLER_H
 
 #include <string>
+#include <map>
 
 /**
  * @brief Configuration file operations utility class
@@ -24,6 +25,14 @@ public:
      */
     static std::string readValue(const std::string& configPath, const std::string& key);
     
+    /**
+     * Reads every key-value pair of a config file
+     * @param configPath Path to the config file
+     * @return Values by key; for repeated keys the first one, as readValue returns
+     * @throws std::runtime_error if config file cannot be read
+     */
+    static std::map<std::string, std::string> readAll(const std::string& configPath);
+    
     /**
      * Writes a key-value pair to a config file
      * @param configPath Path to the config file
@@ -33,6 +42,17 @@ public:
      */
     static void writeValue(const std::string& configPath, const std::string& key, 
                           const std::string& value);
+
+private:
+    /**
+     * Splits a config line into its trimmed key and value
+     * A trailing "# comment" after whitespace is removed from the value.
+     * @param line The line to parse
+     * @param key Receives the key
+     * @param value Receives the value
+     * @return False for blank lines, comment lines and lines without '='
+     */
+    static bool parseLine(const std::string& line, std::string& key, std::string& value);
 };
 
 #endif // CONFIG_FILE_HANDLER_H
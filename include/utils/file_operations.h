@@ -1,6 +1,7 @@
 #ifndef FILE_OPERATIONS_H
 #define FILE_OPERATIONS_H
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -98,6 +99,24 @@ public:
      */
     static bool copy(const std::string& sourcePath, const std::string& destPath);
     
+    /**
+     * Builds a temporary path next to a file, unique per process and per call,
+     * for writing the file atomically (write the temporary file, then rename)
+     * @param filePath Path of the file to be replaced
+     * @return The temporary path
+     */
+    static std::string makeTempPath(const std::string& filePath);
+    
+    /**
+     * Rewrites a small file under an exclusive lock (flock), so concurrent
+     * processes updating it never lose each other's changes
+     * @param filePath Path to the file; created empty if missing
+     * @param update Receives the current content and returns the new one
+     * @return True if the new content was written, false otherwise
+     */
+    static bool updateLocked(const std::string& filePath,
+                             const std::function<std::string(const std::string&)>& update);
+    
     // File metadata
     /**
      * Gets the size of a file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief Keeps the parsed form of files and parses a file again only when it changes.
+ *
+ * A file counts as changed when its modification time or size differs from
+ * when it was parsed, so every lookup costs a stat() instead of a parse. A
+ * long-running process (aithd, aith serve, the REPL) picks up edits without
+ * restarting. A failed parse is remembered as well, until the file changes.
+ *
+ * All methods are thread-safe.
+ *
+ * @tparam T The parsed content
+ */
+template <typename T>
+class ParsedFileCache {
+public:
+    /**
+     * @brief Parses a file into a default-constructed T; returns false if the file is unusable.
+     */
+    using Parser = std::function<bool(const std::string& path, T& content)>;
+
+    /**
+     * Gets the parsed content of a file, parsing it if it is new or changed.
+     * @param path The file
+     * @param parse Parses the file
+     * @return The content, or nullptr if the file is missing or could not be parsed
+     */
+    std::shared_ptr<const T> get(const std::string& path, const Parser& parse) {
+        std::error_code error;
+        std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+        std::uintmax_t size = error ? 0 : std::filesystem::file_size(path, error);
+        if (error) {
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = files_.find(path);
+            if (it != files_.end() && it->second.modified == modified && it->second.size == size) {
+                return it->second.content;
+            }
+        }
+
+        // Parsed without the lock; threads racing on a changed file store equal results
+        auto content = std::make_shared<T>();
+        std::shared_ptr<const T> parsed;
+        if (parse(path, *content)) {
+            parsed = std::move(content);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        files_[path] = Entry{modified, size, parsed};
+        return parsed;
+    }
+
+private:
+    /**
+     * @brief A file as parsed, with the state it was parsed at.
+     */
+    struct Entry {
+        std::filesystem::file_time_type modified;
+        std::uintmax_t size;
+        std::shared_ptr<const T> content;
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Entry> files_;
+};
@@ -1,6 +1,8 @@
 #include "api_helpers.h"
 #include "blacklist_manager.h"
+#include <iomanip>
 #include <iostream>
+#include <ctime>
 
 /**
  * Validates that the provider configuration is complete for model listing.
@@ -49,10 +51,24 @@ void ApiConsole::displayChatStatus(const std::string& provider, const std::strin
 }
 
 /**
- * Displays a progress message for model fetching.
+ * Displays where a model list came from.
  */
-void ApiConsole::displayModelsFetchStatus(const std::string& provider) {
-    std::cout << "Fetching models from " << provider << " API..." << std::endl;
+void ApiConsole::displayModelCatalogStatus(const std::string& provider, const ModelCatalogResult& catalog) {
+    switch (catalog.source) {
+        case ModelCatalogSource::Network:
+            std::cout << "Fetched models from " << provider << " API" << std::endl;
+            break;
+        case ModelCatalogSource::Revalidated:
+            std::cout << "Model list of " << provider << " API is unchanged" << std::endl;
+            break;
+        case ModelCatalogSource::Cache:
+        case ModelCatalogSource::StaleCache: {
+            long ageMinutes = static_cast<long>(std::time(nullptr) - catalog.fetchedAt) / 60;
+            std::cout << "Using cached models (updated " << ageMinutes
+                      << " min ago, --refresh to update)" << std::endl;
+            break;
+        }
+    }
 }
 
 /**
@@ -62,6 +78,91 @@ void ApiConsole::displayChatRequestStatus(const std::string& provider, const std
     std::cout << "Sending request to " << provider << " using model " << model << "..." << std::endl << std::endl << std::flush;
 }
 
+/**
+ * Displays that the outgoing conversation was trimmed to the token budget.
+ */
+void ApiConsole::displayContextTrimmed(size_t sentMessages, size_t totalMessages, size_t tokenBudget) {
+    std::cout << "Context: sending " << sentMessages << " of " << totalMessages
+              << " messages (budget ~" << tokenBudget << " tokens)" << std::endl;
+}
+
+/**
+ * Displays that a chat reply was answered from the response cache.
+ */
+void ApiConsole::displayCachedResponseStatus(const std::string& provider, const std::string& model,
+                                             const ResponseCacheStats& stats) {
+    std::cout << "Cached response from " << provider << " using model " << model
+              << " (cache: " << stats.hits << " hits, " << stats.misses << " misses)"
+              << std::endl << std::endl << std::flush;
+}
+
+/**
+ * Displays the contenders of a race before it starts.
+ */
+void ApiConsole::displayRaceStart(const std::vector<ModelTarget>& contenders) {
+    std::cout << "Racing " << contenders.size() << " contenders:";
+    for (const ModelTarget& contender : contenders) {
+        std::cout << " " << contender.getLabel();
+    }
+    std::cout << std::endl << std::endl << std::flush;
+}
+
+/**
+ * Displays the outcome and timing of every contender of a race.
+ */
+void ApiConsole::displayRaceResult(const RaceResult& result) {
+    std::cout << std::endl;
+    for (const RaceEntry& entry : result.entries) {
+        std::cout << std::fixed << std::setprecision(0)
+                  << (entry.outcome == RaceOutcome::Won ? "🏁 " : "   ")
+                  << entry.contender.getLabel() << ": " << ChatRace::toString(entry.outcome)
+                  << " after " << entry.elapsedMs << " ms";
+        if (entry.firstTokenMs >= 0) {
+            std::cout << " (first token " << entry.firstTokenMs << " ms)";
+        }
+        if (!entry.error.empty()) {
+            std::cout << " - " << entry.error;
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * Displays that a hedge was sent, who won and the running counters.
+ */
+void ApiConsole::displayHedgeResult(const HedgePolicy& policy, const HedgeOutcome& outcome, const HedgeStats& stats) {
+    std::cout << std::fixed << std::setprecision(0)
+              << "Hedge: no first byte after " << policy.delayMs << " ms";
+    if (policy.percentile > 0) {
+        std::cout << " (p" << std::defaultfloat << std::setprecision(3) << policy.percentile << ")"
+                  << std::fixed << std::setprecision(0);
+    }
+    std::cout << ", duplicated to " << policy.backupProvider << ":" << policy.backupModel << "; "
+              << (outcome.hedgeWon ? "hedge" : "original") << " won";
+    if (outcome.firstByteMs >= 0) {
+        std::cout << " with first byte at " << outcome.firstByteMs << " ms";
+    }
+    std::cout << " (hedges fired " << stats.fired << " of " << stats.requests
+              << " requests, won " << stats.won << ")" << std::endl;
+}
+
+/**
+ * Displays that a request failed and is sent to the next target of the chain.
+ */
+void ApiConsole::displayFailover(const ModelTarget& from, const ModelTarget& to, ErrorClass errorClass,
+                                 const std::string& errorMessage) {
+    std::cerr << "Failover: " << from.getLabel() << " failed (" << ErrorClassifier::toString(errorClass)
+              << ": " << errorMessage << "), trying " << to.getLabel() << std::endl;
+}
+
+/**
+ * Displays that a request waited for the provider's rate limit.
+ */
+void ApiConsole::displayRateLimitWait(const ModelTarget& target, double waitedMs) {
+    std::cerr << std::fixed << std::setprecision(0)
+              << "Rate limit: waited " << waitedMs << " ms for " << target.provider << std::endl;
+}
+
 /**
  * Displays an error message with optional response details.
  */
@@ -1,9 +1,26 @@
 #include "api_models.h"
 #include "blacklist_manager.h"
+#include "trace.h"
 #include <iostream>
 #include <sstream>
 #include <ctime>
 
+/**
+ * Reads the completion token count from a response or stream event.
+ * Groq reports streamed usage under "x_groq" instead of at the top level.
+ * @return The count, or -1 if the object has no usage block
+ */
+static int readCompletionTokens(const Json::Value& data) {
+    const Json::Value* usage = &data["usage"];
+    if (!usage->isObject() && data["x_groq"].isObject()) {
+        usage = &data["x_groq"]["usage"];
+    }
+    if (usage->isObject() && (*usage)["completion_tokens"].isIntegral()) {
+        return (*usage)["completion_tokens"].asInt();
+    }
+    return -1;
+}
+
 /**
  * Creates a formatted string representation of the model info.
  */
@@ -33,20 +50,48 @@ std::string ModelInfo::toString() const {
 /**
  * Constructs a chat request.
  */
-ChatRequest::ChatRequest(const std::string& modelName, const Json::Value& chatMessages)
-    : model(modelName), messages(chatMessages) {
+ChatRequest::ChatRequest(const std::string& modelName, Json::Value chatMessages)
+    : model(modelName), payload(Json::objectValue) {
+    payload["model"] = model;
+    payload["messages"] = std::move(chatMessages);
 }
 
 /**
- * Converts the request to a JSON payload.
+ * Gets the JSON payload of the request.
  */
-Json::Value ChatRequest::toJson() const {
-    Json::Value payload;
-    payload["model"] = model;
-    payload["messages"] = messages;
+const Json::Value& ChatRequest::toJson() const {
     return payload;
 }
 
+/**
+ * Requests a Server-Sent-Events streamed response.
+ */
+void ChatRequest::setStream(bool enabled) {
+    if (enabled) {
+        payload["stream"] = true;
+    } else {
+        payload.removeMember("stream");
+    }
+}
+
+/**
+ * Checks if a streamed response is requested.
+ */
+bool ChatRequest::isStream() const {
+    return payload.isMember("stream") && payload["stream"].asBool();
+}
+
+/**
+ * Asks the server to report token usage at the end of a streamed response.
+ */
+void ChatRequest::setIncludeUsage(bool enabled) {
+    if (enabled) {
+        payload["stream_options"]["include_usage"] = true;
+    } else {
+        payload.removeMember("stream_options");
+    }
+}
+
 /**
  * Gets the model name.
  */
@@ -58,7 +103,8 @@ const std::string& ChatRequest::getModel() const {
  * Constructs a chat response from API response string.
  */
 ChatResponse::ChatResponse(const std::string& jsonResponse) 
-    : isError(true), errorMessage("Failed to parse response") {
+    : isError(true), errorMessage("Failed to parse response"), completionTokens(-1) {
+    TRACE_SCOPE("ChatResponse::parse");
     
     Json::Value data;
     Json::CharReaderBuilder reader;
@@ -84,6 +130,7 @@ ChatResponse::ChatResponse(const std::string& jsonResponse)
     
     // Successfully parsed
     content = firstChoice["message"]["content"].asString();
+    completionTokens = readCompletionTokens(data);
     isError = false;
     errorMessage.clear();
 }
@@ -109,6 +156,244 @@ const std::string& ChatResponse::getContent() const {
     return content;
 }
 
+/**
+ * Gets the number of generated tokens reported in the "usage" block.
+ */
+int ChatResponse::getCompletionTokens() const {
+    return completionTokens;
+}
+
+/**
+ * Constructs a stream parser.
+ */
+ChatStreamParser::ChatStreamParser(DeltaCallback onDelta)
+    : onDelta(std::move(onDelta)), jsonReader(Json::CharReaderBuilder().newCharReader()),
+      isError(false), done(false), sawEvent(false), completionTokens(-1) {
+}
+
+/**
+ * Feeds a raw chunk of the response body.
+ * Complete lines are processed immediately; a partial line stays buffered
+ * until the rest of it arrives.
+ */
+bool ChatStreamParser::feed(const char* data, size_t length) {
+    TRACE_SCOPE("ChatStreamParser::feed");
+    if (isError) {
+        return false;
+    }
+    if (done) {
+        return true; // Anything after [DONE] is ignored
+    }
+    
+    rawResponse.append(data, length);
+    lineBuffer.append(data, length);
+    
+    size_t start = 0;
+    size_t newline;
+    while ((newline = lineBuffer.find('\n', start)) != std::string::npos) {
+        size_t end = newline;
+        if (end > start && lineBuffer[end - 1] == '\r') {
+            end--;
+        }
+        processLine(lineBuffer.substr(start, end - start));
+        start = newline + 1;
+        
+        if (done || isError) {
+            break;
+        }
+    }
+    lineBuffer.erase(0, start);
+    
+    // The raw response is only kept for error reporting once events are flowing
+    if (sawEvent && !isError) {
+        rawResponse.clear();
+    }
+    
+    return !isError;
+}
+
+/**
+ * Processes any buffered trailing data after the transfer ended.
+ */
+void ChatStreamParser::finish() {
+    if (done || isError) {
+        return;
+    }
+    
+    // The last line may not be newline-terminated
+    if (!lineBuffer.empty()) {
+        std::string line = lineBuffer;
+        lineBuffer.clear();
+        if (line.back() == '\r') {
+            line.pop_back();
+        }
+        processLine(line);
+    }
+    dispatchEvent();
+    
+    if (isError || sawEvent) {
+        return;
+    }
+    
+    // No events at all: the server answered with a regular JSON body
+    ChatResponse response(rawResponse);
+    if (response.hasError()) {
+        isError = true;
+        errorMessage = response.getErrorMessage();
+        return;
+    }
+    
+    content = response.getContent();
+    completionTokens = response.getCompletionTokens();
+    done = true;
+    if (!content.empty() && onDelta) {
+        onDelta(content);
+    }
+}
+
+/**
+ * Processes a single line of the event stream.
+ */
+void ChatStreamParser::processLine(const std::string& line) {
+    // A blank line terminates the current event
+    if (line.empty()) {
+        dispatchEvent();
+        return;
+    }
+    
+    // Comment lines (e.g., ": keep-alive") are ignored
+    if (line[0] == ':') {
+        return;
+    }
+    
+    if (line.compare(0, 5, "data:") != 0) {
+        return; // event:, id: and retry: fields carry nothing we need
+    }
+    
+    size_t valueStart = 5;
+    if (line.size() > valueStart && line[valueStart] == ' ') {
+        valueStart++;
+    }
+    
+    if (!eventData.empty()) {
+        eventData += '\n';
+    }
+    eventData.append(line, valueStart, std::string::npos);
+    sawEvent = true;
+}
+
+/**
+ * Dispatches the data collected for the current event.
+ */
+void ChatStreamParser::dispatchEvent() {
+    if (eventData.empty()) {
+        return;
+    }
+    
+    std::string data;
+    data.swap(eventData);
+    
+    if (data == "[DONE]") {
+        done = true;
+        return;
+    }
+    
+    Json::Value event;
+    std::string errs;
+    if (!jsonReader->parse(data.data(), data.data() + data.size(), &event, &errs)) {
+        isError = true;
+        errorMessage = "Error parsing stream event: " + errs;
+        rawResponse = data;
+        return;
+    }
+    
+    // Providers report mid-stream failures as an error event
+    if (event.isMember("error")) {
+        const Json::Value& error = event["error"];
+        isError = true;
+        errorMessage = error.isObject() && error.isMember("message")
+            ? error["message"].asString()
+            : error.toStyledString();
+        rawResponse = data;
+        return;
+    }
+    
+    int tokens = readCompletionTokens(event);
+    if (tokens >= 0) {
+        completionTokens = tokens;
+    }
+    
+    const Json::Value& choices = event["choices"];
+    if (!choices.isArray() || choices.empty()) {
+        return; // e.g. a trailing usage-only event
+    }
+    
+    const Json::Value& choice = choices[0];
+    const Json::Value& delta = choice["delta"];
+    if (delta.isObject() && delta["content"].isString()) {
+        std::string text = delta["content"].asString();
+        if (!text.empty()) {
+            content += text;
+            if (onDelta) {
+                onDelta(text);
+            }
+        }
+    }
+    
+    if (choice["finish_reason"].isString()) {
+        finishReason = choice["finish_reason"].asString();
+    }
+}
+
+/**
+ * Checks if the stream reported or caused an error.
+ */
+bool ChatStreamParser::hasError() const {
+    return isError;
+}
+
+/**
+ * Gets the error message if the stream failed.
+ */
+const std::string& ChatStreamParser::getErrorMessage() const {
+    return errorMessage;
+}
+
+/**
+ * Gets the raw data received so far, for error reporting.
+ */
+const std::string& ChatStreamParser::getRawResponse() const {
+    return rawResponse;
+}
+
+/**
+ * Gets the assembled content of all deltas received so far.
+ */
+const std::string& ChatStreamParser::getContent() const {
+    return content;
+}
+
+/**
+ * Gets the finish reason reported by the server.
+ */
+const std::string& ChatStreamParser::getFinishReason() const {
+    return finishReason;
+}
+
+/**
+ * Checks if the terminating "[DONE]" event was received.
+ */
+bool ChatStreamParser::isDone() const {
+    return done;
+}
+
+/**
+ * Gets the number of generated tokens reported in the "usage" block.
+ */
+int ChatStreamParser::getCompletionTokens() const {
+    return completionTokens;
+}
+
 /**
  * Constructs a models list response from API response string.
  */
@@ -0,0 +1,198 @@
+#include "chat_race.h"
+#include "api_models.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "http_client.h"
+#include "provider_manager.h"
+#include "rate_limiter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * Runs a race.
+ */
+RaceResult ChatRace::run(const std::vector<ModelTarget>& contenders, const Json::Value& messages) {
+    RaceResult result;
+    result.entries.resize(contenders.size());
+
+    // One cancellation per contender; the winner cancels all the others
+    std::vector<std::unique_ptr<HttpCancellation>> cancellations;
+    for (size_t i = 0; i < contenders.size(); ++i) {
+        cancellations.push_back(std::make_unique<HttpCancellation>());
+    }
+    std::mutex resultMutex;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto contend = [&](size_t index) {
+        const ModelTarget& contender = contenders[index];
+        HttpCancellation& cancellation = *cancellations[index];
+        RaceEntry entry;
+        entry.contender = contender;
+
+        ChatStreamParser parser([&](const std::string&) {
+            if (entry.firstTokenMs < 0) {
+                entry.firstTokenMs = elapsedMs();
+            }
+        });
+
+        try {
+            std::string apiUrl = ProviderManager::getApiUrl(contender.provider);
+            if (apiUrl.empty()) {
+                throw std::runtime_error("No API URL configured for provider " + contender.provider);
+            }
+
+            ChatRequest request(contender.model, messages);
+            request.setStream(true);
+            Json::Value payload = request.toJson();
+
+            // Each contender waits for its own provider's share of the rate limit
+            RetryPolicy retry = ProviderManager::getRetryPolicy(contender.provider);
+            RateLimiter::acquire(contender.provider, payload, retry);
+            if (cancellation.isCancelled()) {
+                throw std::runtime_error("Cancelled while waiting for the rate limit");
+            }
+            HttpClient::postStream(apiUrl + "/chat/completions", ProviderManager::getApiKey(contender.provider),
+                                   payload,
+                                   [&parser](const char* data, size_t length) {
+                                       return parser.feed(data, length);
+                                   },
+                                   nullptr, &cancellation, nullptr, &retry);
+            parser.finish();
+            if (parser.hasError() && !cancellation.isCancelled()) {
+                entry.error = parser.getErrorMessage();
+            }
+        } catch (const std::exception& e) {
+            entry.error = e.what();
+        }
+        entry.elapsedMs = elapsedMs();
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (cancellation.isCancelled() || (entry.error.empty() && result.hasWinner())) {
+            entry.outcome = RaceOutcome::Lost;
+            entry.error.clear();
+        } else if (!entry.error.empty()) {
+            entry.outcome = RaceOutcome::Failed;
+        } else {
+            entry.outcome = RaceOutcome::Won;
+            result.winner = static_cast<int>(index);
+            result.content = parser.getContent();
+            for (size_t other = 0; other < cancellations.size(); ++other) {
+                if (other != index) {
+                    cancellations[other]->cancel();
+                }
+            }
+        }
+        result.entries[index] = std::move(entry);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(contenders.size());
+    for (size_t i = 0; i < contenders.size(); ++i) {
+        threads.emplace_back(contend, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return result;
+}
+
+/**
+ * Appends the outcome of a race to the race log.
+ */
+void ChatRace::record(const RaceResult& result) {
+    std::string path = getLogPath();
+    try {
+        DirectoryOperations::create(ConfigManager::getCacheDir());
+
+        // One write per race, so concurrent races do not interleave their lines
+        std::ostringstream lines;
+        long long now = static_cast<long long>(std::time(nullptr));
+        lines << std::fixed << std::setprecision(1);
+        for (const RaceEntry& entry : result.entries) {
+            lines << now << '\t' << entry.contender.getLabel() << '\t' << toString(entry.outcome) << '\t'
+                  << entry.elapsedMs << '\t' << entry.firstTokenMs << '\n';
+        }
+
+        std::ofstream log(path, std::ios::app);
+        log << lines.str() << std::flush;
+        if (!log) {
+            throw std::runtime_error("write failed");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Could not record race in " << path << ": " << e.what() << std::endl;
+    }
+}
+
+/**
+ * Aggregates the race log per contender.
+ */
+std::vector<RaceStats> ChatRace::readStats() {
+    std::map<std::string, RaceStats> byLabel;
+
+    std::ifstream log(getLogPath());
+    std::string line;
+    while (std::getline(log, line)) {
+        std::istringstream fields(line);
+        std::string time, label, outcome, elapsed;
+        if (!std::getline(fields, time, '\t') || !std::getline(fields, label, '\t') ||
+            !std::getline(fields, outcome, '\t') || !std::getline(fields, elapsed, '\t')) {
+            continue;
+        }
+
+        RaceStats& stats = byLabel[label];
+        stats.label = label;
+        ++stats.races;
+        if (outcome == toString(RaceOutcome::Won)) {
+            ++stats.wins;
+            stats.totalWinMs += std::strtod(elapsed.c_str(), nullptr);
+        } else if (outcome == toString(RaceOutcome::Failed)) {
+            ++stats.failures;
+        }
+    }
+
+    std::vector<RaceStats> result;
+    for (auto& entry : byLabel) {
+        result.push_back(std::move(entry.second));
+    }
+    std::stable_sort(result.begin(), result.end(), [](const RaceStats& a, const RaceStats& b) {
+        return a.wins > b.wins;
+    });
+    return result;
+}
+
+/**
+ * Gets the path of the race log.
+ */
+std::string ChatRace::getLogPath() {
+    return ConfigManager::getCacheDir() + "/race.tsv";
+}
+
+/**
+ * Gets the log name of an outcome.
+ */
+const char* ChatRace::toString(RaceOutcome outcome) {
+    switch (outcome) {
+        case RaceOutcome::Won:
+            return "won";
+        case RaceOutcome::Lost:
+            return "lost";
+        case RaceOutcome::Failed:
+            break;
+    }
+    return "failed";
+}
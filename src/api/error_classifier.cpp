@@ -0,0 +1,157 @@
+#include "error_classifier.h"
+#include "http_error.h"
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+/**
+ * Classifies a failure from its HTTP status and message.
+ */
+ErrorClass ErrorClassifier::classify(int status, const std::string& message) {
+    // Providers report unknown or retired models as 400, 404 or 422
+    if (isModelUnavailableMessage(message)) {
+        return ErrorClass::ModelUnavailable;
+    }
+
+    if (status == 0) {
+        return ErrorClass::Connection;
+    }
+    if (status == 429) {
+        return ErrorClass::RateLimited;
+    }
+    if (status == 503 || status == 529) {
+        return ErrorClass::Overloaded;
+    }
+    if (status >= 500 || status == 408) {
+        return ErrorClass::ServerError;
+    }
+    if (status == 401 || status == 403) {
+        return ErrorClass::Auth;
+    }
+    if (status >= 400) {
+        return ErrorClass::BadRequest;
+    }
+    return ErrorClass::Unknown;
+}
+
+/**
+ * Classifies a caught exception.
+ */
+ErrorClass ErrorClassifier::classify(const std::exception& error) {
+    const HttpError* httpError = dynamic_cast<const HttpError*>(&error);
+    return classify(httpError ? httpError->getStatus() : -1, error.what());
+}
+
+/**
+ * Classifies an error found in a reply that arrived with a success status.
+ */
+ErrorClass ErrorClassifier::classifyReply(const std::string& message) {
+    return isModelUnavailableMessage(message) ? ErrorClass::ModelUnavailable : ErrorClass::InvalidReply;
+}
+
+/**
+ * Checks if repeating the same request may succeed.
+ */
+bool ErrorClassifier::isRetryable(ErrorClass errorClass) {
+    switch (errorClass) {
+        case ErrorClass::RateLimited:
+        case ErrorClass::Overloaded:
+        case ErrorClass::ServerError:
+        case ErrorClass::Connection:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Checks if another provider or model may succeed where this one failed.
+ */
+bool ErrorClassifier::shouldFailover(ErrorClass errorClass) {
+    return errorClass != ErrorClass::BadRequest && errorClass != ErrorClass::Unknown;
+}
+
+/**
+ * Checks if the model should be blacklisted.
+ */
+bool ErrorClassifier::shouldBlacklist(ErrorClass errorClass) {
+    return errorClass == ErrorClass::ModelUnavailable;
+}
+
+/**
+ * Gets a short description of an error class.
+ */
+const char* ErrorClassifier::toString(ErrorClass errorClass) {
+    switch (errorClass) {
+        case ErrorClass::RateLimited:
+            return "rate limited";
+        case ErrorClass::Overloaded:
+            return "overloaded";
+        case ErrorClass::ServerError:
+            return "server error";
+        case ErrorClass::Connection:
+            return "connection failed or timed out";
+        case ErrorClass::Auth:
+            return "not authorized";
+        case ErrorClass::ModelUnavailable:
+            return "model unavailable";
+        case ErrorClass::BadRequest:
+            return "request rejected";
+        case ErrorClass::InvalidReply:
+            return "invalid reply";
+        case ErrorClass::Unknown:
+            break;
+    }
+    return "unknown error";
+}
+
+/**
+ * Gets an identifier of an error class for metric labels.
+ */
+const char* ErrorClassifier::toLabel(ErrorClass errorClass) {
+    switch (errorClass) {
+        case ErrorClass::RateLimited:
+            return "rate_limited";
+        case ErrorClass::Overloaded:
+            return "overloaded";
+        case ErrorClass::ServerError:
+            return "server_error";
+        case ErrorClass::Connection:
+            return "connection";
+        case ErrorClass::Auth:
+            return "auth";
+        case ErrorClass::ModelUnavailable:
+            return "model_unavailable";
+        case ErrorClass::BadRequest:
+            return "bad_request";
+        case ErrorClass::InvalidReply:
+            return "invalid_reply";
+        case ErrorClass::Unknown:
+            break;
+    }
+    return "unknown";
+}
+
+/**
+ * Checks if a message reports an unavailable model.
+ */
+bool ErrorClassifier::isModelUnavailableMessage(const std::string& message) {
+    static const std::vector<std::string> patterns = {
+        "does not support chat completions",
+        "model not found",
+        "model does not exist",
+        "invalid model",
+        "unsupported model",
+        "deprecated model",
+        "model_not_found",
+        "has been decommissioned",
+        "no endpoints found"
+    };
+
+    std::string lowerMessage = message;
+    std::transform(lowerMessage.begin(), lowerMessage.end(), lowerMessage.begin(), ::tolower);
+
+    return std::any_of(patterns.begin(), patterns.end(), [&lowerMessage](const std::string& pattern) {
+        return lowerMessage.find(pattern) != std::string::npos;
+    });
+}
@@ -0,0 +1,150 @@
+#include "failover_chain.h"
+#include "api_helpers.h"
+#include "blacklist_manager.h"
+#include "config_manager.h"
+#include "metrics.h"
+#include "provider_manager.h"
+#include "rate_limiter.h"
+#include <algorithm>
+#include <exception>
+
+const int FailoverChain::DEFAULT_CONNECT_TIMEOUT_MS = 1000;
+const int FailoverChain::DEFAULT_READ_TIMEOUT_MS = 10000;
+const int FailoverChain::DEFAULT_RESPONSE_TIMEOUT_MS = 30000;
+
+/**
+ * A result for a target that answered.
+ */
+FailoverResult FailoverResult::success() {
+    FailoverResult result;
+    result.succeeded = true;
+    return result;
+}
+
+/**
+ * A result for a target that failed.
+ */
+FailoverResult FailoverResult::failure(ErrorClass errorClass, const std::string& errorMessage, bool delivered) {
+    FailoverResult result;
+    result.delivered = delivered;
+    result.errorClass = errorClass;
+    result.errorMessage = errorMessage;
+    return result;
+}
+
+/**
+ * A result for a request the user abandoned.
+ */
+FailoverResult FailoverResult::cancel() {
+    FailoverResult result;
+    result.cancelled = true;
+    return result;
+}
+
+/**
+ * Builds the chain for a provider and model.
+ */
+std::vector<ModelTarget> FailoverChain::load(const ModelTarget& primary) {
+    std::vector<ModelTarget> chain{primary};
+
+    std::string fallbacks = ConfigManager::getModelConfigValue(primary.provider, primary.model, "FALLBACK");
+    for (const ModelTarget& target : ModelTarget::parseList(fallbacks)) {
+        bool seen = std::any_of(chain.begin(), chain.end(), [&target](const ModelTarget& other) {
+            return other.provider == target.provider && other.model == target.model;
+        });
+        if (!seen && !BlacklistManager::isModelBlacklisted(target.provider, target.model)) {
+            chain.push_back(target);
+        }
+    }
+    return chain;
+}
+
+/**
+ * Gets the timeouts for a target, each set for the error class it detects.
+ */
+HttpClient::Timeouts FailoverChain::getTimeouts(const ModelTarget& target, bool stream, bool hasFallback) {
+    // 0 would mean the default timeout, which is what these replace
+    auto readTimeout = [&target](const char* key, int defaultMs) {
+        int timeoutMs = static_cast<int>(ConfigManager::getProviderNumber(target.provider, key, defaultMs, target.model));
+        return timeoutMs > 0 ? timeoutMs : defaultMs;
+    };
+
+    // A connection failure is retried or failed over, so every target detects it quickly
+    HttpClient::Timeouts timeouts;
+    timeouts.connectMs = readTimeout("FAILOVER_CONNECT_TIMEOUT_MS", DEFAULT_CONNECT_TIMEOUT_MS);
+
+    // A stalled reply is only worth abandoning for a fallback; the last target waits as long as it takes
+    if (hasFallback) {
+        timeouts.readMs = stream ? readTimeout("FAILOVER_READ_TIMEOUT_MS", DEFAULT_READ_TIMEOUT_MS)
+                                 : readTimeout("FAILOVER_RESPONSE_TIMEOUT_MS", DEFAULT_RESPONSE_TIMEOUT_MS);
+    }
+    return timeouts;
+}
+
+/**
+ * Walks a chain until a target answers.
+ */
+FailoverResult FailoverChain::run(const std::vector<ModelTarget>& chain, const Json::Value& payload, bool stream,
+                                  const std::string& source, const Attempt& attempt) {
+    FailoverResult result;
+    for (size_t i = 0; i < chain.size(); ++i) {
+        const ModelTarget& target = chain[i];
+        bool hasFallback = i + 1 < chain.size();
+
+        // Only fallbacks pay for a copy of the request
+        Json::Value fallbackPayload;
+        if (i > 0) {
+            fallbackPayload = payload;
+            fallbackPayload["model"] = target.model;
+        }
+        HttpClient::Timeouts timeouts = getTimeouts(target, stream, hasFallback);
+        RetryPolicy retryPolicy = ProviderManager::getRetryPolicy(target.provider);
+        if (hasFallback) {
+            retryPolicy.maxAttempts = 1; // Failing over is faster than waiting for the same target
+        }
+        FailoverRequest request{target, i, ProviderManager::getApiUrl(target.provider),
+                                ProviderManager::getApiKey(target.provider), i == 0 ? payload : fallbackPayload,
+                                &timeouts, &retryPolicy};
+
+        std::exception_ptr error;
+        if (request.apiUrl.empty() || request.apiKey.empty()) {
+            result = FailoverResult::failure(ErrorClass::Auth,
+                                             "Provider " + target.provider + " has no API_URL or API_KEY configured");
+        } else {
+            // Share the provider's request budget with other aith processes
+            double rateLimitWaitMs = RateLimiter::acquire(target.provider, request.payload, retryPolicy);
+            if (rateLimitWaitMs > 0) {
+                ApiConsole::displayRateLimitWait(target, rateLimitWaitMs);
+            }
+
+            // Timed from here, so the rate limit wait is not part of the request latency
+            Metrics::ModelRequest metricsRequest(source, target.provider, target.model);
+            try {
+                result = attempt(request);
+            } catch (const std::exception& e) {
+                result = FailoverResult::failure(ErrorClassifier::classify(e), e.what());
+                error = std::current_exception();
+            }
+            if (result.succeeded) {
+                metricsRequest.succeed();
+                return result;
+            }
+            metricsRequest.fail(result.cancelled ? "cancelled" : ErrorClassifier::toLabel(result.errorClass));
+            if (result.cancelled) {
+                return result;
+            }
+        }
+
+        if (ErrorClassifier::shouldBlacklist(result.errorClass)) {
+            BlacklistManager::addModelToBlacklist(target.provider, target.model, result.errorMessage);
+        }
+        if (!hasFallback || result.delivered || !ErrorClassifier::shouldFailover(result.errorClass)) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return result;
+        }
+        ApiConsole::displayFailover(target, chain[i + 1], result.errorClass, result.errorMessage);
+    }
+    return result;
+}
@@ -0,0 +1,259 @@
+#include "hedged_request.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "file_operations.h"
+#include "latency_history.h"
+#include "model_target.h"
+#include "provider_manager.h"
+#include "rate_limiter.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+const double HedgedRequest::DEFAULT_PERCENTILE = 95.0;
+
+namespace {
+
+/**
+ * One of the two requests of a hedged send.
+ */
+struct Attempt {
+    std::string provider;
+    std::string model;
+    std::chrono::steady_clock::time_point start;
+    HttpCancellation cancellation;
+    std::exception_ptr error;
+    double firstByteMs = -1.0;      // From the start of this attempt
+    bool finished = false;
+};
+
+} // namespace
+
+/**
+ * Loads the hedging settings for a provider and model.
+ */
+HedgePolicy HedgedRequest::loadPolicy(const std::string& provider, const std::string& model) {
+    HedgePolicy policy;
+
+    std::string enabled = ConfigManager::getModelConfigValue(provider, model, "HEDGE");
+    std::transform(enabled.begin(), enabled.end(), enabled.begin(), ::tolower);
+    policy.enabled = enabled == "true" || enabled == "yes" || enabled == "on" || enabled == "1";
+    if (!policy.enabled) {
+        return policy;
+    }
+
+    std::string backup = ConfigManager::getModelConfigValue(provider, model, "HEDGE_MODEL");
+    if (backup.find(':') != std::string::npos) {
+        ModelTarget target = ModelTarget::parse(backup);
+        policy.backupProvider = target.provider;
+        policy.backupModel = target.model;
+    } else {
+        policy.backupProvider = provider;
+        policy.backupModel = backup.empty() ? model : backup;
+    }
+
+    policy.delayMs = ConfigManager::getProviderNumber(provider, "HEDGE_AFTER_MS", -1.0, model);
+    if (policy.delayMs < 0) {
+        policy.percentile = ConfigManager::getProviderNumber(provider, "HEDGE_PERCENTILE", DEFAULT_PERCENTILE, model);
+        if (policy.percentile <= 0 || policy.percentile > 100) {
+            policy.percentile = DEFAULT_PERCENTILE;
+        }
+        policy.delayMs = LatencyHistory::percentile(provider, model, policy.percentile);
+    }
+    return policy;
+}
+
+/**
+ * Sends a streaming chat request, hedging it if it is slow.
+ */
+HedgeOutcome HedgedRequest::send(const std::string& provider, const std::string& apiUrl, const std::string& apiKey,
+                                 const Json::Value& payload, const HedgePolicy& policy,
+                                 const HttpClient::Timeouts* timeouts, const RetryPolicy* retry,
+                                 const HttpClient::ChunkCallback& onChunk) {
+    Attempt attempts[2];
+    attempts[0].provider = provider;
+    attempts[0].model = payload["model"].asString();
+    attempts[1].provider = policy.backupProvider;
+    attempts[1].model = policy.backupModel;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    int winner = -1;
+
+    auto run = [&](int index) {
+        Attempt& attempt = attempts[index];
+        Attempt& other = attempts[1 - index];
+        attempt.start = std::chrono::steady_clock::now();
+
+        // The first attempt to deliver a byte wins; the other one is cancelled
+        bool won = false;
+        auto forward = [&](const char* data, size_t length) {
+            if (!won) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (winner != -1) {
+                    return false;
+                }
+                winner = index;
+                won = true;
+                attempt.firstByteMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - attempt.start).count();
+                other.cancellation.cancel();
+                changed.notify_all();
+            }
+            return onChunk(data, length);
+        };
+
+        try {
+            if (index == 0) {
+                HttpClient::postStream(apiUrl + "/chat/completions", apiKey, payload, forward,
+                                       nullptr, &attempt.cancellation, timeouts, retry);
+            } else {
+                Json::Value hedgePayload = payload;
+                hedgePayload["model"] = attempt.model;
+
+                // The hedge is a request of its own and is charged to the backup provider's bucket
+                RetryPolicy hedgeRetry = ProviderManager::getRetryPolicy(attempt.provider);
+                if (retry != nullptr) {
+                    hedgeRetry.maxAttempts = retry->maxAttempts;
+                }
+                RateLimiter::acquire(attempt.provider, hedgePayload, hedgeRetry);
+                if (!attempt.cancellation.isCancelled()) {
+                    HttpClient::postStream(ProviderManager::getApiUrl(attempt.provider) + "/chat/completions",
+                                           attempt.provider == provider ? apiKey
+                                                                        : ProviderManager::getApiKey(attempt.provider),
+                                           hedgePayload, forward, nullptr, &attempt.cancellation, timeouts,
+                                           &hedgeRetry);
+                }
+            }
+        } catch (...) {
+            attempt.error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        attempt.finished = true;
+        changed.notify_all();
+    };
+
+    HedgeOutcome outcome;
+    std::thread primary(run, 0);
+    std::thread hedge;
+    {
+        // Until enough latency samples exist the request only records its own
+        std::unique_lock<std::mutex> lock(mutex);
+        auto settled = [&]() { return winner != -1 || attempts[0].finished; };
+        if (!policy.isActive()) {
+            changed.wait(lock, settled);
+        } else if (!changed.wait_for(lock, std::chrono::duration<double, std::milli>(policy.delayMs), settled)) {
+            outcome.fired = true;
+            hedge = std::thread(run, 1);
+        }
+    }
+    primary.join();
+    if (hedge.joinable()) {
+        hedge.join();
+    }
+
+    if (winner != -1) {
+        outcome.hedgeWon = winner == 1;
+        outcome.firstByteMs = attempts[winner].firstByteMs + std::chrono::duration<double, std::milli>(
+            attempts[winner].start - attempts[0].start).count();
+    }
+
+    // A primary that lost was still waiting when cancelled: record that lower bound, not nothing
+    double primaryMs = attempts[0].firstByteMs;
+    if (primaryMs < 0 && outcome.hedgeWon) {
+        primaryMs = outcome.firstByteMs;
+    }
+    if (primaryMs >= 0) {
+        LatencyHistory::record(provider, attempts[0].model, primaryMs);
+    }
+    if (outcome.hedgeWon && (attempts[1].provider != provider || attempts[1].model != attempts[0].model)) {
+        LatencyHistory::record(attempts[1].provider, attempts[1].model, attempts[1].firstByteMs);
+    }
+    recordStats(provider, attempts[0].model, outcome);
+
+    if (winner != -1) {
+        if (attempts[winner].error) {
+            std::rethrow_exception(attempts[winner].error);
+        }
+        return outcome;
+    }
+    for (const Attempt& attempt : attempts) {
+        if (attempt.error) {
+            std::rethrow_exception(attempt.error);
+        }
+    }
+    return outcome;
+}
+
+/**
+ * Reads the hedging counters of a provider and model.
+ */
+HedgeStats HedgedRequest::getStats(const std::string& provider, const std::string& model) {
+    HedgeStats stats;
+    std::string label = provider + ":" + model;
+
+    std::ifstream file(getStatsPath());
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        HedgeStats entry;
+        if (fields >> name >> entry.requests >> entry.fired >> entry.won && name == label) {
+            stats = entry;
+        }
+    }
+    return stats;
+}
+
+/**
+ * Adds one request to the counters of a provider and model, under a file lock.
+ */
+void HedgedRequest::recordStats(const std::string& provider, const std::string& model, const HedgeOutcome& outcome) {
+    try {
+        DirectoryOperations::create(ConfigManager::getCacheDir());
+    } catch (const std::exception&) {
+        return; // A request is not held up by statistics it cannot keep
+    }
+
+    FileOperations::updateLocked(getStatsPath(), [&](const std::string& content) {
+        std::string label = provider + ":" + model;
+        std::ostringstream updated;
+        bool found = false;
+
+        std::istringstream lines(content);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::istringstream fields(line);
+            std::string name;
+            HedgeStats entry;
+            if (!(fields >> name >> entry.requests >> entry.fired >> entry.won)) {
+                continue;
+            }
+            if (name == label) {
+                entry.requests += 1;
+                entry.fired += outcome.fired ? 1 : 0;
+                entry.won += outcome.hedgeWon ? 1 : 0;
+                found = true;
+            }
+            updated << name << ' ' << entry.requests << ' ' << entry.fired << ' ' << entry.won << '\n';
+        }
+        if (!found) {
+            updated << label << " 1 " << (outcome.fired ? 1 : 0) << ' ' << (outcome.hedgeWon ? 1 : 0) << '\n';
+        }
+        return updated.str();
+    });
+}
+
+/**
+ * Gets the file holding the counters of all providers and models.
+ */
+std::string HedgedRequest::getStatsPath() {
+    return ConfigManager::getCacheDir() + "/hedge_stats";
+}
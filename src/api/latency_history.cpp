@@ -0,0 +1,107 @@
+#include "latency_history.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "file_operations.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+const size_t LatencyHistory::MAX_SAMPLES = 200;
+const size_t LatencyHistory::MIN_SAMPLES = 20;
+
+namespace {
+
+/**
+ * Replaces characters that are unsafe in file names (model ids contain '/').
+ */
+std::string sanitizeName(const std::string& name) {
+    std::string result = name;
+    for (char& c : result) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') {
+            c = '_';
+        }
+    }
+    return result;
+}
+
+/**
+ * Parses one sample per line.
+ */
+std::vector<double> parseSamples(const std::string& content) {
+    std::vector<double> samples;
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line)) {
+        char* end = nullptr;
+        double value = std::strtod(line.c_str(), &end);
+        if (end != line.c_str() && value >= 0) {
+            samples.push_back(value);
+        }
+    }
+    return samples;
+}
+
+} // namespace
+
+/**
+ * Adds a sample, dropping the oldest beyond MAX_SAMPLES.
+ */
+void LatencyHistory::record(const std::string& provider, const std::string& model, double firstByteMs) {
+    std::string path = getPath(provider, model);
+    try {
+        DirectoryOperations::create(ConfigManager::getCacheDir() + "/latency");
+    } catch (const std::exception&) {
+        return;
+    }
+
+    // Read, append and rewrite under the lock so concurrent processes keep every sample
+    FileOperations::updateLocked(path, [firstByteMs](const std::string& content) {
+        std::vector<double> samples = parseSamples(content);
+        samples.push_back(firstByteMs);
+        size_t first = samples.size() > MAX_SAMPLES ? samples.size() - MAX_SAMPLES : 0;
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        for (size_t i = first; i < samples.size(); ++i) {
+            out << samples[i] << '\n';
+        }
+        return out.str();
+    });
+}
+
+/**
+ * Reads the recorded samples, oldest first.
+ */
+std::vector<double> LatencyHistory::read(const std::string& provider, const std::string& model) {
+    std::ifstream file(getPath(provider, model));
+    std::ostringstream content;
+    content << file.rdbuf();
+    return parseSamples(content.str());
+}
+
+/**
+ * Computes a percentile of the recorded samples (nearest rank).
+ */
+double LatencyHistory::percentile(const std::string& provider, const std::string& model, double percentile) {
+    std::vector<double> samples = read(provider, model);
+    if (samples.size() < MIN_SAMPLES) {
+        return -1.0;
+    }
+
+    double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(clamped / 100.0 * static_cast<double>(samples.size())));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+/**
+ * Gets the file holding the samples of a provider and model.
+ */
+std::string LatencyHistory::getPath(const std::string& provider, const std::string& model) {
+    return ConfigManager::getCacheDir() + "/latency/" + sanitizeName(provider) + "--" + sanitizeName(model);
+}
@@ -0,0 +1,281 @@
+#include "model_catalog.h"
+#include "blacklist_manager.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "file_operations.h"
+#include "http_client.h"
+#include "parsed_file_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+const long ModelCatalog::DEFAULT_TTL_SECONDS = 3600;
+
+/**
+ * Checks if the filter selects every model.
+ */
+bool ModelFilter::isEmpty() const {
+    return owner.empty() && prefix.empty();
+}
+
+/**
+ * Checks if a model is selected by the filter.
+ */
+bool ModelFilter::matches(const ModelInfo& model) const {
+    if (!prefix.empty() && model.id.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    if (!owner.empty()) {
+        if (owner.size() != model.ownedBy.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < owner.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(owner[i])) !=
+                std::tolower(static_cast<unsigned char>(model.ownedBy[i]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Gets the models of a provider, from the cache when possible.
+ */
+ModelCatalogResult ModelCatalog::load(const std::string& provider, const std::string& apiUrl,
+                                      const std::string& apiKey, bool refresh) {
+    std::string path = getCachePath(provider);
+    ModelCatalogResult result;
+
+    // A list fetched from another API URL belongs to a different server
+    CacheFile cached;
+    bool haveCache = readCache(path, cached) && cached.url == apiUrl;
+
+    time_t now = std::time(nullptr);
+    if (haveCache && !refresh && now - cached.fetchedAt < getTtlSeconds(provider)) {
+        applyBlacklist(provider, cached.models);
+        result.models = std::move(cached.models);
+        result.source = ModelCatalogSource::Cache;
+        result.fetchedAt = cached.fetchedAt;
+        return result;
+    }
+
+    CacheFile fresh;
+    bool notModified = false;
+    try {
+        fresh = fetch(provider, apiUrl, apiKey, haveCache && !refresh ? &cached : nullptr, notModified);
+    } catch (const std::runtime_error& e) {
+        if (!haveCache) {
+            throw;
+        }
+        std::cerr << "Warning: Could not update the model list (" << e.what()
+                  << "); using the cached list" << std::endl;
+        applyBlacklist(provider, cached.models);
+        result.models = std::move(cached.models);
+        result.source = ModelCatalogSource::StaleCache;
+        result.fetchedAt = cached.fetchedAt;
+        return result;
+    }
+
+    writeCache(path, fresh);
+
+    applyBlacklist(provider, fresh.models);
+    result.models = std::move(fresh.models);
+    result.source = notModified ? ModelCatalogSource::Revalidated : ModelCatalogSource::Network;
+    result.fetchedAt = fresh.fetchedAt;
+    return result;
+}
+
+/**
+ * Selects the models matching a filter.
+ */
+std::vector<ModelInfo> ModelCatalog::filter(const std::vector<ModelInfo>& models, const ModelFilter& filter) {
+    if (filter.isEmpty()) {
+        return models;
+    }
+
+    std::vector<ModelInfo> selected;
+    for (const ModelInfo& model : models) {
+        if (filter.matches(model)) {
+            selected.push_back(model);
+        }
+    }
+    return selected;
+}
+
+/**
+ * Gets the cache lifetime for a provider.
+ */
+long ModelCatalog::getTtlSeconds(const std::string& provider) {
+    return static_cast<long>(ConfigManager::getProviderNumber(provider, "MODEL_CACHE_TTL", DEFAULT_TTL_SECONDS));
+}
+
+/**
+ * Gets the path of a provider's cache file.
+ */
+std::string ModelCatalog::getCachePath(const std::string& provider) {
+    return ConfigManager::getCacheDir() + "/models/" + provider + ".tsv";
+}
+
+/**
+ * Reads a cache file.
+ * A long-running process (aithd) parses each file once per change.
+ */
+bool ModelCatalog::readCache(const std::string& path, CacheFile& cache) {
+    static ParsedFileCache<CacheFile> parsedFiles;
+    std::shared_ptr<const CacheFile> parsed = parsedFiles.get(path, &ModelCatalog::parseCache);
+    if (!parsed) {
+        return false;
+    }
+    cache = *parsed;
+    return true;
+}
+
+/**
+ * Parses a cache file.
+ * Format: "key<TAB>value" header lines, an empty line, then one
+ * "id<TAB>owner<TAB>created" line per model.
+ */
+bool ModelCatalog::parseCache(const std::string& path, CacheFile& cache) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    bool haveTimestamp = false;
+    while (std::getline(file, line) && !line.empty()) {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) {
+            return false;
+        }
+        std::string key = line.substr(0, tab);
+        std::string value = line.substr(tab + 1);
+
+        if (key == "url") {
+            cache.url = value;
+        } else if (key == "fetched") {
+            try {
+                cache.fetchedAt = static_cast<time_t>(std::stoll(value));
+                haveTimestamp = true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        } else if (key == "etag") {
+            cache.etag = value;
+        } else if (key == "last-modified") {
+            cache.lastModified = value;
+        }
+        // Unknown keys are ignored so newer versions can add fields
+    }
+    if (!haveTimestamp) {
+        return false;
+    }
+
+    while (std::getline(file, line)) {
+        size_t ownerStart = line.find('\t');
+        size_t createdStart = ownerStart == std::string::npos ? std::string::npos : line.find('\t', ownerStart + 1);
+        if (createdStart == std::string::npos) {
+            return false; // Truncated file
+        }
+
+        ModelInfo model;
+        model.id = line.substr(0, ownerStart);
+        model.ownedBy = line.substr(ownerStart + 1, createdStart - ownerStart - 1);
+        model.created = static_cast<time_t>(std::strtoll(line.c_str() + createdStart + 1, nullptr, 10));
+        cache.models.push_back(std::move(model));
+    }
+
+    return true;
+}
+
+/**
+ * Writes a cache file atomically (temporary file + rename).
+ */
+void ModelCatalog::writeCache(const std::string& path, const CacheFile& cache) {
+    std::ostringstream content;
+    content << "url\t" << sanitizeField(cache.url) << '\n'
+            << "fetched\t" << static_cast<long long>(cache.fetchedAt) << '\n';
+    if (!cache.etag.empty()) {
+        content << "etag\t" << sanitizeField(cache.etag) << '\n';
+    }
+    if (!cache.lastModified.empty()) {
+        content << "last-modified\t" << sanitizeField(cache.lastModified) << '\n';
+    }
+    content << '\n';
+
+    for (const ModelInfo& model : cache.models) {
+        content << sanitizeField(model.id) << '\t' << sanitizeField(model.ownedBy) << '\t'
+                << static_cast<long long>(model.created) << '\n';
+    }
+
+    // Readers in other processes never see a partially written file
+    std::string tempPath = FileOperations::makeTempPath(path);
+    try {
+        DirectoryOperations::create(path.substr(0, path.find_last_of('/')));
+        FileOperations::write(tempPath, content.str());
+        if (!FileOperations::rename(tempPath, path)) {
+            throw std::runtime_error("cannot rename " + tempPath);
+        }
+    } catch (const std::exception& e) {
+        FileOperations::remove(tempPath);
+        std::cerr << "Warning: Could not write model cache " << path << ": " << e.what() << std::endl;
+    }
+}
+
+/**
+ * Downloads the model list, revalidating the cached copy when it has validators.
+ */
+ModelCatalog::CacheFile ModelCatalog::fetch(const std::string& provider, const std::string& apiUrl,
+                                            const std::string& apiKey, const CacheFile* cached,
+                                            bool& notModified) {
+    std::string etag = cached ? cached->etag : std::string();
+    std::string lastModified = cached ? cached->lastModified : std::string();
+
+    HttpClient::ConditionalResponse response =
+        HttpClient::getConditional(apiUrl + "/models", apiKey, etag, lastModified);
+
+    CacheFile fresh;
+    fresh.url = apiUrl;
+    fresh.fetchedAt = std::time(nullptr);
+    notModified = response.notModified && cached != nullptr;
+
+    if (notModified) {
+        fresh.etag = response.etag.empty() ? cached->etag : response.etag;
+        fresh.lastModified = response.lastModified.empty() ? cached->lastModified : response.lastModified;
+        fresh.models = cached->models;
+        return fresh;
+    }
+
+    ModelsListResponse parsed(response.body, provider);
+    if (parsed.hasError()) {
+        throw std::runtime_error(parsed.getErrorMessage());
+    }
+
+    fresh.etag = response.etag;
+    fresh.lastModified = response.lastModified;
+    fresh.models = parsed.getModels();
+    return fresh;
+}
+
+/**
+ * Sets the blacklist flag of every model.
+ */
+void ModelCatalog::applyBlacklist(const std::string& provider, std::vector<ModelInfo>& models) {
+    for (ModelInfo& model : models) {
+        model.isBlacklisted = BlacklistManager::isModelBlacklisted(provider, model.id);
+    }
+}
+
+/**
+ * Replaces characters that would break the line format (tabs, newlines).
+ */
+std::string ModelCatalog::sanitizeField(const std::string& value) {
+    std::string sanitized = value;
+    std::replace_if(sanitized.begin(), sanitized.end(),
+                    [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return sanitized;
+}
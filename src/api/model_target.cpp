@@ -0,0 +1,45 @@
+#include "model_target.h"
+#include "provider_manager.h"
+#include "string_utils.h"
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * Parses a "provider:model" target.
+ */
+ModelTarget ModelTarget::parse(const std::string& spec) {
+    ModelTarget target;
+    size_t colon = spec.find(':');
+    target.provider = spec.substr(0, colon);
+    if (colon != std::string::npos) {
+        target.model = spec.substr(colon + 1);
+    }
+
+    if (target.provider.empty()) {
+        throw std::invalid_argument("Model target needs a provider: '" + spec + "'");
+    }
+    if (target.model.empty()) {
+        target.model = ProviderManager::getDefaultModel(target.provider);
+        if (target.model.empty()) {
+            throw std::invalid_argument("No model given and no default model configured for provider '"
+                                        + target.provider + "'");
+        }
+    }
+    return target;
+}
+
+/**
+ * Parses a comma-separated list of targets.
+ */
+std::vector<ModelTarget> ModelTarget::parseList(const std::string& specs) {
+    std::vector<ModelTarget> targets;
+    std::istringstream items(specs);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item = StringUtils::trim(item);
+        if (!item.empty()) {
+            targets.push_back(parse(item));
+        }
+    }
+    return targets;
+}
@@ -0,0 +1,267 @@
+#include "rate_limiter.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "token_counter.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t STATE_MAGIC = 0x61727431;    // "art1"
+const double MS_PER_MINUTE = 60000.0;
+const double DEFAULT_PAUSE_MS = 1000.0;     // After a 429 that names no delay
+
+/**
+ * Bucket levels as stored in the shared state file.
+ */
+struct SharedState {
+    uint32_t magic;
+    uint32_t reserved;
+    double requests;            // Available requests
+    double tokens;              // Available tokens
+    int64_t updatedMs;          // Wall clock time of the last refill
+    int64_t pausedUntilMs;      // No request before this wall clock time
+};
+
+/**
+ * A provider's mapped state file.
+ */
+struct Bucket {
+    std::mutex mutex;           // flock does not exclude threads sharing the descriptor
+    int fd = -1;
+    SharedState* state = nullptr;
+};
+
+/**
+ * Mapped buckets of this process.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Bucket>> buckets;
+};
+
+Registry& getRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+int64_t nowEpochMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Replaces characters that are unsafe in file names.
+ */
+std::string sanitizeName(const std::string& name) {
+    std::string result = name;
+    for (char& c : result) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') {
+            c = '_';
+        }
+    }
+    return result;
+}
+
+/**
+ * Maps the state file of a provider, once per process.
+ * @return The bucket, or nullptr if the file cannot be used
+ */
+Bucket* openBucket(const std::string& provider) {
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.buckets.find(provider);
+    if (it != registry.buckets.end()) {
+        return it->second.get();
+    }
+
+    std::unique_ptr<Bucket> bucket(new Bucket());
+    try {
+        DirectoryOperations::create(ConfigManager::getCacheDir() + "/ratelimit");
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    bucket->fd = ::open(RateLimiter::getPath(provider).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (bucket->fd < 0) {
+        return nullptr;
+    }
+
+    // A new file is zero-filled; its magic is set on first use
+    struct stat info;
+    if ((::fstat(bucket->fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SharedState))) &&
+        ::ftruncate(bucket->fd, sizeof(SharedState)) != 0) {
+        ::close(bucket->fd);
+        return nullptr;
+    }
+    void* mapped = ::mmap(nullptr, sizeof(SharedState), PROT_READ | PROT_WRITE, MAP_SHARED, bucket->fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(bucket->fd);
+        return nullptr;
+    }
+    bucket->state = static_cast<SharedState*>(mapped);
+
+    Bucket* result = bucket.get();
+    registry.buckets.emplace(provider, std::move(bucket));
+    return result;
+}
+
+/**
+ * Runs an update of the shared state under the process and file locks,
+ * after refilling the buckets up to now.
+ */
+template<typename Update>
+void withState(Bucket& bucket, const RateLimits& limits, Update update) {
+    std::lock_guard<std::mutex> lock(bucket.mutex);
+    if (::flock(bucket.fd, LOCK_EX) != 0) {
+        return;
+    }
+
+    SharedState& state = *bucket.state;
+    int64_t now = nowEpochMs();
+    if (state.magic != STATE_MAGIC) {
+        state = SharedState{STATE_MAGIC, 0, limits.requestsPerMinute, limits.tokensPerMinute, now, 0};
+    }
+
+    double elapsedMinutes = std::max<int64_t>(now - state.updatedMs, 0) / MS_PER_MINUTE;
+    state.requests = std::min(limits.requestsPerMinute, state.requests + elapsedMinutes * limits.requestsPerMinute);
+    state.tokens = std::min(limits.tokensPerMinute, state.tokens + elapsedMinutes * limits.tokensPerMinute);
+    state.updatedMs = now;
+
+    update(state, now);
+    ::flock(bucket.fd, LOCK_UN);
+}
+
+} // namespace
+
+/**
+ * Loads the limits of a provider from its config.
+ */
+RateLimits RateLimiter::loadLimits(const std::string& provider) {
+    RateLimits limits;
+    limits.requestsPerMinute = ConfigManager::getProviderNumber(provider, "RATE_LIMIT_RPM", 0.0);
+    limits.tokensPerMinute = ConfigManager::getProviderNumber(provider, "RATE_LIMIT_TPM", 0.0);
+    return limits;
+}
+
+/**
+ * Waits until the provider's buckets allow a request, then takes from them.
+ */
+double RateLimiter::acquire(const std::string& provider, const Json::Value& payload, RetryPolicy& retry) {
+    size_t tokens = estimateTokens(payload);
+    retry.beforeRetry = [provider, tokens]() {
+        take(provider, tokens);
+    };
+    retry.onRateLimit = [provider](const HttpRateLimit& rateLimit) {
+        update(provider, rateLimit);
+    };
+    return take(provider, tokens);
+}
+
+/**
+ * Waits until the provider's buckets allow a request of some tokens, then takes from them.
+ */
+double RateLimiter::take(const std::string& provider, size_t estimatedTokens) {
+    Bucket* bucket = openBucket(provider);
+    if (bucket == nullptr) {
+        return 0.0;
+    }
+
+    // A request larger than the whole token budget only waits for a full bucket
+    RateLimits limits = loadLimits(provider);
+    double tokens = std::min(static_cast<double>(estimatedTokens), limits.tokensPerMinute);
+    double waitedMs = 0.0;
+    for (;;) {
+        double waitMs = 0.0;
+        withState(*bucket, limits, [&](SharedState& state, int64_t now) {
+            if (state.pausedUntilMs > now) {
+                waitMs = static_cast<double>(state.pausedUntilMs - now);
+                return;
+            }
+            if (limits.requestsPerMinute > 0 && state.requests < 1.0) {
+                waitMs = (1.0 - state.requests) / limits.requestsPerMinute * MS_PER_MINUTE;
+            }
+            if (limits.tokensPerMinute > 0 && state.tokens < tokens) {
+                waitMs = std::max(waitMs, (tokens - state.tokens) / limits.tokensPerMinute * MS_PER_MINUTE);
+            }
+            if (waitMs <= 0) {
+                state.requests -= limits.requestsPerMinute > 0 ? 1.0 : 0.0;
+                state.tokens -= tokens;
+            }
+        });
+        if (waitMs <= 0) {
+            return waitedMs;
+        }
+
+        // Another process may take the refill first, so check again after waiting
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(waitMs));
+        waitedMs += waitMs;
+    }
+}
+
+/**
+ * Adjusts the provider's buckets to the rate limit state it reported.
+ */
+void RateLimiter::update(const std::string& provider, const HttpRateLimit& rateLimit) {
+    Bucket* bucket = openBucket(provider);
+    if (bucket == nullptr) {
+        return;
+    }
+
+    withState(*bucket, loadLimits(provider), [&](SharedState& state, int64_t now) {
+        auto pauseFor = [&state, now](double delayMs) {
+            state.pausedUntilMs = std::max(state.pausedUntilMs, now + static_cast<int64_t>(delayMs));
+        };
+
+        // The provider's count wins when it is lower than ours
+        if (rateLimit.remainingRequests >= 0) {
+            state.requests = std::min(state.requests, rateLimit.remainingRequests);
+            if (rateLimit.remainingRequests < 1.0 && rateLimit.resetRequestsMs >= 0) {
+                pauseFor(rateLimit.resetRequestsMs);
+            }
+        }
+        if (rateLimit.remainingTokens >= 0) {
+            state.tokens = std::min(state.tokens, rateLimit.remainingTokens);
+            if (rateLimit.remainingTokens < 1.0 && rateLimit.resetTokensMs >= 0) {
+                pauseFor(rateLimit.resetTokensMs);
+            }
+        }
+        if (rateLimit.status == 429) {
+            pauseFor(rateLimit.retryAfterMs >= 0 ? rateLimit.retryAfterMs : DEFAULT_PAUSE_MS);
+        }
+    });
+}
+
+/**
+ * Estimates the tokens a chat request counts against a token limit.
+ */
+size_t RateLimiter::estimateTokens(const Json::Value& payload) {
+    size_t tokens = 0;
+    for (const Json::Value& message : payload["messages"]) {
+        tokens += TokenCounter::countMessage(message, nullptr);
+    }
+    for (const char* name : {"max_tokens", "max_completion_tokens"}) {
+        if (payload[name].isIntegral() && payload[name].asInt64() > 0) {
+            tokens += static_cast<size_t>(payload[name].asInt64());
+            break;
+        }
+    }
+    return tokens;
+}
+
+/**
+ * Gets the state file of a provider's buckets.
+ */
+std::string RateLimiter::getPath(const std::string& provider) {
+    return ConfigManager::getCacheDir() + "/ratelimit/" + sanitizeName(provider);
+}
@@ -0,0 +1,240 @@
+#include "response_cache.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "file_operations.h"
+#include "metrics.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+const long ResponseCache::DEFAULT_TTL_SECONDS = 86400;
+const long ResponseCache::DEFAULT_MAX_MB = 64;
+
+/**
+ * Checks if the cache is used for this run.
+ */
+bool ResponseCache::isEnabled() {
+    return !bypassFlag().load() && ConfigManager::getConfigFlag("RESPONSE_CACHE", false);
+}
+
+/**
+ * Disables the cache for this run (the --no-cache flag).
+ */
+void ResponseCache::setBypass(bool bypass) {
+    bypassFlag().store(bypass);
+}
+
+/**
+ * Computes the cache key of a request.
+ * Hashes the URL and every top-level member except "stream"; jsoncpp keeps
+ * object members sorted, so equal payloads always serialize the same way.
+ */
+std::string ResponseCache::makeKey(const std::string& apiUrl, const Json::Value& payload) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+    std::ostringstream canonical;
+    canonical << apiUrl << '\n';
+    for (const std::string& name : payload.getMemberNames()) {
+        if (name == "stream") {
+            continue;
+        }
+        canonical << name << '=';
+        writer->write(payload[name], &canonical);
+        canonical << '\n';
+    }
+    std::string data = canonical.str();
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    if (EVP_Digest(data.data(), data.size(), digest, &digestLength, EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("Failed to hash request payload");
+    }
+
+    static const char* HEX = "0123456789abcdef";
+    std::string key;
+    key.reserve(digestLength * 2);
+    for (unsigned int i = 0; i < digestLength; ++i) {
+        key += HEX[digest[i] >> 4];
+        key += HEX[digest[i] & 0x0f];
+    }
+    return key;
+}
+
+/**
+ * Looks up a stored reply and counts a hit or a miss.
+ */
+bool ResponseCache::lookup(const std::string& key, std::string& content) {
+    std::string path = getEntryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    bool hit = false;
+
+    std::string header;
+    if (file && std::getline(file, header)) {
+        size_t tab = header.find('\t');
+        if (tab != std::string::npos && header.compare(0, tab, ENTRY_MAGIC) == 0) {
+            time_t expiresAt = static_cast<time_t>(std::strtoll(header.c_str() + tab + 1, nullptr, 10));
+            if (std::time(nullptr) < expiresAt) {
+                std::ostringstream body;
+                body << file.rdbuf();
+                content = body.str();
+                hit = true;
+            }
+        }
+        file.close();
+
+        if (hit) {
+            ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0); // Mark as most recently used
+        } else {
+            FileOperations::remove(path); // Expired or unreadable
+        }
+    }
+
+    recordStats(hit ? 1 : 0, hit ? 0 : 1);
+    Metrics::recordCacheLookup(hit);
+    return hit;
+}
+
+/**
+ * Stores a reply and evicts least recently used entries above the size bound.
+ */
+void ResponseCache::store(const std::string& provider, const std::string& key, const std::string& content) {
+    long ttl = static_cast<long>(ConfigManager::getProviderNumber(provider, "RESPONSE_CACHE_TTL", DEFAULT_TTL_SECONDS));
+    long maxMb = static_cast<long>(ConfigManager::getProviderNumber(provider, "RESPONSE_CACHE_MAX_MB", DEFAULT_MAX_MB));
+
+    std::string path = getEntryPath(key);
+    std::string tempPath = FileOperations::makeTempPath(path);
+    try {
+        DirectoryOperations::create(getCacheDir());
+
+        std::string entry = std::string(ENTRY_MAGIC) + '\t' +
+                            std::to_string(static_cast<long long>(std::time(nullptr) + ttl)) + '\n' + content;
+        FileOperations::write(tempPath, entry);
+        if (!FileOperations::rename(tempPath, path)) {
+            throw std::runtime_error("cannot rename " + tempPath);
+        }
+
+        evict(static_cast<uint64_t>(maxMb) * 1024 * 1024);
+    } catch (const std::exception& e) {
+        FileOperations::remove(tempPath);
+        std::cerr << "Warning: Could not store cached response: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * Reads the hit and miss counters.
+ */
+ResponseCacheStats ResponseCache::getStats() {
+    std::ifstream file(getCacheDir() + "/stats");
+    std::ostringstream content;
+    content << file.rdbuf();
+    return parseStats(content.str());
+}
+
+/**
+ * Parses the content of the counters file.
+ */
+ResponseCacheStats ResponseCache::parseStats(const std::string& content) {
+    ResponseCacheStats stats;
+    std::istringstream lines(content);
+    std::string name;
+    uint64_t value = 0;
+    while (lines >> name >> value) {
+        if (name == "hits") {
+            stats.hits = value;
+        } else if (name == "misses") {
+            stats.misses = value;
+        }
+    }
+    return stats;
+}
+
+/**
+ * Gets the directory holding the cache entries.
+ */
+std::string ResponseCache::getCacheDir() {
+    return ConfigManager::getCacheDir() + "/responses";
+}
+
+/**
+ * Gets the flag set by --no-cache.
+ */
+std::atomic<bool>& ResponseCache::bypassFlag() {
+    static std::atomic<bool> bypass{false};
+    return bypass;
+}
+
+/**
+ * Adds to the shared counters under an exclusive file lock.
+ */
+void ResponseCache::recordStats(uint64_t hits, uint64_t misses) {
+    std::string path = getCacheDir() + "/stats";
+    try {
+        DirectoryOperations::create(getCacheDir());
+    } catch (const std::exception&) {
+        return; // Without a cache directory there are no counters to add to
+    }
+
+    FileOperations::updateLocked(path, [hits, misses](const std::string& content) {
+        ResponseCacheStats stats = parseStats(content);
+        return "hits " + std::to_string(stats.hits + hits) + "\nmisses " + std::to_string(stats.misses + misses) + "\n";
+    });
+}
+
+/**
+ * Removes least recently used entries until the cache fits its bound.
+ */
+void ResponseCache::evict(uint64_t maxBytes) {
+    struct Entry {
+        std::filesystem::path path;
+        uint64_t size;
+        std::filesystem::file_time_type lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t totalBytes = 0;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(getCacheDir(), ec)) {
+        if (item.path().extension() != ENTRY_EXTENSION) {
+            continue;
+        }
+        std::error_code entryEc;
+        uint64_t size = item.file_size(entryEc);
+        auto lastUsed = item.last_write_time(entryEc);
+        if (entryEc) {
+            continue; // Removed by another process meanwhile
+        }
+        entries.push_back({item.path(), size, lastUsed});
+        totalBytes += size;
+    }
+
+    if (totalBytes <= maxBytes) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (const Entry& entry : entries) {
+        if (totalBytes <= maxBytes) {
+            break;
+        }
+        std::filesystem::remove(entry.path, ec);
+        totalBytes -= entry.size;
+    }
+}
+
+/**
+ * Gets the path of an entry.
+ */
+std::string ResponseCache::getEntryPath(const std::string& key) {
+    return getCacheDir() + "/" + key + ENTRY_EXTENSION;
+}
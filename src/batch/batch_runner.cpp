@@ -0,0 +1,339 @@
+#include "batch_runner.h"
+#include "batch_writer.h"
+#include "file_operations.h"
+#include "api_models.h"
+#include "http_client.h"
+#include "provider_manager.h"
+#include "rate_limiter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+const size_t BatchRunner::DEFAULT_CONCURRENCY = 4;
+const size_t BatchRunner::MAX_CONCURRENCY = 32;
+
+/**
+ * Runs a batch.
+ */
+BatchSummary BatchRunner::run(const BatchOptions& options, const std::string& apiKey) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::string apiUrl = ProviderManager::getApiUrl();
+    if (apiUrl.empty()) {
+        throw std::runtime_error("No API URL configured for provider");
+    }
+    std::string defaultModel = options.model.empty() ? ProviderManager::getDefaultModel() : options.model;
+
+    // --retries overrides the attempts of the provider's retry policy
+    std::string provider = ProviderManager::getAgent();
+    RetryPolicy retry = ProviderManager::getRetryPolicy(provider);
+    if (options.maxRetries >= 0) {
+        retry.maxAttempts = options.maxRetries + 1;
+    }
+
+    std::vector<BatchJob> jobs = readJobs(options.inputPath, defaultModel);
+    std::unordered_set<std::string> completed = readCompletedIds(options.resumePath);
+
+    BatchSummary summary;
+    summary.total = jobs.size();
+
+    std::vector<const BatchJob*> pending;
+    pending.reserve(jobs.size());
+    for (const BatchJob& job : jobs) {
+        if (completed.count(job.id)) {
+            ++summary.skipped;
+        } else {
+            pending.push_back(&job);
+        }
+    }
+
+    // A resumed run continues the previous output instead of replacing it, once
+    // the lines of the jobs it sends again are gone
+    std::ofstream outputFile;
+    if (!options.outputPath.empty()) {
+        if (!completed.empty()) {
+            compactOutput(options.outputPath, completed);
+        }
+        outputFile.open(options.outputPath, completed.empty() ? std::ios::trunc : std::ios::app);
+        if (!outputFile) {
+            throw std::runtime_error("Cannot open output file: " + options.outputPath);
+        }
+    }
+    std::ofstream resumeFile;
+    if (!options.resumePath.empty()) {
+        resumeFile.open(options.resumePath, std::ios::app);
+        if (!resumeFile) {
+            throw std::runtime_error("Cannot open resume file: " + options.resumePath);
+        }
+    }
+
+    std::ostream& output = options.outputPath.empty() ? std::cout : outputFile;
+    BatchWriter writer(output, options.resumePath.empty() ? nullptr : &resumeFile, options.completionOrder);
+
+    // Progress goes to a terminal only; standard output may carry the results
+    bool showProgress = isatty(STDERR_FILENO) != 0;
+    std::mutex progressMutex;
+    std::atomic<size_t> nextIndex(0);
+
+    // Each worker claims the next unsent job; the writer puts the results in order
+    auto worker = [&]() {
+        for (size_t i = nextIndex++; i < pending.size(); i = nextIndex++) {
+            const BatchJob& job = *pending[i];
+            BatchResult result;
+            if (job.payload.isNull()) {
+                result.id = job.id;
+                result.model = job.model;
+                result.error = job.error;
+            } else {
+                result = execute(job, provider, apiUrl, apiKey, retry);
+            }
+            writer.write(i, result);
+
+            if (showProgress) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                std::cerr << "\rbatch: " << writer.getWritten() << "/" << pending.size()
+                          << " written, " << writer.getFailed() << " failed" << std::flush;
+            }
+        }
+    };
+
+    size_t workerCount = std::min(std::max<size_t>(options.concurrency, 1), pending.size());
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    if (showProgress && !pending.empty()) {
+        std::cerr << std::endl;
+    }
+
+    summary.failed = writer.getFailed();
+    summary.succeeded = writer.getWritten() - summary.failed;
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary;
+}
+
+/**
+ * Reads all jobs from a JSONL input.
+ */
+std::vector<BatchJob> BatchRunner::readJobs(const std::string& inputPath, const std::string& defaultModel) {
+    std::ifstream inputFile;
+    if (inputPath != "-") {
+        inputFile.open(inputPath);
+        if (!inputFile) {
+            throw std::runtime_error("Cannot open input file: " + inputPath);
+        }
+    }
+    std::istream& input = inputPath == "-" ? std::cin : inputFile;
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        jobs.push_back(parseJob(line, lineNumber, defaultModel));
+    }
+    return jobs;
+}
+
+/**
+ * Parses one input line into a job.
+ */
+BatchJob BatchRunner::parseJob(const std::string& line, size_t lineNumber, const std::string& defaultModel) {
+    BatchJob job;
+    job.lineNumber = lineNumber;
+    job.id = std::to_string(lineNumber);
+    job.model = defaultModel;
+
+    Json::Value data;
+    Json::CharReaderBuilder reader;
+    std::string errs;
+    std::istringstream stream(line);
+    if (!Json::parseFromStream(reader, stream, &data, &errs) || !data.isObject()) {
+        job.error = "Line " + std::to_string(lineNumber) + ": not a JSON object";
+        return job;
+    }
+
+    if (data.isMember("id") && !data["id"].isNull()) {
+        if (!data["id"].isConvertibleTo(Json::stringValue)) {
+            job.error = "Line " + std::to_string(lineNumber) + ": id must be a string or number";
+            return job;
+        }
+        job.id = data["id"].asString();
+    }
+    if (data["model"].isString() && !data["model"].asString().empty()) {
+        job.model = data["model"].asString();
+    }
+    if (job.model.empty()) {
+        job.error = "Line " + std::to_string(lineNumber) + ": no model given and no default model configured";
+        return job;
+    }
+
+    Json::Value messages(Json::arrayValue);
+    if (data["system"].isString()) {
+        Json::Value system;
+        system["role"] = "system";
+        system["content"] = data["system"];
+        messages.append(system);
+    }
+    if (data["messages"].isArray() && !data["messages"].empty()) {
+        for (const Json::Value& message : data["messages"]) {
+            messages.append(message);
+        }
+    } else if (data["prompt"].isString()) {
+        Json::Value user;
+        user["role"] = "user";
+        user["content"] = data["prompt"];
+        messages.append(user);
+    } else {
+        job.error = "Line " + std::to_string(lineNumber) + ": needs a \"prompt\" string or a \"messages\" array";
+        return job;
+    }
+
+    job.payload = ChatRequest(job.model, std::move(messages)).toJson();
+    if (data["params"].isObject()) {
+        for (const std::string& name : data["params"].getMemberNames()) {
+            job.payload[name] = data["params"][name];
+        }
+    }
+    return job;
+}
+
+/**
+ * Sends one job; HttpClient retries the transient failures.
+ */
+BatchResult BatchRunner::execute(const BatchJob& job, const std::string& provider, const std::string& apiUrl,
+                                 const std::string& apiKey, const RetryPolicy& retry) {
+    BatchResult result;
+    result.id = job.id;
+    result.model = job.model;
+
+    // Workers of all processes draw from the provider's shared budget; waiting is not latency
+    RetryPolicy jobRetry = retry;
+    RateLimiter::acquire(provider, job.payload, jobRetry);
+
+    HttpTimings timings;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    try {
+        std::string body = HttpClient::post(apiUrl + "/chat/completions", apiKey, job.payload,
+                                            &timings, nullptr, &jobRetry);
+        result.latencyMs = elapsedMs();
+
+        ChatResponse response(body);
+        if (response.hasError()) {
+            result.error = response.getErrorMessage();
+        } else {
+            result.content = response.getContent();
+            result.completionTokens = response.getCompletionTokens();
+        }
+    } catch (const std::exception& e) {
+        result.latencyMs = elapsedMs();
+        result.error = e.what();
+    }
+    result.attempts = static_cast<size_t>(timings.attempts);
+    return result;
+}
+
+/**
+ * Formats a result as one output line.
+ */
+std::string BatchRunner::formatResult(const BatchResult& result) {
+    Json::Value line;
+    line["id"] = result.id;
+    line["model"] = result.model;
+    if (result.isSuccess()) {
+        line["content"] = result.content;
+    } else {
+        line["error"] = result.error;
+    }
+    line["attempts"] = static_cast<Json::UInt64>(result.attempts);
+    line["latency_ms"] = std::round(result.latencyMs * 10.0) / 10.0;
+    if (result.completionTokens >= 0) {
+        line["completion_tokens"] = result.completionTokens;
+    }
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    writer["precision"] = 6;    // Keeps the rounded latency from printing as 155.19999999999999
+    return Json::writeString(writer, line);
+}
+
+/**
+ * Reads the ids recorded in a resume file.
+ */
+std::unordered_set<std::string> BatchRunner::readCompletedIds(const std::string& resumePath) {
+    std::unordered_set<std::string> ids;
+    if (resumePath.empty()) {
+        return ids;
+    }
+
+    std::ifstream file(resumePath);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            ids.insert(line);
+        }
+    }
+    return ids;
+}
+
+/**
+ * Rewrites the output of an interrupted run with one line per completed id.
+ */
+void BatchRunner::compactOutput(const std::string& outputPath, const std::unordered_set<std::string>& completed) {
+    std::ifstream input(outputPath);
+    if (!input) {
+        return;
+    }
+
+    std::string tempPath = outputPath + ".tmp";
+    std::ofstream output(tempPath, std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Cannot rewrite output file: " + outputPath);
+    }
+
+    Json::CharReaderBuilder reader;
+    std::unordered_set<std::string> kept;
+    std::string line;
+    while (std::getline(input, line)) {
+        Json::Value data;
+        std::string errs;
+        std::istringstream stream(line);
+        if (!Json::parseFromStream(reader, stream, &data, &errs) || !data.isObject()
+            || !data["id"].isString()) {
+            continue;
+        }
+        const std::string id = data["id"].asString();
+        if (!data.isMember("error") && completed.count(id) && kept.insert(id).second) {
+            output << line << '\n';
+        }
+    }
+    input.close();
+    output.close();
+
+    if (!output || !FileOperations::rename(tempPath, outputPath)) {
+        FileOperations::remove(tempPath);
+        throw std::runtime_error("Cannot rewrite output file: " + outputPath);
+    }
+}
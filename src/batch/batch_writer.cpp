@@ -0,0 +1,66 @@
+#include "batch_writer.h"
+
+/**
+ * Creates a writer.
+ */
+BatchWriter::BatchWriter(std::ostream& output, std::ostream* resumeLog, bool completionOrder)
+    : output_(output), resumeLog_(resumeLog), completionOrder_(completionOrder),
+      nextSequence_(0), written_(0), failed_(0) {
+}
+
+/**
+ * Writes a result, or holds it back until the results before it are written.
+ */
+void BatchWriter::write(size_t sequence, const BatchResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (completionOrder_) {
+        writeLine(result);
+        return;
+    }
+
+    if (sequence != nextSequence_) {
+        pending_.emplace(sequence, result);
+        return;
+    }
+
+    writeLine(result);
+    ++nextSequence_;
+
+    // Release the results that were waiting for this one
+    for (auto it = pending_.begin(); it != pending_.end() && it->first == nextSequence_;
+         it = pending_.erase(it)) {
+        writeLine(it->second);
+        ++nextSequence_;
+    }
+}
+
+/**
+ * Gets the number of results written so far.
+ */
+size_t BatchWriter::getWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+/**
+ * Gets the number of failed results written so far.
+ */
+size_t BatchWriter::getFailed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+/**
+ * Writes one result and records it in the resume log.
+ */
+void BatchWriter::writeLine(const BatchResult& result) {
+    output_ << BatchRunner::formatResult(result) << '\n' << std::flush;
+
+    ++written_;
+    if (!result.isSuccess()) {
+        ++failed_;
+    } else if (resumeLog_) {
+        *resumeLog_ << result.id << '\n' << std::flush;
+    }
+}
@@ -6,8 +6,8 @@
  * Runs a benchmark test on a single model
  */
 BenchmarkResult runModelBenchmark(const std::string &provider, const std::string &model, 
-                                  const std::string &apiKey, const std::string &testPrompt) {
-    return BenchmarkRunner::runSingleModel(provider, model, apiKey, testPrompt);
+                                  const std::string &apiKey, const BenchmarkOptions &options) {
+    return BenchmarkRunner::runSingleModel(provider, model, apiKey, options);
 }
 
 /**
@@ -20,8 +20,8 @@ std::vector<std::string> getAvailableModels(const std::string &apiKey) {
 /**
  * Runs benchmark tests on all available models for the current provider
  */
-std::vector<BenchmarkResult> runAllModelsBenchmark(const std::string &apiKey, const std::string &testPrompt) {
-    return BenchmarkRunner::runAllModels(apiKey, testPrompt);
+std::vector<BenchmarkResult> runAllModelsBenchmark(const std::string &apiKey, const BenchmarkOptions &options) {
+    return BenchmarkRunner::runAllModels(apiKey, options);
 }
 
 /**
@@ -1,10 +1,17 @@
 #include "benchmark_config.h"
+#include "config_manager.h"
+#include "token_counter.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
 
 // Default configuration constants
 const std::string BenchmarkConfig::DEFAULT_TEST_PROMPT = "1+1";
 const int BenchmarkConfig::DEFAULT_MAX_TOKENS = 50;
 const std::string BenchmarkConfig::TEMP_FILE_PREFIX = "/tmp/benchmark_payload_";
 const std::string BenchmarkConfig::TEMP_HISTORY_PREFIX = "/tmp/benchmark_history_";
+const size_t BenchmarkConfig::DEFAULT_CONCURRENCY = 1;
+const size_t BenchmarkConfig::MAX_CONCURRENCY = 32;
 
 std::string BenchmarkConfig::getDefaultTestPrompt() {
     return DEFAULT_TEST_PROMPT;
@@ -14,6 +21,46 @@ int BenchmarkConfig::getMaxTokens() {
     return DEFAULT_MAX_TOKENS;
 }
 
+size_t BenchmarkConfig::getConcurrencyLimit(const std::string& provider) {
+    double limit = ConfigManager::getProviderNumber(provider, "BENCHMARK_CONCURRENCY",
+                                                    static_cast<double>(MAX_CONCURRENCY));
+    limit = std::min(std::max(limit, 1.0), static_cast<double>(MAX_CONCURRENCY));
+    return static_cast<size_t>(limit);
+}
+
+size_t BenchmarkConfig::resolveConcurrency(size_t requested, const std::string& provider, size_t modelCount) {
+    size_t workers = std::min(requested, getConcurrencyLimit(provider));
+    workers = std::min(workers, modelCount);
+    return std::max<size_t>(workers, 1);
+}
+
+BenchmarkSortKey BenchmarkConfig::parseSortKey(const std::string& name) {
+    if (name == "total") {
+        return BenchmarkSortKey::TotalTime;
+    } else if (name == "ttft") {
+        return BenchmarkSortKey::TimeToFirstToken;
+    } else if (name == "connect") {
+        return BenchmarkSortKey::ConnectTime;
+    } else if (name == "tps") {
+        return BenchmarkSortKey::TokensPerSecond;
+    }
+    throw std::invalid_argument("Unknown sort metric '" + name + "' (expected total, ttft, connect or tps)");
+}
+
+bool BenchmarkConfig::requiresStreaming(BenchmarkSortKey key) {
+    return key != BenchmarkSortKey::TotalTime;
+}
+
+int BenchmarkConfig::estimateTokenCount(const std::string& text, const std::string& provider, const std::string& model) {
+    std::shared_ptr<const BpeTokenizer> tokenizer;
+    try {
+        tokenizer = TokenCounter::forModel(provider, model);
+    } catch (const std::exception&) {
+        // An unreadable vocabulary falls back to the length estimate
+    }
+    return static_cast<int>(TokenCounter::count(text, tokenizer.get()));
+}
+
 std::string BenchmarkConfig::getTempFilePrefix() {
     return TEMP_FILE_PREFIX;
 }
@@ -31,7 +78,7 @@ std::string BenchmarkConfig::getTempHistoryPath(const std::string& modelName) {
 }
 
 bool BenchmarkConfig::shouldSortByResponseTime() {
-    return true; // Default behavior: sort by response time
+    return true; // Default behavior: sort by the selected timing metric
 }
 
 bool BenchmarkConfig::shouldPrioritizeSuccessfulTests() {
@@ -39,5 +86,5 @@ bool BenchmarkConfig::shouldPrioritizeSuccessfulTests() {
 }
 
 int BenchmarkConfig::getResponseTimePrecision() {
-    return 0; // Default behavior: no decimal places for response time
+    return 1; // Timings have sub-millisecond resolution; show tenths of a millisecond
 }
@@ -1,28 +1,81 @@
 #include "benchmark_reporter.h"
 #include "benchmark.h"
 #include "benchmark_config.h"
+#include "http_client.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
 
 void BenchmarkReporter::displayTestStart(const std::string& model) {
+    if (isConcurrentMode()) {
+        return; // The whole line is printed with the result
+    }
+    std::lock_guard<std::mutex> lock(getOutputMutex());
     std::cout << "Testing " << model << "... " << std::flush;
 }
 
 void BenchmarkReporter::displayTestResult(const BenchmarkResult& result) {
-    if (result.success) {
-        std::cout << "✓ (" << formatResponseTime(result.responseTimeMs) << ")" << std::endl;
+    std::string outcome = formatTestOutcome(result);
+
+    std::lock_guard<std::mutex> lock(getOutputMutex());
+    if (isConcurrentMode()) {
+        std::cout << "Testing " << result.model << "... " << outcome << std::endl;
     } else {
-        // Determine the appropriate error message format
-        if (result.errorMessage.find("auto-blacklisted") != std::string::npos ||
-            result.errorMessage.find("Invalid response") != std::string::npos) {
-            std::cout << "✗ (Invalid response - auto-blacklisted)" << std::endl;
-        } else if (result.errorMessage.find("JSON parse error") != std::string::npos ||
-                   result.errorMessage.find("parse") != std::string::npos) {
-            std::cout << "✗ (JSON parse error)" << std::endl;
-        } else {
-            std::cout << "✗ (" << result.errorMessage << ")" << std::endl;
+        std::cout << outcome << std::endl;
+    }
+}
+
+void BenchmarkReporter::setConcurrentMode(bool enabled) {
+    std::lock_guard<std::mutex> lock(getOutputMutex());
+    getConcurrentModeFlag() = enabled;
+}
+
+std::mutex& BenchmarkReporter::getOutputMutex() {
+    static std::mutex outputMutex;
+    return outputMutex;
+}
+
+bool BenchmarkReporter::isConcurrentMode() {
+    return getConcurrentModeFlag().load();
+}
+
+std::atomic<bool>& BenchmarkReporter::getConcurrentModeFlag() {
+    static std::atomic<bool> concurrentMode(false);
+    return concurrentMode;
+}
+
+std::string BenchmarkReporter::formatTestOutcome(const BenchmarkResult& result) {
+    if (result.success) {
+        std::string outcome = "✓ (";
+        if (result.streamed) {
+            outcome += "TTFT " + formatResponseTime(result.timeToFirstTokenMs) + ", total ";
+        } else if (result.iterations > 1) {
+            outcome += "p50 ";
+        }
+        outcome += formatResponseTime(result.responseTimeMs);
+        if (result.streamed) {
+            outcome += ", " + formatThroughput(result.tokensPerSecond);
+        }
+        if (result.iterations > 1) {
+            outcome += ", " + std::to_string(result.successfulIterations) + "/" +
+                       std::to_string(result.iterations) + " ok";
         }
+        if (result.retries > 0) {
+            outcome += ", " + formatRetries(result.retries, result.backoffMs);
+        }
+        return outcome + ")";
+    }
+
+    // Determine the appropriate error message format
+    if (result.errorMessage.find("auto-blacklisted") != std::string::npos ||
+        result.errorMessage.find("Invalid response") != std::string::npos) {
+        return "✗ (Invalid response - auto-blacklisted)";
+    } else if (result.errorMessage.find("JSON parse error") != std::string::npos ||
+               result.errorMessage.find("parse") != std::string::npos) {
+        return "✗ (JSON parse error)";
     }
+    return "✗ (" + result.errorMessage + ")";
 }
 
 void BenchmarkReporter::displayBenchmarkHeader(const std::string& provider, const std::string& testPrompt) {
@@ -44,6 +97,18 @@ void BenchmarkReporter::displayNoModelsError(const std::string& provider) {
     std::cerr << "No models found for provider '" << provider << "'" << std::endl;
 }
 
+void BenchmarkReporter::displayIterations(size_t iterations, size_t warmup) {
+    std::cout << "Sending " << iterations << " timed request" << (iterations == 1 ? "" : "s");
+    if (warmup > 0) {
+        std::cout << " after " << warmup << " warm-up request" << (warmup == 1 ? "" : "s");
+    }
+    std::cout << " per model" << std::endl;
+}
+
+void BenchmarkReporter::displayConcurrency(size_t workerCount) {
+    std::cout << "Running " << workerCount << " tests in parallel" << std::endl;
+}
+
 void BenchmarkReporter::displayResults(const std::vector<BenchmarkResult>& results) {
     if (results.empty()) {
         std::cout << "No benchmark results to display." << std::endl;
@@ -69,6 +134,9 @@ void BenchmarkReporter::displayResults(const std::vector<BenchmarkResult>& resul
     // Display results sections
     if (!successful.empty()) {
         displaySuccessfulResults(successful);
+        if (HttpClient::isTimingsEnabled()) {
+            displayTimingsTable(successful);
+        }
     }
 
     if (!failed.empty()) {
@@ -80,6 +148,19 @@ void BenchmarkReporter::displayResults(const std::vector<BenchmarkResult>& resul
 }
 
 void BenchmarkReporter::displaySuccessfulResults(const std::vector<BenchmarkResult>& successful) {
+    for (const auto& result : successful) {
+        if (result.streamed) {
+            displayStreamingTable(successful);
+            return;
+        }
+    }
+    for (const auto& result : successful) {
+        if (result.iterations > 1) {
+            displayStatisticsTable(successful);
+            return;
+        }
+    }
+
     std::cout << "✓ Successful tests (sorted by speed):" << std::endl;
     for (size_t i = 0; i < successful.size(); ++i) {
         const auto& result = successful[i];
@@ -88,11 +169,120 @@ void BenchmarkReporter::displaySuccessfulResults(const std::vector<BenchmarkResu
     std::cout << std::endl;
 }
 
+void BenchmarkReporter::displayStatisticsTable(const std::vector<BenchmarkResult>& successful) {
+    size_t labelWidth = 0;
+    std::vector<std::string> labels = formatModelLabels(successful, labelWidth);
+
+    const int numberWidth = 5;
+    const int timeWidth = 11;
+
+    std::cout << "✓ Successful tests (sorted by median response time):" << std::endl;
+    std::cout << std::left << std::setw(numberWidth) << "#" << std::setw(static_cast<int>(labelWidth) + 2) << "Model"
+              << std::right
+              << std::setw(timeWidth) << "p50" << std::setw(timeWidth) << "mean"
+              << std::setw(timeWidth) << "min" << std::setw(timeWidth) << "p90"
+              << std::setw(timeWidth) << "p99" << std::setw(timeWidth) << "stddev"
+              << std::setw(9) << "success" << std::endl;
+
+    for (size_t i = 0; i < successful.size(); ++i) {
+        const auto& result = successful[i];
+        const LatencyStatistics& latency = result.latency;
+        std::cout << std::left << std::setw(numberWidth) << (std::to_string(i + 1) + ".")
+                  << std::setw(static_cast<int>(labelWidth) + 2) << labels[i]
+                  << std::right
+                  << std::setw(timeWidth) << formatResponseTime(latency.p50Ms)
+                  << std::setw(timeWidth) << formatResponseTime(latency.meanMs)
+                  << std::setw(timeWidth) << formatResponseTime(latency.minMs)
+                  << std::setw(timeWidth) << formatResponseTime(latency.p90Ms)
+                  << std::setw(timeWidth) << formatResponseTime(latency.p99Ms)
+                  << std::setw(timeWidth) << formatResponseTime(latency.stddevMs)
+                  << std::setw(9) << formatSuccessRate(result.successRate) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void BenchmarkReporter::displayStreamingTable(const std::vector<BenchmarkResult>& successful) {
+    size_t labelWidth = 0;
+    std::vector<std::string> labels = formatModelLabels(successful, labelWidth);
+    bool anyEstimated = false;
+    for (const auto& result : successful) {
+        anyEstimated = anyEstimated || result.outputTokensEstimated;
+    }
+
+    const int numberWidth = 5;
+    const int timeWidth = 11;
+
+    std::cout << "✓ Successful tests (streamed):" << std::endl;
+    std::cout << std::left << std::setw(numberWidth) << "#" << std::setw(static_cast<int>(labelWidth) + 2) << "Model"
+              << std::right
+              << std::setw(timeWidth) << "connect" << std::setw(timeWidth) << "TTFT"
+              << std::setw(timeWidth) << "total" << std::setw(8) << "tokens"
+              << std::setw(timeWidth + 2) << "speed" << std::setw(9) << "success" << std::endl;
+
+    for (size_t i = 0; i < successful.size(); ++i) {
+        const auto& result = successful[i];
+        std::string tokens = std::to_string(result.outputTokens) + (result.outputTokensEstimated ? "~" : "");
+        std::cout << std::left << std::setw(numberWidth) << (std::to_string(i + 1) + ".")
+                  << std::setw(static_cast<int>(labelWidth) + 2) << labels[i]
+                  << std::right
+                  << std::setw(timeWidth) << formatResponseTime(result.connectTimeMs)
+                  << std::setw(timeWidth) << formatResponseTime(result.timeToFirstTokenMs)
+                  << std::setw(timeWidth) << formatResponseTime(result.responseTimeMs)
+                  << std::setw(8) << tokens
+                  << std::setw(timeWidth + 2) << formatThroughput(result.tokensPerSecond)
+                  << std::setw(9) << formatSuccessRate(result.successRate) << std::endl;
+    }
+    if (anyEstimated) {
+        std::cout << "~ token count estimated; the provider did not report usage" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void BenchmarkReporter::displayTimingsTable(const std::vector<BenchmarkResult>& successful) {
+    size_t labelWidth = 0;
+    std::vector<std::string> labels = formatModelLabels(successful, labelWidth);
+
+    const int numberWidth = 5;
+    const int timeWidth = 11;
+    const int byteWidth = 10;
+
+    std::cout << "HTTP timings (median per phase):" << std::endl;
+    std::cout << std::left << std::setw(numberWidth) << "#" << std::setw(static_cast<int>(labelWidth) + 2) << "Model"
+              << std::right
+              << std::setw(timeWidth) << "dns" << std::setw(timeWidth) << "connect"
+              << std::setw(timeWidth) << "tls" << std::setw(timeWidth) << "write"
+              << std::setw(timeWidth) << "ttfb" << std::setw(timeWidth) << "transfer"
+              << std::setw(byteWidth) << "sent" << std::setw(byteWidth) << "received"
+              << "  connection" << std::endl;
+
+    for (size_t i = 0; i < successful.size(); ++i) {
+        const auto& result = successful[i];
+        const HttpTimings& timings = result.timings;
+        std::cout << std::left << std::setw(numberWidth) << (std::to_string(i + 1) + ".")
+                  << std::setw(static_cast<int>(labelWidth) + 2) << labels[i]
+                  << std::right
+                  << std::setw(timeWidth) << formatResponseTime(timings.dnsMs)
+                  << std::setw(timeWidth) << formatResponseTime(timings.connectMs)
+                  << std::setw(timeWidth) << formatResponseTime(timings.tlsMs)
+                  << std::setw(timeWidth) << formatResponseTime(timings.requestWriteMs)
+                  << std::setw(timeWidth) << formatResponseTime(timings.firstByteMs)
+                  << std::setw(timeWidth) << formatResponseTime(timings.transferMs)
+                  << std::setw(byteWidth) << (std::to_string(timings.bytesSent) + "B")
+                  << std::setw(byteWidth) << (std::to_string(timings.bytesReceived) + "B")
+                  << (timings.connectionReused ? "  reused" : "  new") << std::endl;
+    }
+    std::cout << std::endl;
+}
+
 void BenchmarkReporter::displayFailedResults(const std::vector<BenchmarkResult>& failed) {
     std::cout << "✗ Failed tests:" << std::endl;
     for (const auto& result : failed) {
         std::cout << result.model << " (" << result.provider << ") - " 
-                  << result.errorMessage << std::endl;
+                  << result.errorMessage;
+        if (result.retries > 0) {
+            std::cout << " (after " << formatRetries(result.retries, result.backoffMs) << ")";
+        }
+        std::cout << std::endl;
     }
     std::cout << std::endl;
 }
@@ -102,8 +292,12 @@ void BenchmarkReporter::displaySummary(const std::vector<BenchmarkResult>& resul
     size_t successfulCount = 0;
     size_t failedCount = 0;
     const BenchmarkResult* fastest = nullptr;
+    int retries = 0;
+    double backoffMs = 0.0;
 
     for (const auto& result : results) {
+        retries += result.retries;
+        backoffMs += result.backoffMs;
         if (result.success) {
             successfulCount++;
             if (fastest == nullptr || result.responseTimeMs < fastest->responseTimeMs) {
@@ -116,6 +310,9 @@ void BenchmarkReporter::displaySummary(const std::vector<BenchmarkResult>& resul
 
     // Display summary statistics
     std::cout << "Summary: " << successfulCount << " successful, " << failedCount << " failed" << std::endl;
+    if (retries > 0) {
+        std::cout << "Retried: " << formatRetries(retries, backoffMs) << std::endl;
+    }
     
     if (fastest != nullptr) {
         std::cout << "Fastest model: " << fastest->model << " (" 
@@ -130,6 +327,25 @@ std::string BenchmarkReporter::formatResponseTime(double timeMs) {
     return oss.str();
 }
 
+std::string BenchmarkReporter::formatThroughput(double tokensPerSecond) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << tokensPerSecond << " tok/s";
+    return oss.str();
+}
+
+std::string BenchmarkReporter::formatSuccessRate(double rate) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0) << (rate * 100.0) << "%";
+    return oss.str();
+}
+
+std::string BenchmarkReporter::formatRetries(int retries, double backoffMs) {
+    std::ostringstream oss;
+    oss << retries << (retries == 1 ? " retry, " : " retries, ")
+        << formatResponseTime(backoffMs) << " backoff";
+    return oss.str();
+}
+
 std::string BenchmarkReporter::formatModelEntry(const BenchmarkResult& result, size_t index) {
     std::ostringstream oss;
     if (index > 0) {
@@ -139,6 +355,19 @@ std::string BenchmarkReporter::formatModelEntry(const BenchmarkResult& result, s
     return oss.str();
 }
 
+std::vector<std::string> BenchmarkReporter::formatModelLabels(const std::vector<BenchmarkResult>& results,
+                                                               size_t& labelWidth) {
+    // Size the model column to the longest "model (provider)" label
+    std::vector<std::string> labels;
+    labels.reserve(results.size());
+    labelWidth = std::string("Model").size();
+    for (const auto& result : results) {
+        labels.push_back(result.model + " (" + result.provider + ")");
+        labelWidth = std::max(labelWidth, labels.back().size());
+    }
+    return labels;
+}
+
 void BenchmarkReporter::printSeparator() {
     std::cout << "=== BENCHMARK RESULTS ===";
 }
@@ -4,31 +4,34 @@
 #include "benchmark_request.h"
 #include "benchmark_response.h"
 #include "performance_timer.h"
+#include "benchmark_statistics.h"
 #include "benchmark_reporter.h"
+#include "rate_limiter.h"
 #include "system_utils.h"
 #include "string_utils.h"
 #include "provider_manager.h"
 #include "blacklist_manager.h"
 #include "http_client.h"
+#include "http_timings.h"
 #include "api_models.h"
+#include "model_catalog.h"
+#include "error_classifier.h"
+#include "metrics.h"
 #include <iostream>
 #include <algorithm>
-#include <cctype>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
 
 BenchmarkResult BenchmarkRunner::runSingleModel(const std::string& provider, 
                                                const std::string& model, 
                                                const std::string& apiKey,
-                                               const std::string& testPrompt) {
-    // Initialize result structure
-    BenchmarkResult result;
-    result.provider = provider;
-    result.model = model;
-    result.timestamp = SystemUtils::getCurrentTimestamp();
-    result.success = false;
-    result.responseTimeMs = 0.0;
-
+                                               const BenchmarkOptions& options) {
     // Use default test prompt if none provided
-    std::string actualTestPrompt = testPrompt.empty() ? BenchmarkConfig::getDefaultTestPrompt() : testPrompt;
+    std::string actualTestPrompt = options.testPrompt.empty() ? BenchmarkConfig::getDefaultTestPrompt()
+                                                              : options.testPrompt;
 
     // Validate API configuration
     std::string apiUrl = ProviderManager::getApiUrl();
@@ -36,23 +39,62 @@ BenchmarkResult BenchmarkRunner::runSingleModel(const std::string& provider,
         return createErrorResult(provider, model, "No API URL configured for provider");
     }
 
-    // Execute the request workflow
-    return executeModelRequest(provider, model, apiKey, actualTestPrompt, apiUrl);
+    // Display progress
+    BenchmarkReporter::displayTestStart(model);
+
+    // Warm-up requests come first and are discarded; they open the pooled
+    // connection so the timed requests do not pay for the handshake
+    std::vector<BenchmarkResult> trials;
+    trials.reserve(options.iterations);
+    size_t totalRequests = options.warmup + std::max<size_t>(options.iterations, 1);
+
+    for (size_t attempt = 0; attempt < totalRequests; ++attempt) {
+        BenchmarkResult trial = options.stream
+            ? executeStreamingRequest(provider, model, apiKey, actualTestPrompt, apiUrl)
+            : executeModelRequest(provider, model, apiKey, actualTestPrompt, apiUrl);
+        Metrics::recordModelRequest("benchmark", provider, model, trial.responseTimeMs / 1000.0,
+                                    trial.success ? "ok" : ErrorClassifier::toLabel(
+                                        ErrorClassifier::classify(-1, trial.errorMessage)));
+
+        // Check if this error indicates the model should be blacklisted
+        if (!trial.success &&
+            ErrorClassifier::shouldBlacklist(ErrorClassifier::classify(-1, trial.errorMessage))) {
+            {
+                // Keep the blacklist feedback from interleaving with concurrent progress lines
+                std::lock_guard<std::mutex> outputLock(BenchmarkReporter::getOutputMutex());
+                BlacklistManager::addModelToBlacklist(provider, model, trial.errorMessage);
+            }
+            trials.push_back(std::move(trial));
+            break; // Further requests would fail the same way
+        }
+
+        if (attempt >= options.warmup) {
+            trials.push_back(std::move(trial));
+        }
+    }
+
+    BenchmarkResult result = summarizeTrials(provider, model, trials);
+
+    // Display result
+    BenchmarkReporter::displayTestResult(result);
+
+    return result;
 }
 
 std::vector<BenchmarkResult> BenchmarkRunner::runAllModels(const std::string& apiKey,
-                                                          const std::string& testPrompt) {
+                                                          const BenchmarkOptions& options) {
     std::vector<BenchmarkResult> results;
     std::string provider = ProviderManager::getAgent();
 
     // Use default test prompt if none provided
-    std::string actualTestPrompt = testPrompt.empty() ? BenchmarkConfig::getDefaultTestPrompt() : testPrompt;
+    std::string actualTestPrompt = options.testPrompt.empty() ? BenchmarkConfig::getDefaultTestPrompt()
+                                                              : options.testPrompt;
 
     // Display benchmark header
     BenchmarkReporter::displayBenchmarkHeader(provider, actualTestPrompt);
 
     // Get all available models
-    std::vector<std::string> allModels = getAvailableModels(apiKey);
+    std::vector<std::string> allModels = getAvailableModels(apiKey, options.refreshModels, options.modelFilter);
     
     if (allModels.empty()) {
         BenchmarkReporter::displayNoModelsError(provider);
@@ -66,19 +108,67 @@ std::vector<BenchmarkResult> BenchmarkRunner::runAllModels(const std::string& ap
     // Display filtering information
     BenchmarkReporter::displayModelCounts(allModels.size(), blacklistedCount, modelsToTest.size());
 
-    // Test each non-blacklisted model
-    for (const std::string& model : modelsToTest) {
-        BenchmarkResult result = runSingleModel(provider, model, apiKey, actualTestPrompt);
-        results.push_back(result);
+    if (options.iterations > 1 || options.warmup > 0) {
+        BenchmarkReporter::displayIterations(options.iterations, options.warmup);
+    }
+
+    size_t workerCount = BenchmarkConfig::resolveConcurrency(options.concurrency, provider, modelsToTest.size());
+
+    if (workerCount > 1) {
+        BenchmarkReporter::displayConcurrency(workerCount);
+        results = runModelsConcurrently(provider, modelsToTest, apiKey, options, workerCount);
+    } else {
+        // Test each non-blacklisted model
+        results.reserve(modelsToTest.size());
+        for (const std::string& model : modelsToTest) {
+            results.push_back(runSingleModel(provider, model, apiKey, options));
+        }
     }
 
     // Sort results according to configuration
-    sortResults(results);
+    sortResults(results, options.sortBy);
+
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::runModelsConcurrently(const std::string& provider,
+                                                                   const std::vector<std::string>& models,
+                                                                   const std::string& apiKey,
+                                                                   const BenchmarkOptions& options,
+                                                                   size_t workerCount) {
+    std::vector<BenchmarkResult> results(models.size());
+    std::atomic<size_t> nextIndex(0);
+
+    // Each worker claims the next untested model; every slot is written by exactly one worker
+    auto worker = [&]() {
+        for (size_t i = nextIndex++; i < models.size(); i = nextIndex++) {
+            try {
+                results[i] = runSingleModel(provider, models[i], apiKey, options);
+            } catch (const std::exception& e) {
+                results[i] = createErrorResult(provider, models[i], e.what());
+                BenchmarkReporter::displayTestResult(results[i]);
+            }
+        }
+    };
+
+    BenchmarkReporter::setConcurrentMode(true);
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    BenchmarkReporter::setConcurrentMode(false);
 
     return results;
 }
 
-std::vector<std::string> BenchmarkRunner::getAvailableModels(const std::string& apiKey) {
+std::vector<std::string> BenchmarkRunner::getAvailableModels(const std::string& apiKey, bool refresh,
+                                                              const ModelFilter& filter) {
     std::vector<std::string> models;
     std::string apiUrl = ProviderManager::getApiUrl();
     std::string provider = ProviderManager::getAgent();
@@ -88,19 +178,17 @@ std::vector<std::string> BenchmarkRunner::getAvailableModels(const std::string&
         return models;
     }
 
-    // Use HttpClient for API request
-    std::string result = HttpClient::get(apiUrl + "/models", apiKey);
-    
-    // Parse using existing ModelsListResponse
-    ModelsListResponse response(result, provider);
-    
-    if (response.hasError()) {
-        std::cerr << "Error: " << response.getErrorMessage() << std::endl;
+    // Use the cached model catalog; it only hits the API once it has expired
+    ModelCatalogResult catalog;
+    try {
+        catalog = ModelCatalog::load(provider, apiUrl, apiKey, refresh);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
         return models;
     }
 
-    // Extract model IDs from response
-    return extractModelIds(response.getModels());
+    // Extract model IDs from the catalog
+    return extractModelIds(ModelCatalog::filter(catalog.models, filter));
 }
 
 std::vector<std::string> BenchmarkRunner::extractModelIds(const std::vector<ModelInfo>& models) {
@@ -123,29 +211,6 @@ Json::Value BenchmarkRunner::buildBenchmarkMessages(const std::string& testPromp
     return messages;
 }
 
-bool BenchmarkRunner::shouldBlacklistModel(const std::string& errorMessage) {
-    // Check for common error patterns that indicate incompatible models
-    const std::vector<std::string> blacklistPatterns = {
-        "does not support chat completions",
-        "model not found",
-        "model does not exist",
-        "invalid model",
-        "unsupported model",
-        "deprecated model"
-    };
-    
-    std::string lowerError = errorMessage;
-    std::transform(lowerError.begin(), lowerError.end(), lowerError.begin(), ::tolower);
-    
-    for (const std::string& pattern : blacklistPatterns) {
-        if (lowerError.find(pattern) != std::string::npos) {
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 std::vector<std::string> BenchmarkRunner::filterBlacklistedModels(
     const std::vector<std::string>& allModels, 
     const std::string& provider,
@@ -165,20 +230,34 @@ std::vector<std::string> BenchmarkRunner::filterBlacklistedModels(
     return modelsToTest;
 }
 
-void BenchmarkRunner::sortResults(std::vector<BenchmarkResult>& results) {
+void BenchmarkRunner::sortResults(std::vector<BenchmarkResult>& results, BenchmarkSortKey sortBy) {
     if (BenchmarkConfig::shouldSortByResponseTime()) {
-        std::sort(results.begin(), results.end(), [](const BenchmarkResult& a, const BenchmarkResult& b) {
+        std::stable_sort(results.begin(), results.end(), [sortBy](const BenchmarkResult& a, const BenchmarkResult& b) {
             if (BenchmarkConfig::shouldPrioritizeSuccessfulTests() && a.success != b.success) {
                 return a.success; // Successful tests first
             }
             if (a.success && b.success) {
-                return a.responseTimeMs < b.responseTimeMs; // Faster times first
+                return getSortValue(a, sortBy) < getSortValue(b, sortBy); // Best values first
             }
             return false; // Failed tests maintain their order
         });
     }
 }
 
+double BenchmarkRunner::getSortValue(const BenchmarkResult& result, BenchmarkSortKey sortBy) {
+    switch (sortBy) {
+        case BenchmarkSortKey::TimeToFirstToken:
+            return result.timeToFirstTokenMs;
+        case BenchmarkSortKey::ConnectTime:
+            return result.connectTimeMs;
+        case BenchmarkSortKey::TokensPerSecond:
+            return -result.tokensPerSecond; // Highest throughput first
+        case BenchmarkSortKey::TotalTime:
+        default:
+            return result.responseTimeMs;
+    }
+}
+
 BenchmarkResult BenchmarkRunner::createErrorResult(const std::string& provider, 
                                                   const std::string& model, 
                                                   const std::string& errorMessage) {
@@ -192,6 +271,91 @@ BenchmarkResult BenchmarkRunner::createErrorResult(const std::string& provider,
     return result;
 }
 
+BenchmarkResult BenchmarkRunner::summarizeTrials(const std::string& provider,
+                                                const std::string& model,
+                                                const std::vector<BenchmarkResult>& trials) {
+    BenchmarkResult result = createErrorResult(provider, model, "");
+    if (!trials.empty()) {
+        result.timestamp = trials.front().timestamp;
+    }
+
+    std::vector<double> samplesMs;
+    std::vector<double> connectSamples;
+    std::vector<double> firstTokenSamples;
+    std::vector<double> throughputSamples;
+    std::vector<double> tokenSamples;
+    std::vector<HttpTimings> timingSamples;
+    samplesMs.reserve(trials.size());
+
+    for (const BenchmarkResult& trial : trials) {
+        result.retries += trial.timings.attempts - 1;
+        result.backoffMs += trial.timings.backoffMs;
+        if (trial.success) {
+            samplesMs.push_back(trial.responseTimeMs);
+            timingSamples.push_back(trial.timings);
+            if (trial.streamed) {
+                connectSamples.push_back(trial.connectTimeMs);
+                firstTokenSamples.push_back(trial.timeToFirstTokenMs);
+                throughputSamples.push_back(trial.tokensPerSecond);
+                tokenSamples.push_back(trial.outputTokens);
+                result.outputTokensEstimated = result.outputTokensEstimated || trial.outputTokensEstimated;
+            }
+        } else {
+            result.errorMessage = trial.errorMessage; // Report the most recent failure
+        }
+    }
+
+    if (!tokenSamples.empty()) {
+        result.streamed = true;
+        result.connectTimeMs = BenchmarkStatistics::summarize(std::move(connectSamples)).p50Ms;
+        result.timeToFirstTokenMs = BenchmarkStatistics::summarize(std::move(firstTokenSamples)).p50Ms;
+        result.tokensPerSecond = BenchmarkStatistics::summarize(std::move(throughputSamples)).p50Ms;
+        result.outputTokens = static_cast<int>(BenchmarkStatistics::summarize(std::move(tokenSamples)).p50Ms + 0.5);
+    }
+
+    result.timings = summarizeTimings(timingSamples);
+    result.iterations = trials.size();
+    result.successfulIterations = samplesMs.size();
+    result.successRate = trials.empty() ? 0.0
+        : static_cast<double>(samplesMs.size()) / static_cast<double>(trials.size());
+    result.latency = BenchmarkStatistics::summarize(std::move(samplesMs));
+    result.success = result.successfulIterations > 0;
+    result.responseTimeMs = result.latency.p50Ms;
+
+    return result;
+}
+
+HttpTimings BenchmarkRunner::summarizeTimings(const std::vector<HttpTimings>& samples) {
+    HttpTimings summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    auto median = [&samples](double HttpTimings::*phase) {
+        std::vector<double> values;
+        values.reserve(samples.size());
+        for (const HttpTimings& sample : samples) {
+            values.push_back(sample.*phase);
+        }
+        return BenchmarkStatistics::summarize(std::move(values)).p50Ms;
+    };
+
+    summary.dnsMs = median(&HttpTimings::dnsMs);
+    summary.connectMs = median(&HttpTimings::connectMs);
+    summary.tlsMs = median(&HttpTimings::tlsMs);
+    summary.requestWriteMs = median(&HttpTimings::requestWriteMs);
+    summary.firstByteMs = median(&HttpTimings::firstByteMs);
+    summary.transferMs = median(&HttpTimings::transferMs);
+    summary.totalMs = median(&HttpTimings::totalMs);
+
+    // Byte counts and reuse describe the most recent request
+    summary.bytesSent = samples.back().bytesSent;
+    summary.bytesReceived = samples.back().bytesReceived;
+    summary.connectionReused = samples.back().connectionReused;
+
+    return summary;
+}
+
 BenchmarkResult BenchmarkRunner::executeModelRequest(const std::string& provider,
                                                     const std::string& model,
                                                     const std::string& apiKey,
@@ -208,35 +372,111 @@ BenchmarkResult BenchmarkRunner::executeModelRequest(const std::string& provider
     Json::Value messages = buildBenchmarkMessages(testPrompt);
 
     // Create chat request using existing API models
-    ChatRequest chatRequest(model, messages);
+    ChatRequest chatRequest(model, std::move(messages));
 
-    // Display progress
-    BenchmarkReporter::displayTestStart(model);
+    // Wait for the shared rate limit before the timer starts
+    RetryPolicy retry = ProviderManager::getRetryPolicy(provider);
+    RateLimiter::acquire(provider, chatRequest.toJson(), retry);
 
     // Execute timed API request using HttpClient
     PerformanceTimer timer;
     timer.start();
 
-    std::string response = HttpClient::post(apiUrl + "/chat/completions", apiKey, chatRequest.toJson());
+    try {
+        std::string response = HttpClient::post(apiUrl + "/chat/completions", apiKey, chatRequest.toJson(),
+                                                &result.timings, nullptr, &retry);
 
-    result.responseTimeMs = timer.stop();
+        result.responseTimeMs = timer.stop() - result.timings.retriedMs;
 
-    // Process response using ChatResponse
-    ChatResponse chatResponse(response);
-    
-    if (chatResponse.hasError()) {
-        result.errorMessage = chatResponse.getErrorMessage();
+        // Process response using ChatResponse
+        ChatResponse chatResponse(response);
         
-        // Check if this error indicates the model should be blacklisted
-        if (shouldBlacklistModel(chatResponse.getErrorMessage())) {
-            BlacklistManager::addModelToBlacklist(provider, model, chatResponse.getErrorMessage());
+        if (chatResponse.hasError()) {
+            result.errorMessage = chatResponse.getErrorMessage();
+        } else {
+            result.success = true;
         }
-    } else {
-        result.success = true;
+    } catch (const std::exception& e) {
+        // A failing model must not abort the whole run (or a worker thread)
+        if (timer.isRunning()) {
+            result.responseTimeMs = timer.stop() - result.timings.retriedMs;
+        }
+        result.errorMessage = e.what();
     }
 
-    // Display result
-    BenchmarkReporter::displayTestResult(result);
+    return result;
+}
+
+BenchmarkResult BenchmarkRunner::executeStreamingRequest(const std::string& provider,
+                                                        const std::string& model,
+                                                        const std::string& apiKey,
+                                                        const std::string& testPrompt,
+                                                        const std::string& apiUrl) {
+    BenchmarkResult result = createErrorResult(provider, model, "");
+    result.streamed = true;
+
+    // Build a streamed chat request that reports token usage at the end
+    ChatRequest chatRequest(model, buildBenchmarkMessages(testPrompt));
+    chatRequest.setStream(true);
+    chatRequest.setIncludeUsage(true);
+
+    PerformanceTimer timer;
+    bool firstToken = true;
+    ChatStreamParser parser([&](const std::string&) {
+        if (firstToken) {
+            result.timeToFirstTokenMs = timer.getElapsedMs();
+            firstToken = false;
+        }
+    });
+
+    RetryPolicy retry = ProviderManager::getRetryPolicy(provider);
+    RateLimiter::acquire(provider, chatRequest.toJson(), retry);
+    timer.start();
+
+    try {
+        HttpClient::postStream(apiUrl + "/chat/completions", apiKey, chatRequest.toJson(),
+            [&parser](const char* data, size_t length) {
+                return parser.feed(data, length);
+            }, &result.timings, nullptr, nullptr, &retry);
+        parser.finish();
+
+        result.responseTimeMs = timer.stop() - result.timings.retriedMs;
+    } catch (const std::exception& e) {
+        // A failing model must not abort the whole run (or a worker thread)
+        if (timer.isRunning()) {
+            result.responseTimeMs = timer.stop() - result.timings.retriedMs;
+        }
+        result.errorMessage = e.what();
+        return result;
+    }
+
+    if (parser.hasError()) {
+        result.errorMessage = parser.getErrorMessage();
+        return result;
+    }
+
+    result.success = true;
+    result.connectTimeMs = result.timings.setupMs();
+    // Only the last attempt delivers tokens, so both times are measured from its start
+    result.timeToFirstTokenMs -= result.timings.retriedMs;
+    if (firstToken) {
+        result.timeToFirstTokenMs = result.responseTimeMs; // No content at all
+    }
+
+    // Prefer the server's token count; estimate from the text if it sent none
+    result.outputTokens = parser.getCompletionTokens();
+    if (result.outputTokens < 0) {
+        result.outputTokens = BenchmarkConfig::estimateTokenCount(parser.getContent(), provider, model);
+        result.outputTokensEstimated = true;
+    }
+
+    // Generation speed after the first token, which excludes queueing and prompt processing
+    double generationMs = result.responseTimeMs - result.timeToFirstTokenMs;
+    if (result.outputTokens > 1 && generationMs > 0.0) {
+        result.tokensPerSecond = (result.outputTokens - 1) * 1000.0 / generationMs;
+    } else if (result.responseTimeMs > 0.0) {
+        result.tokensPerSecond = result.outputTokens * 1000.0 / result.responseTimeMs;
+    }
 
     return result;
 }
@@ -0,0 +1,50 @@
+#include "benchmark_statistics.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyStatistics BenchmarkStatistics::summarize(std::vector<double> samplesMs) {
+    LatencyStatistics stats;
+    if (samplesMs.empty()) {
+        return stats;
+    }
+
+    std::sort(samplesMs.begin(), samplesMs.end());
+
+    stats.samples = samplesMs.size();
+    stats.minMs = samplesMs.front();
+    stats.maxMs = samplesMs.back();
+
+    double sum = 0.0;
+    for (double sample : samplesMs) {
+        sum += sample;
+    }
+    stats.meanMs = sum / static_cast<double>(samplesMs.size());
+
+    if (samplesMs.size() > 1) {
+        double squaredDeviations = 0.0;
+        for (double sample : samplesMs) {
+            double deviation = sample - stats.meanMs;
+            squaredDeviations += deviation * deviation;
+        }
+        stats.stddevMs = std::sqrt(squaredDeviations / static_cast<double>(samplesMs.size() - 1));
+    }
+
+    stats.p50Ms = percentile(samplesMs, 50.0);
+    stats.p90Ms = percentile(samplesMs, 90.0);
+    stats.p99Ms = percentile(samplesMs, 99.0);
+
+    return stats;
+}
+
+double BenchmarkStatistics::percentile(const std::vector<double>& sortedSamples, double percentile) {
+    if (sortedSamples.size() == 1) {
+        return sortedSamples.front();
+    }
+
+    double rank = (percentile / 100.0) * static_cast<double>(sortedSamples.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+    double fraction = rank - static_cast<double>(lower);
+
+    return sortedSamples[lower] + (sortedSamples[upper] - sortedSamples[lower]) * fraction;
+}
@@ -43,6 +43,7 @@ bool PerformanceTimer::isRunning() const {
 }
 
 double PerformanceTimer::calculateDurationMs(const TimePoint& start, const TimePoint& end) const {
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    return static_cast<double>(duration.count());
+    // Keep sub-millisecond resolution; truncating to whole ms hides real differences
+    std::chrono::duration<double, std::milli> duration = end - start;
+    return duration.count();
 }
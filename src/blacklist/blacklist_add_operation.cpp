@@ -1,7 +1,7 @@
 #include "blacklist_add_operation.h"
 #include "blacklist_file_manager.h"
 #include "blacklist_parser.h"
-#include "blacklist_check_operation.h"
+#include "blacklist_index.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -92,10 +92,8 @@ bool BlacklistAddOperation::hasBeenExecuted() const {
  * Checks if the model is already blacklisted.
  */
 bool BlacklistAddOperation::isAlreadyBlacklisted() {
-    // Create a check operation to determine if already blacklisted
-    BlacklistCheckOperation checkOp(provider_, model_, fileManager_, parser_);
-    checkOp.execute();
-    return checkOp.isBlacklisted();
+    // Looking up the index also synchronizes it with the file before the append
+    return BlacklistIndex::contains(provider_, model_);
 }
 
 /**
@@ -108,6 +106,9 @@ void BlacklistAddOperation::performAdd() {
     try {
         // Append the entry to the blacklist file
         fileManager_->appendLine(entryLine);
+        
+        // Keep the in-memory index in sync without reloading the file
+        BlacklistIndex::update(provider_, model_, true);
     } catch (const std::runtime_error& e) {
         // Re-throw with more context
         throw std::runtime_error("Failed to write to blacklist file: " + std::string(e.what()));
@@ -0,0 +1,136 @@
+#include "blacklist_index.h"
+#include "blacklist_file_manager.h"
+#include "blacklist_parser.h"
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <sys/stat.h>
+
+/**
+ * Checks if a model is blacklisted for a provider.
+ */
+bool BlacklistIndex::contains(const std::string& provider, const std::string& model) {
+    State& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    refreshIfChanged(state);
+    return state.entries.count(makeKey(provider, model)) > 0;
+}
+
+/**
+ * Reloads the index if the blacklist file changed since it was loaded.
+ */
+void BlacklistIndex::synchronize() {
+    State& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    refreshIfChanged(state);
+}
+
+/**
+ * Records a change made to the blacklist file by this process.
+ */
+void BlacklistIndex::update(const std::string& provider, const std::string& model, bool blacklisted) {
+    State& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (!state.loaded) {
+        return; // Nothing cached yet; the next lookup loads the new file
+    }
+
+    if (blacklisted) {
+        state.entries.insert(makeKey(provider, model));
+    } else {
+        state.entries.erase(makeKey(provider, model));
+    }
+
+    // The index was synchronized just before the write, so with this change
+    // applied it matches the new content and can take over its signature
+    state.signature = readSignature(state.path);
+}
+
+/**
+ * Drops the index so that the next lookup reloads the file.
+ */
+void BlacklistIndex::invalidate() {
+    State& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.entries.clear();
+    state.loaded = false;
+}
+
+/**
+ * Gets the shared index state.
+ */
+BlacklistIndex::State& BlacklistIndex::getState() {
+    static State state;
+    return state;
+}
+
+/**
+ * Reloads the index if the file changed since it was loaded.
+ */
+void BlacklistIndex::refreshIfChanged(State& state) {
+    BlacklistFileManager fileManager;
+    if (state.path.empty()) {
+        state.path = fileManager.getBlacklistPath();
+    }
+
+    FileSignature current = readSignature(state.path);
+    if (state.loaded && current == state.signature) {
+        return;
+    }
+
+    state.entries.clear();
+    state.signature = current;
+    state.loaded = true;
+
+    if (!current.exists) {
+        return; // No blacklist file means nothing is blacklisted
+    }
+
+    try {
+        std::vector<std::string> lines = fileManager.readAllLines();
+        for (const std::string& line : lines) {
+            // Skip empty lines and comments
+            if (BlacklistParser::isEmptyLine(line) || BlacklistParser::isCommentLine(line)) {
+                continue;
+            }
+
+            ParsedBlacklistEntry entry = BlacklistParser::parseLine(line);
+            if (entry.isValid) {
+                state.entries.insert(makeKey(entry.provider, entry.model));
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        // Log error but don't crash - blacklist check should be resilient
+        std::cerr << "Warning: Error loading blacklist: " << e.what() << std::endl;
+        state.loaded = false;
+    }
+}
+
+/**
+ * Reads the current signature of a file.
+ */
+BlacklistIndex::FileSignature BlacklistIndex::readSignature(const std::string& path) {
+    FileSignature signature;
+    struct stat fileStat;
+
+    if (::stat(path.c_str(), &fileStat) == 0) {
+        signature.exists = true;
+        signature.size = fileStat.st_size;
+        signature.mtimeSec = fileStat.st_mtim.tv_sec;
+        signature.mtimeNsec = fileStat.st_mtim.tv_nsec;
+    }
+
+    return signature;
+}
+
+/**
+ * Builds the lookup key for a (provider, model) pair.
+ */
+std::string BlacklistIndex::makeKey(const std::string& provider, const std::string& model) {
+    // Provider names never contain the unit separator, so keys cannot collide
+    return provider + '\x1f' + model;
+}
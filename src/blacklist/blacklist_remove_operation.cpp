@@ -1,6 +1,7 @@
 #include "blacklist_remove_operation.h"
 #include "blacklist_file_manager.h"
 #include "blacklist_parser.h"
+#include "blacklist_index.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -113,6 +114,9 @@ bool BlacklistRemoveOperation::checkFileExists() {
  */
 void BlacklistRemoveOperation::performRemove() {
     try {
+        // Bring the index up to date so it can be updated in place afterwards
+        BlacklistIndex::synchronize();
+        
         // Read the entire blacklist file
         std::vector<std::string> lines = fileManager_->readAllLines();
         
@@ -122,6 +126,9 @@ void BlacklistRemoveOperation::performRemove() {
         // Only rewrite the file if we found and removed something
         if (modelFound_) {
             fileManager_->writeAllLines(filteredLines);
+            
+            // Keep the in-memory index in sync without reloading the file
+            BlacklistIndex::update(provider_, model_, false);
         }
         
     } catch (const std::runtime_error& e) {
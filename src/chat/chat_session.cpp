@@ -0,0 +1,85 @@
+#include "chat_session.h"
+#include "history_storage.h"
+#include "file_operations.h"
+#include "trace.h"
+#include <utility>
+
+/**
+ * Loads a conversation from its history file.
+ */
+ChatSession::ChatSession(const std::string& historyPath, const std::string& systemPrompt)
+    : historyPath_(historyPath), payload_(Json::objectValue), persistedCount_(0) {
+    TRACE_SCOPE("ChatSession::load");
+    Json::Value& messages = payload_["messages"];
+    messages = Json::Value(Json::arrayValue);
+
+    if (!systemPrompt.empty()) {
+        Json::Value systemMessage(Json::objectValue);
+        systemMessage["role"] = "system";
+        systemMessage["content"] = systemPrompt;
+        messages.append(std::move(systemMessage));
+    }
+
+    if (FileOperations::exists(historyPath_)) {
+        try {
+            HistoryStorage::readInto(historyPath_, messages);
+        } catch (const std::exception&) {
+            // If reading fails, continue with an empty conversation (maintains existing behavior)
+        }
+    }
+
+    persistedCount_ = messages.size();
+}
+
+/**
+ * Appends a message to the conversation.
+ */
+void ChatSession::addMessage(const std::string& role, const std::string& content) {
+    Json::Value message(Json::objectValue);
+    message["role"] = role;
+    message["content"] = content;
+    payload_["messages"].append(std::move(message));
+}
+
+/**
+ * Updates and returns the chat completion request payload.
+ */
+const Json::Value& ChatSession::buildRequestPayload(const std::string& model, bool stream) {
+    payload_["model"] = model;
+    if (stream) {
+        payload_["stream"] = true;
+    } else {
+        payload_.removeMember("stream");
+    }
+    return payload_;
+}
+
+/**
+ * Writes the messages added since the last persist to the history file.
+ */
+void ChatSession::persist() {
+    const Json::Value& messages = payload_["messages"];
+    HistoryStorage::appendAll(historyPath_, messages, persistedCount_);
+    persistedCount_ = messages.size();
+}
+
+/**
+ * Drops the messages added since the last persist.
+ */
+void ChatSession::discardUnsaved() {
+    payload_["messages"].resize(persistedCount_);
+}
+
+/**
+ * Gets the conversation messages, including the system prompt if set.
+ */
+const Json::Value& ChatSession::getMessages() const {
+    return payload_["messages"];
+}
+
+/**
+ * Gets the path of the history file backing this session.
+ */
+const std::string& ChatSession::getHistoryPath() const {
+    return historyPath_;
+}
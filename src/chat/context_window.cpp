@@ -0,0 +1,243 @@
+#include "context_window.h"
+#include "config_manager.h"
+#include "file_operations.h"
+#include "json_file_handler.h"
+#include "token_counter.h"
+#include "trace.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+const size_t ContextWindow::DEFAULT_KEEP_TURNS = 4;
+
+namespace {
+
+const char* SUMMARY_PREFIX = "Summary of the earlier conversation:\n";
+
+const char* SUMMARIZER_INSTRUCTIONS =
+    "You maintain a concise running summary of a conversation between a user and an assistant. "
+    "Keep facts, decisions, names, code identifiers and open questions; leave out pleasantries. "
+    "Reply with the updated summary only.";
+
+} // namespace
+
+/**
+ * Loads the trimming settings for a provider and model.
+ */
+ContextWindow::Policy ContextWindow::loadPolicy(const std::string& provider, const std::string& model) {
+    Policy policy;
+    policy.tokenBudget = static_cast<size_t>(
+        ConfigManager::getProviderNumber(provider, "CONTEXT_TOKEN_BUDGET", 0, model));
+    policy.keepTurns = static_cast<size_t>(
+        ConfigManager::getProviderNumber(provider, "CONTEXT_KEEP_TURNS", DEFAULT_KEEP_TURNS, model));
+
+    std::string mode = ConfigManager::getModelConfigValue(provider, model, "CONTEXT_POLICY");
+    std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+    policy.summarize = mode != "drop";
+
+    if (policy.isEnabled()) {
+        try {
+            policy.tokenizer = TokenCounter::forModel(provider, model);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: " << e.what() << "; estimating token counts" << std::endl;
+        }
+    }
+    return policy;
+}
+
+/**
+ * Builds a payload whose conversation fits the budget.
+ */
+bool ContextWindow::fit(const Json::Value& payload, const Policy& policy, const std::string& historyPath,
+                        const Summarizer& summarize, Json::Value& trimmed) {
+    TRACE_SCOPE("ContextWindow::fit");
+    if (!policy.isEnabled()) {
+        return false;
+    }
+
+    const Json::Value& messages = payload["messages"];
+    const Json::ArrayIndex count = messages.size();
+
+    // The system prompt leads the conversation and is always sent
+    Json::ArrayIndex first = 0;
+    while (first < count && messages[first]["role"].asString() == "system") {
+        ++first;
+    }
+    if (first == count) {
+        return false;
+    }
+
+    // suffixTokens[i] = estimated tokens of messages[i..count)
+    std::vector<size_t> suffixTokens(count + 1, 0);
+    for (Json::ArrayIndex i = count; i-- > 0;) {
+        suffixTokens[i] = suffixTokens[i + 1] + TokenCounter::countMessage(messages[i], policy.tokenizer.get());
+    }
+    const size_t pinnedTokens = suffixTokens[0] - suffixTokens[first];
+    if (suffixTokens[0] <= policy.tokenBudget) {
+        return false;
+    }
+
+    std::string summaryPath = getSummaryPath(historyPath);
+    Summary summary;
+    if (policy.summarize) {
+        summary = readSummary(summaryPath);
+        if (summary.covered >= count - first) {
+            summary = Summary(); // History was replaced or shortened
+        }
+    }
+
+    auto summaryCost = [&summary, &policy]() -> size_t {
+        if (summary.text.empty()) {
+            return 0;
+        }
+        return TokenCounter::count(SUMMARY_PREFIX + summary.text, policy.tokenizer.get()) +
+               TokenCounter::MESSAGE_OVERHEAD_TOKENS;
+    };
+    size_t summaryTokens = summaryCost();
+
+    Json::ArrayIndex start = first + summary.covered;
+    bool reusable = summary.covered > 0 &&
+                    pinnedTokens + summaryTokens + suffixTokens[start] <= policy.tokenBudget;
+
+    if (!reusable) {
+        Json::ArrayIndex tailStart = findTailStart(messages, first, policy.keepTurns);
+        if (policy.summarize && tailStart > start) {
+            try {
+                summary.text = extendSummary(summary.text, messages, start, tailStart, summarize);
+                summary.covered = tailStart - first;
+                summaryTokens = summaryCost();
+                writeSummary(summaryPath, summary);
+            } catch (const std::exception& e) {
+                // Keep the previous summary; the messages after it are dropped
+                std::cerr << "Warning: Could not summarize the conversation (" << e.what()
+                          << "); dropping older messages instead" << std::endl;
+            }
+        }
+        start = std::max(start, tailStart);
+    }
+
+    // Still too large: drop the oldest kept messages, never the latest one
+    while (start + 1 < count && pinnedTokens + summaryTokens + suffixTokens[start] > policy.tokenBudget) {
+        ++start;
+    }
+
+    // Copy everything but the message array, then add the kept messages
+    trimmed = Json::Value(Json::objectValue);
+    for (const std::string& name : payload.getMemberNames()) {
+        if (name != "messages") {
+            trimmed[name] = payload[name];
+        }
+    }
+
+    Json::Value& kept = trimmed["messages"];
+    kept = Json::Value(Json::arrayValue);
+    for (Json::ArrayIndex i = 0; i < first; ++i) {
+        kept.append(messages[i]);
+    }
+    if (!summary.text.empty()) {
+        Json::Value summaryMessage(Json::objectValue);
+        summaryMessage["role"] = "system";
+        summaryMessage["content"] = SUMMARY_PREFIX + summary.text;
+        kept.append(std::move(summaryMessage));
+    }
+    for (Json::ArrayIndex i = start; i < count; ++i) {
+        kept.append(messages[i]);
+    }
+
+    return true;
+}
+
+/**
+ * Gets the path of the rolling summary of a history file.
+ */
+std::string ContextWindow::getSummaryPath(const std::string& historyPath) {
+    return historyPath + ".summary";
+}
+
+/**
+ * Reads the rolling summary of a history file.
+ */
+ContextWindow::Summary ContextWindow::readSummary(const std::string& path) {
+    Summary summary;
+    if (!FileOperations::exists(path)) {
+        return summary;
+    }
+
+    try {
+        Json::Value json = JsonFileHandler::read(path);
+        if (json["covered"].isUInt() && json["summary"].isString()) {
+            summary.covered = json["covered"].asUInt();
+            summary.text = json["summary"].asString();
+        }
+    } catch (const std::exception&) {
+        // An unreadable summary is regenerated
+    }
+    return summary;
+}
+
+/**
+ * Writes the rolling summary of a history file.
+ */
+void ContextWindow::writeSummary(const std::string& path, const Summary& summary) {
+    Json::Value json(Json::objectValue);
+    json["covered"] = summary.covered;
+    json["summary"] = summary.text;
+
+    try {
+        JsonFileHandler::write(path, json);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Could not save conversation summary: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * Asks the summarizer to extend a summary with further messages.
+ */
+std::string ContextWindow::extendSummary(const std::string& previous, const Json::Value& messages,
+                                         Json::ArrayIndex begin, Json::ArrayIndex end,
+                                         const Summarizer& summarize) {
+    if (!summarize) {
+        throw std::runtime_error("no summarizer available");
+    }
+
+    std::string transcript = "Current summary:\n";
+    transcript += previous.empty() ? "(none)" : previous;
+    transcript += "\n\nNew messages:\n";
+    for (Json::ArrayIndex i = begin; i < end; ++i) {
+        transcript += messages[i]["role"].asString() + ": " + messages[i]["content"].asString() + "\n";
+    }
+
+    Json::Value request(Json::arrayValue);
+    Json::Value instructions(Json::objectValue);
+    instructions["role"] = "system";
+    instructions["content"] = SUMMARIZER_INSTRUCTIONS;
+    request.append(std::move(instructions));
+
+    Json::Value input(Json::objectValue);
+    input["role"] = "user";
+    input["content"] = std::move(transcript);
+    request.append(std::move(input));
+
+    std::string text = summarize(request);
+    if (text.empty()) {
+        throw std::runtime_error("empty summary");
+    }
+    return text;
+}
+
+/**
+ * Finds where the last turns to keep verbatim start.
+ */
+Json::ArrayIndex ContextWindow::findTailStart(const Json::Value& messages, Json::ArrayIndex first, size_t keepTurns) {
+    Json::ArrayIndex start = messages.size();
+    size_t turns = 0;
+    while (start > first && turns < keepTurns) {
+        --start;
+        if (messages[start]["role"].asString() == "user") {
+            ++turns;
+        }
+    }
+    // Always keep at least the latest message
+    return std::min<Json::ArrayIndex>(start, messages.size() - 1);
+}
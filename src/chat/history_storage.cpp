@@ -0,0 +1,275 @@
+#include "history_storage.h"
+#include "context_window.h"
+#include "file_operations.h"
+#include "config_manager.h"
+#include "trace.h"
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+const std::string HistoryStorage::EXTENSION = ".jsonl";
+const std::string HistoryStorage::LEGACY_EXTENSION = ".json";
+
+/**
+ * Reads all messages of a history file in either format.
+ */
+Json::Value HistoryStorage::read(const std::string& path) {
+    Json::Value messages(Json::arrayValue);
+    readInto(path, messages);
+    return messages;
+}
+
+/**
+ * Reads all messages of a history file and appends them to an existing array.
+ */
+void HistoryStorage::readInto(const std::string& path, Json::Value& messages) {
+    TRACE_SCOPE("HistoryStorage::readInto");
+    std::string content = FileOperations::read(path);
+
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errors;
+
+    if (isLegacyFormat(content)) {
+        Json::Value legacy;
+        if (!reader->parse(content.data(), content.data() + content.size(), &legacy, &errors)) {
+            throw std::runtime_error("Failed to parse history file: " + path + " - " + errors);
+        }
+        for (auto& message : legacy) {
+            messages.append(std::move(message));
+        }
+        return;
+    }
+
+    size_t start = 0;
+    while (start < content.size()) {
+        size_t end = content.find('\n', start);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+
+        // A line that does not parse is a torn append and only loses that message
+        Json::Value message;
+        if (end > start && reader->parse(content.data() + start, content.data() + end, &message, &errors)) {
+            messages.append(std::move(message));
+        }
+
+        start = end + 1;
+    }
+}
+
+/**
+ * Finds the first message with the given role without loading the whole file.
+ */
+std::string HistoryStorage::findFirstMessage(const std::string& path, const std::string& role) {
+    try {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return "";
+        }
+
+        // Legacy files are a single JSON document and have to be parsed as a whole
+        file >> std::ws;
+        if (file.peek() == '[') {
+            file.close();
+            for (const auto& message : read(path)) {
+                if (message["role"].asString() == role && message.isMember("content")) {
+                    return message["content"].asString();
+                }
+            }
+            return "";
+        }
+
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        std::string line;
+        std::string errors;
+
+        while (std::getline(file, line)) {
+            Json::Value message;
+            if (line.empty() || !reader->parse(line.data(), line.data() + line.size(), &message, &errors)) {
+                continue;
+            }
+            if (message["role"].asString() == role && message.isMember("content")) {
+                return message["content"].asString();
+            }
+        }
+    } catch (const std::exception&) {
+        // Unreadable files have no first message (handled by caller)
+    }
+
+    return "";
+}
+
+/**
+ * Appends a single message to a history file, creating it if needed.
+ */
+void HistoryStorage::append(const std::string& path, const Json::Value& message) {
+    Json::Value messages(Json::arrayValue);
+    messages.append(message);
+    appendAll(path, messages);
+}
+
+/**
+ * Appends several messages to a history file in one write.
+ */
+void HistoryStorage::appendAll(const std::string& path, const Json::Value& messages,
+                               Json::ArrayIndex first) {
+    TRACE_SCOPE("HistoryStorage::appendAll");
+    if (first >= messages.size()) {
+        return;
+    }
+    appendRaw(path, serializeLines(messages, first));
+}
+
+/**
+ * Writes a complete history file, replacing any existing content.
+ * The file is written next to the target and renamed into place, so a
+ * crash never leaves a half-written conversation behind.
+ */
+void HistoryStorage::write(const std::string& path, const Json::Value& messages) {
+    TRACE_SCOPE("HistoryStorage::write");
+    std::string tempPath = path + ".tmp";
+    FileOperations::remove(tempPath);
+
+    appendRaw(tempPath, serializeLines(messages));
+
+    if (!FileOperations::rename(tempPath, path)) {
+        FileOperations::remove(tempPath);
+        throw std::runtime_error("Failed to replace history file: " + path);
+    }
+}
+
+/**
+ * Converts a legacy JSON array history file to the line-delimited format.
+ */
+void HistoryStorage::migrate(const std::string& legacyPath, const std::string& targetPath) {
+    Json::Value messages = read(legacyPath);
+    write(targetPath, messages);
+
+    if (legacyPath != targetPath) {
+        // The summary covers the same messages, so it stays valid for the new file
+        std::string legacySummary = ContextWindow::getSummaryPath(legacyPath);
+        if (FileOperations::exists(legacySummary)) {
+            FileOperations::rename(legacySummary, ContextWindow::getSummaryPath(targetPath));
+        }
+        FileOperations::remove(legacyPath);
+    }
+}
+
+/**
+ * Moves a history file together with its rolling summary.
+ */
+bool HistoryStorage::rename(const std::string& oldPath, const std::string& newPath) {
+    if (!FileOperations::rename(oldPath, newPath)) {
+        return false;
+    }
+    std::string summaryPath = ContextWindow::getSummaryPath(oldPath);
+    if (FileOperations::exists(summaryPath)) {
+        FileOperations::rename(summaryPath, ContextWindow::getSummaryPath(newPath));
+    }
+    return true;
+}
+
+/**
+ * Checks if a filename has a history file extension (current or legacy).
+ */
+bool HistoryStorage::isHistoryFile(const std::string& filename) {
+    return endsWith(filename, EXTENSION) || endsWith(filename, LEGACY_EXTENSION);
+}
+
+/**
+ * Removes the history file extension (current or legacy) from a filename.
+ */
+std::string HistoryStorage::stripExtension(const std::string& filename) {
+    if (endsWith(filename, EXTENSION) && filename.length() > EXTENSION.length()) {
+        return filename.substr(0, filename.length() - EXTENSION.length());
+    }
+    if (endsWith(filename, LEGACY_EXTENSION) && filename.length() > LEGACY_EXTENSION.length()) {
+        return filename.substr(0, filename.length() - LEGACY_EXTENSION.length());
+    }
+    return filename;
+}
+
+/**
+ * Serializes messages into newline-terminated compact JSON lines.
+ */
+std::string HistoryStorage::serializeLines(const Json::Value& messages, Json::ArrayIndex first) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+
+    std::string lines;
+    for (Json::ArrayIndex i = first; i < messages.size(); ++i) {
+        lines += Json::writeString(builder, messages[i]);
+        lines += '\n';
+    }
+    return lines;
+}
+
+/**
+ * Appends raw data to a file with a single O_APPEND write.
+ */
+void HistoryStorage::appendRaw(const std::string& path, const std::string& data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open history file for appending: " + path +
+                                 " - " + std::strerror(errno));
+    }
+
+    // Start on a fresh line if a previous append was torn, so only that message is lost
+    std::string buffer;
+    const std::string* output = &data;
+    struct stat fileStat;
+    char lastByte = '\n';
+    if (::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0 &&
+        ::pread(fd, &lastByte, 1, fileStat.st_size - 1) == 1 && lastByte != '\n') {
+        buffer = "\n" + data;
+        output = &buffer;
+    }
+
+    const char* cursor = output->data();
+    size_t remaining = output->size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Failed to write history file: " + path +
+                                     " - " + std::strerror(error));
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (ConfigManager::getConfigFlag("HISTORY_FSYNC", false)) {
+        ::fdatasync(fd);
+    }
+
+    ::close(fd);
+}
+
+/**
+ * Checks if file content uses the legacy JSON array format.
+ */
+bool HistoryStorage::isLegacyFormat(const std::string& content) {
+    size_t first = content.find_first_not_of(" \t\r\n");
+    return first != std::string::npos && content[first] == '[';
+}
+
+/**
+ * Checks if a string ends with the given suffix.
+ */
+bool HistoryStorage::endsWith(const std::string& text, const std::string& suffix) {
+    return text.length() >= suffix.length() &&
+           text.compare(text.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
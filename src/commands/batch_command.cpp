@@ -0,0 +1,133 @@
+#include "commands/batch_command.h"
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a BatchCommand with the provided configuration.
+ */
+BatchCommand::BatchCommand(const std::vector<std::string>& commandArgs,
+                           const ApplicationSetup::Config& config)
+    : Command(commandArgs, config.apiKey, config.provider, config.currentHistory, config.historyDir) {
+}
+
+/**
+ * @brief Executes the batch command.
+ */
+void BatchCommand::execute() {
+    BatchOptions options = parseOptions();
+
+    BatchSummary summary = BatchRunner::run(options, apiKey);
+
+    std::cerr << std::fixed << std::setprecision(1)
+              << "Batch: " << summary.total << " jobs, " << summary.succeeded << " succeeded, "
+              << summary.failed << " failed, " << summary.skipped << " skipped (resumed) in "
+              << summary.seconds << " s" << std::endl;
+
+    if (summary.failed > 0) {
+        throw std::runtime_error(std::to_string(summary.failed) + " batch job(s) failed; see the \"error\" fields"
+                                 + (options.resumePath.empty() ? "" : " and rerun with the same --resume file to retry them"));
+    }
+}
+
+/**
+ * @brief Validates that an input is given and the options are well-formed.
+ */
+void BatchCommand::validateArgs() const {
+    parseOptions();
+}
+
+/**
+ * @brief Gets the command name.
+ */
+std::string BatchCommand::getCommandName() const {
+    return "batch";
+}
+
+/**
+ * @brief Parses the batch options from the command arguments.
+ */
+BatchOptions BatchCommand::parseOptions() const {
+    BatchOptions options;
+    options.concurrency = BatchRunner::DEFAULT_CONCURRENCY;
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+
+        std::string name = arg;
+        std::string value;
+        bool hasInlineValue = false;
+
+        // Accept both "--option value" and "--option=value"
+        size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && equals != std::string::npos) {
+            name = arg.substr(0, equals);
+            value = arg.substr(equals + 1);
+            hasInlineValue = true;
+        }
+
+        if (name == "-o" || name == "--output" || name == "--concurrency" || name == "--order" ||
+            name == "--resume" || name == "--retries" || name == "--model") {
+            if (!hasInlineValue) {
+                if (i + 1 >= args.size()) {
+                    throw std::invalid_argument(name + " option requires a value");
+                }
+                value = args[++i];
+            }
+
+            if (name == "-o" || name == "--output") {
+                options.outputPath = value == "-" ? "" : value;
+            } else if (name == "--concurrency") {
+                options.concurrency = parseCount(name, value, 1);
+                if (options.concurrency > BatchRunner::MAX_CONCURRENCY) {
+                    throw std::invalid_argument("--concurrency is limited to "
+                                                + std::to_string(BatchRunner::MAX_CONCURRENCY));
+                }
+            } else if (name == "--order") {
+                if (value != "input" && value != "completion") {
+                    throw std::invalid_argument("--order expects 'input' or 'completion', got '" + value + "'");
+                }
+                options.completionOrder = value == "completion";
+            } else if (name == "--resume") {
+                options.resumePath = value;
+            } else if (name == "--retries") {
+                options.maxRetries = static_cast<int>(parseCount(name, value, 0));
+            } else {
+                options.model = value;
+            }
+        } else if (arg.rfind("--", 0) == 0 || (arg.size() > 1 && arg[0] == '-')) {
+            throw std::invalid_argument("Unknown batch option: " + arg);
+        } else if (options.inputPath.empty()) {
+            options.inputPath = arg;
+        } else {
+            throw std::invalid_argument("Unexpected batch argument: " + arg);
+        }
+    }
+
+    if (options.inputPath.empty()) {
+        throw std::invalid_argument("Usage: aith batch <input.jsonl|-> [-o output.jsonl] [--concurrency N] "
+                                    "[--order input|completion] [--resume FILE] [--retries N] [--model NAME]");
+    }
+    if (!options.outputPath.empty() && options.outputPath == options.resumePath) {
+        throw std::invalid_argument("The resume file must differ from the output file");
+    }
+
+    return options;
+}
+
+/**
+ * @brief Parses a non-negative count option value.
+ */
+size_t BatchCommand::parseCount(const std::string& option, const std::string& value, size_t minimum) {
+    try {
+        size_t consumed = 0;
+        long count = std::stol(value, &consumed);
+        if (consumed == value.size() && count >= 0 && static_cast<size_t>(count) >= minimum) {
+            return static_cast<size_t>(count);
+        }
+    } catch (const std::exception&) {
+        // Fall through to the error below
+    }
+    std::string expected = minimum > 0 ? "a positive integer" : "a non-negative integer";
+    throw std::invalid_argument(option + " expects " + expected + ", got '" + value + "'");
+}
@@ -14,12 +14,12 @@ BenchmarkCommand::BenchmarkCommand(const std::vector<std::string>& args, const A
 void BenchmarkCommand::execute() {
     validateArgs();
     
-    std::string testPrompt = getTestPrompt();
+    BenchmarkOptions options = parseOptions();
     
     std::cout << "Starting model benchmark tests..." << std::endl;
     
     try {
-        auto results = runAllModelsBenchmark(config_.apiKey, testPrompt);
+        auto results = runAllModelsBenchmark(config_.apiKey, options);
         displayBenchmarkResults(results);
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to run benchmark tests: " + std::string(e.what()));
@@ -37,6 +37,9 @@ void BenchmarkCommand::validateArgs() const {
     if (command != "test" && command != "benchmark") {
         throw std::invalid_argument("Invalid benchmark command: " + command);
     }
+    
+    // Reject malformed options before any request is made
+    parseOptions();
 }
 
 std::string BenchmarkCommand::getCommandName() const {
@@ -46,12 +49,81 @@ std::string BenchmarkCommand::getCommandName() const {
     return "test";
 }
 
-std::string BenchmarkCommand::getTestPrompt() const {
-    // If a custom test prompt was provided, use it
-    if (args_.size() > 1) {
-        return args_[1];
+BenchmarkOptions BenchmarkCommand::parseOptions() const {
+    BenchmarkOptions options;
+    options.testPrompt = DEFAULT_TEST_PROMPT;
+    options.concurrency = BenchmarkConfig::DEFAULT_CONCURRENCY;
+    
+    bool promptSet = false;
+    for (size_t i = 1; i < args_.size(); ++i) {
+        const std::string& arg = args_[i];
+        
+        std::string name = arg;
+        std::string value;
+        bool hasInlineValue = false;
+        
+        // Accept both "--option value" and "--option=value"
+        size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && equals != std::string::npos) {
+            name = arg.substr(0, equals);
+            value = arg.substr(equals + 1);
+            hasInlineValue = true;
+        }
+        
+        if (arg == "--stream") {
+            options.stream = true;
+        } else if (arg == "--refresh") {
+            options.refreshModels = true;
+        } else if (name == "--concurrency" || name == "--iterations" || name == "--warmup" || name == "--sort" ||
+                   name == "--owner" || name == "--prefix") {
+            if (!hasInlineValue) {
+                if (i + 1 >= args_.size()) {
+                    throw std::invalid_argument(name + " option requires a value");
+                }
+                value = args_[++i];
+            }
+            
+            if (name == "--concurrency") {
+                options.concurrency = parseCount(name, value, 1);
+            } else if (name == "--iterations") {
+                options.iterations = parseCount(name, value, 1);
+            } else if (name == "--sort") {
+                options.sortBy = BenchmarkConfig::parseSortKey(value);
+            } else if (name == "--owner") {
+                options.modelFilter.owner = value;
+            } else if (name == "--prefix") {
+                options.modelFilter.prefix = value;
+            } else {
+                options.warmup = parseCount(name, value, 0);
+            }
+        } else if (arg.rfind("--", 0) == 0 && arg.size() > 2) {
+            throw std::invalid_argument("Unknown benchmark option: " + arg);
+        } else if (!promptSet) {
+            // The first non-option argument is the custom test prompt
+            options.testPrompt = arg;
+            promptSet = true;
+        } else {
+            throw std::invalid_argument("Unexpected benchmark argument: " + arg);
+        }
+    }
+    
+    if (!options.stream && BenchmarkConfig::requiresStreaming(options.sortBy)) {
+        throw std::invalid_argument("Sorting by connect time, TTFT or tokens/s requires --stream");
     }
     
-    // Otherwise, use the default test prompt
-    return DEFAULT_TEST_PROMPT;
+    return options;
+}
+
+size_t BenchmarkCommand::parseCount(const std::string& option, const std::string& value, size_t minimum) {
+    try {
+        size_t consumed = 0;
+        long count = std::stol(value, &consumed);
+        if (consumed == value.size() && count >= 0 && static_cast<size_t>(count) >= minimum) {
+            return static_cast<size_t>(count);
+        }
+    } catch (const std::exception&) {
+        // Fall through to the error below
+    }
+    std::string expected = minimum > 0 ? "a positive integer" : "a non-negative integer";
+    throw std::invalid_argument(option + " expects " + expected + ", got '" + value + "'");
 }
@@ -6,6 +6,11 @@
 #include "blacklist_command.h"
 #include "help_command.h"
 #include "config_command.h"
+#include "tokens_command.h"
+#include "batch_command.h"
+#include "race_command.h"
+#include "repl_command.h"
+#include "serve_command.h"
 #include <stdexcept>
 #include <unordered_map>
 #include <functional>
@@ -38,6 +43,26 @@ CommandFactory::getCommandCreators()
          {
              return std::make_unique<ConfigCommand>(args, config);
          }},
+        {"tokens", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
+         {
+             return std::make_unique<TokensCommand>(args, config);
+         }},
+        {"batch", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
+         {
+             return std::make_unique<BatchCommand>(args, config);
+         }},
+        {"race", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
+         {
+             return std::make_unique<RaceCommand>(args, config);
+         }},
+        {"repl", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
+         {
+             return std::make_unique<ReplCommand>(args, config);
+         }},
+        {"serve", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
+         {
+             return std::make_unique<ServeCommand>(args, config);
+         }},
         {"new", [](const std::vector<std::string> &args, const ApplicationSetup::Config &config)
          {
              return std::make_unique<ChatCommand>(args, config);
@@ -1,22 +1,33 @@
 #include "commands/command_line_parser.h"
 #include "core/provider_manager.h"
+#include "http/http_client.h"
+#include "api/response_cache.h"
+#include "trace/trace.h"
 #include <iostream>
+#include <utility>
 
 /**
  * @brief Parses command line arguments and processes special flags.
  * 
- * Processes special arguments like --provider/--p and sets up the
- * ProviderManager accordingly. Returns the remaining arguments for
- * command processing.
+ * Processes special arguments like --provider/--p, --timings, --no-cache and
+ * --trace and sets up the ProviderManager, HttpClient, ResponseCache and Trace
+ * accordingly.
+ * Returns the remaining arguments for command processing.
  */
 CommandLineParser::ParsedArgs CommandLineParser::parseArguments(int argc, char* argv[]) {
-    ParsedArgs result;
-    
     // Store all arguments in a vector for easier processing
     std::vector<std::string> args;
     for (int i = 1; i < argc; ++i) {
         args.push_back(argv[i]);
     }
+    return parseArguments(std::move(args));
+}
+
+/**
+ * @brief Parses command line arguments without the program name.
+ */
+CommandLineParser::ParsedArgs CommandLineParser::parseArguments(std::vector<std::string> args) {
+    ParsedArgs result;
     
     // Process special arguments like --provider and help flags
     for (size_t i = 0; i < args.size(); ++i) {
@@ -26,6 +37,40 @@ CommandLineParser::ParsedArgs CommandLineParser::parseArguments(int argc, char*
             args.erase(args.begin() + i);
             --i; // Adjust index after removal
         }
+        // Print a per-phase timing breakdown of every HTTP request
+        else if (args[i] == "--timings") {
+            HttpClient::setTimingsEnabled(true);
+            args.erase(args.begin() + i);
+            --i; // Adjust index after removal
+        }
+        // Skip the response cache for this run
+        else if (args[i] == "--no-cache") {
+            ResponseCache::setBypass(true);
+            args.erase(args.begin() + i);
+            --i; // Adjust index after removal
+        }
+        // Record a Chrome trace of this run (tracing builds only)
+        else if (hasPrefix(args[i], "--trace=") || args[i] == "--trace") {
+            std::string tracePath;
+            if (args[i] != "--trace") {
+                tracePath = extractValue(args[i], "--trace=");
+                args.erase(args.begin() + i);
+            } else if (i + 1 < args.size()) {
+                tracePath = args[i + 1];
+                args.erase(args.begin() + i, args.begin() + i + 2);
+            }
+            if (tracePath.empty()) {
+                result.hasError = true;
+                result.errorMessage = "Error: --trace option requires a file name";
+                return result;
+            }
+            if (Trace::isAvailable()) {
+                Trace::start(tracePath);
+            } else {
+                std::cerr << "Warning: --trace ignored; rebuild with cmake -DAITH_TRACING=ON" << std::endl;
+            }
+            --i; // Adjust index after removal
+        }
         // Check for --provider=value or -p value format
         else if (hasPrefix(args[i], "--provider=")) {
             ProviderManager::setCommandLineProvider(extractValue(args[i], "--provider="));
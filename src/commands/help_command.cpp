@@ -35,8 +35,42 @@ USAGE:
 COMMANDS:
     new "prompt"              Start a new conversation with the given prompt
     "prompt"                  Continue the current conversation with a prompt (must be quoted)
-    list                      List available AI models for the current provider
-    benchmark                 Run performance benchmarks against AI providers
+    list [options]            List available AI models for the current provider
+                              --refresh        Ignore the cached model list
+                              --owner NAME     Only models owned by NAME
+                              --prefix TEXT    Only model ids starting with TEXT
+    benchmark [options] ["prompt"]
+                              Run performance benchmarks against AI providers
+                              --concurrency N  Test N models in parallel
+                              --iterations N   Timed requests per model (default 1)
+                              --warmup N       Untimed requests per model first
+                              --stream         Measure connect time, TTFT and tokens/s
+                              --sort METRIC    Rank by total, ttft, connect or tps
+                              --refresh, --owner, --prefix  As for list
+    tokens <file|history|->   Count tokens offline (--tokenizer NAME|PATH to override)
+    batch <input.jsonl|-> [options]
+                              Run the prompts of a JSONL file concurrently
+                              -o FILE          Write JSONL results to FILE (default stdout)
+                              --concurrency N  Requests in flight (default 4)
+                              --order MODE     input (default) or completion
+                              --resume FILE    Skip ids recorded in FILE, record new ones
+                              --retries N      Retries on 429/502/503/connect errors (default 2)
+                              --model NAME     Model for lines without one
+    race "prompt" -m P:M -m P:M...
+                              Send a prompt to several provider:model pairs at
+                              once, keep the first reply, cancel the rest
+                              --stats          Show recorded wins and timings
+    repl [model]              Interactive session: one process, warm connection,
+                              /model, /provider, /new, /history, /help, /exit
+    daemon [start|status|stop]
+                              Run aithd (same as starting ./aithd); other aith
+                              invocations then run inside it (AITH_NO_DAEMON=1 to opt out)
+    serve [options]           Local OpenAI-compatible proxy on /v1/chat/completions, /v1/models
+                              --listen HOST:PORT  Address to serve on (default 127.0.0.1:8080)
+                              --threads N         Requests handled at once (default 8)
+                              --max-per-client N  Requests in flight per client (default 4)
+                              --token TOKEN       Bearer token clients must send (or SERVE_TOKEN);
+                                                  required on a non-loopback address
     history [subcommand]      Manage conversation history (requires subcommand)
     blacklist [subcommand]    Manage blacklisted models (requires subcommand)
     config [subcommand]       Manage configuration settings (requires subcommand)
@@ -44,6 +78,9 @@ COMMANDS:
 
 OPTIONS:
     --provider=NAME, -p NAME  Use a specific AI provider (groq, openrouter, etc.)
+    --timings                 Print DNS/connect/TLS/TTFB/transfer times of HTTP requests
+    --no-cache                Bypass the response cache (see RESPONSE_CACHE)
+    --trace FILE              Write a Chrome trace of this run (builds with -DAITH_TRACING=ON)
 
 GLOBAL FLAGS:
     --help, -h               Show help information
@@ -72,7 +109,14 @@ Using Different Providers:
 
 Core Commands:
     aith list                           # List available models
+    aith list --owner meta --refresh    # Re-download, show one owner's models
     aith benchmark                      # Test provider performance
+    aith tokens history                 # Count the tokens of the current conversation
+    aith batch in.jsonl -o out.jsonl --concurrency 8 --resume done.txt
+    aith race "Hi" -m groq:llama-3.1-8b-instant -m openrouter
+    aith repl                           # Chat interactively in one session
+    aith daemon &                       # Keep config and caches loaded for scripts
+    aith serve --listen 127.0.0.1:8080  # Serve other tools through aith's providers
     aith help                           # Show help information
 
 History management:
@@ -139,22 +183,22 @@ AITH automatically manages your conversation history with descriptive filenames:
 File Structure:
     ~/.config/aith/
     ├── current_conversation           # Tracks active conversation name
-    ├── current_debug_memory_leaks.json    # Current conversation file
+    ├── current_debug_memory_leaks.jsonl    # Current conversation file
     └── aith_histories/
-        ├── history_quantum_computing_20241218_143022.json
-        ├── history_python_optimization_20241218_144530.json
+        ├── history_quantum_computing_20241218_143022.jsonl
+        ├── history_python_optimization_20241218_144530.jsonl
         └── ...
 
 How it Works:
     1. Start new conversation: aith new "Debug memory leaks"
-       → Creates: current_debug_memory_leaks.json
+       → Creates: current_debug_memory_leaks.jsonl
     
     2. Continue conversation: aith "What tools to use?"
-       → Appends to: current_debug_memory_leaks.json
+       → Appends to: current_debug_memory_leaks.jsonl
     
     3. Start another conversation: aith new "Python optimization tips"
-       → Archives: current_debug_memory_leaks.json → history_debug_memory_leaks_YYYYMMDD_HHMMSS.json
-       → Creates: current_python_optimization_tips.json
+       → Archives: current_debug_memory_leaks.jsonl → history_debug_memory_leaks_YYYYMMDD_HHMMSS.jsonl
+       → Creates: current_python_optimization_tips.jsonl
 
 Benefits:
     ✓ Know your current conversation topic at a glance
@@ -2,6 +2,7 @@
 #include "directory_operations.h"
 #include "file_operations.h"
 #include "conversation_displayer.h"
+#include "history_storage.h"
 #include "core/application_setup.h"
 #include <iostream>
 #include <stdexcept>
@@ -129,13 +130,13 @@ std::string HistoryCommand::resolveTarget(const std::string& target) const {
             throw std::runtime_error("No history files found in directory: " + historyDir);
         }
         
-        // Filter to only .json files and find the most recent
+        // Filter to only history files and find the most recent
         std::string latestFile;
         std::time_t latestTime = 0;
         
         for (const auto& filename : files) {
-            // Skip non-JSON files
-            if (filename.length() < 5 || filename.substr(filename.length() - 5) != ".json") {
+            // Skip non-history files
+            if (!HistoryStorage::isHistoryFile(filename)) {
                 continue;
             }
             
@@ -226,7 +227,7 @@ void HistoryCommand::executeReuse(const std::string& target) {
         ApplicationSetup::setCurrentConversationName(conversationName);
         
         // Construct the new current history path
-        std::string newCurrentPath = historyDir + "/current_" + conversationName + ".json";
+        std::string newCurrentPath = historyDir + "/current_" + conversationName + HistoryStorage::EXTENSION;
         
         // If the target file is not already in the current format, copy it
         if (filePath != newCurrentPath) {
@@ -249,10 +250,8 @@ std::string HistoryCommand::extractConversationName(const std::string& filePath)
     std::filesystem::path path(filePath);
     std::string filename = path.filename().string();
     
-    // Remove .json extension
-    if (filename.length() > 5 && filename.substr(filename.length() - 5) == ".json") {
-        filename = filename.substr(0, filename.length() - 5);
-    }
+    // Remove .jsonl / .json extension
+    filename = HistoryStorage::stripExtension(filename);
     
     // Handle different filename patterns
     if (filename.substr(0, 8) == "current_") {
@@ -290,7 +289,7 @@ void HistoryCommand::archiveCurrentConversationIfNeeded(const std::string& newCo
         return;
     }
     
-    std::string currentHistoryPath = historyDir + "/current_" + currentConversationName + ".json";
+    std::string currentHistoryPath = historyDir + "/current_" + currentConversationName + HistoryStorage::EXTENSION;
     
     // Check if the current conversation file exists
     if (!FileOperations::exists(currentHistoryPath)) {
@@ -302,10 +301,10 @@ void HistoryCommand::archiveCurrentConversationIfNeeded(const std::string& newCo
     char timestamp[20];
     std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", std::localtime(&now));
     
-    std::string archivedPath = historyDir + "/history_" + currentConversationName + "_" + timestamp + ".json";
+    std::string archivedPath = historyDir + "/history_" + currentConversationName + "_" + timestamp + HistoryStorage::EXTENSION;
     
     try {
-        FileOperations::rename(currentHistoryPath, archivedPath);
+        HistoryStorage::rename(currentHistoryPath, archivedPath);
         std::cout << "📦 Archived current conversation: " << currentConversationName << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Warning: Could not archive current conversation: " << e.what() << std::endl;
@@ -317,11 +316,8 @@ void HistoryCommand::archiveCurrentConversationIfNeeded(const std::string& newCo
  */
 void HistoryCommand::copyFileToCurrentFormat(const std::string& sourcePath, const std::string& targetPath) const {
     try {
-        // Read the source file content
-        std::string content = FileOperations::read(sourcePath);
-        
-        // Write to the target path
-        FileOperations::write(targetPath, content);
+        // Read the source file in either format and write it line-delimited
+        HistoryStorage::write(targetPath, HistoryStorage::read(sourcePath));
         
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to copy conversation file: " + std::string(e.what()));
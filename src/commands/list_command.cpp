@@ -19,11 +19,15 @@ void ListCommand::execute() {
     // Validate arguments before execution
     validateArgs();
     
+    ModelFilter filter;
+    bool refresh = false;
+    parseOptions(filter, refresh);
+    
     // Display header with current provider name
     std::cout << "Available models for provider '" << ProviderManager::getAgent() << "':" << std::endl;
     
     // Use existing API infrastructure to list models
-    ApiManager::listModels(apiKey);
+    ApiManager::listModels(apiKey, filter, refresh);
 }
 
 /**
@@ -33,6 +37,46 @@ void ListCommand::validateArgs() const {
     if (apiKey.empty()) {
         throw std::invalid_argument("API key is required for listing models");
     }
+    
+    // Reject malformed options before any request is made
+    ModelFilter filter;
+    bool refresh = false;
+    parseOptions(filter, refresh);
+}
+
+/**
+ * @brief Parses the list options.
+ */
+void ListCommand::parseOptions(ModelFilter& filter, bool& refresh) const {
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        
+        std::string name = arg;
+        std::string value;
+        bool hasInlineValue = false;
+        
+        // Accept both "--option value" and "--option=value"
+        size_t equals = arg.find('=');
+        if (equals != std::string::npos) {
+            name = arg.substr(0, equals);
+            value = arg.substr(equals + 1);
+            hasInlineValue = true;
+        }
+        
+        if (arg == "--refresh") {
+            refresh = true;
+        } else if (name == "--owner" || name == "--prefix") {
+            if (!hasInlineValue) {
+                if (i + 1 >= args.size()) {
+                    throw std::invalid_argument(name + " option requires a value");
+                }
+                value = args[++i];
+            }
+            (name == "--owner" ? filter.owner : filter.prefix) = value;
+        } else {
+            throw std::invalid_argument("Unknown list option: " + arg);
+        }
+    }
 }
 
 /**
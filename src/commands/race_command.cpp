@@ -0,0 +1,107 @@
+#include "commands/race_command.h"
+#include "core/api_manager.h"
+#include "api/chat_race.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a RaceCommand with the provided configuration.
+ */
+RaceCommand::RaceCommand(const std::vector<std::string>& commandArgs,
+                         const ApplicationSetup::Config& config)
+    : Command(commandArgs, config.apiKey, config.provider, config.currentHistory, config.historyDir) {
+}
+
+/**
+ * @brief Executes the race command.
+ */
+void RaceCommand::execute() {
+    validateArgs();
+
+    std::string prompt;
+    std::vector<std::string> contenders;
+    if (parseArgs(prompt, contenders)) {
+        displayStats();
+        return;
+    }
+
+    ApiManager::race(prompt, contenders, currentHistory);
+}
+
+/**
+ * @brief Validates the prompt and the contenders.
+ */
+void RaceCommand::validateArgs() const {
+    std::string prompt;
+    std::vector<std::string> contenders;
+    if (parseArgs(prompt, contenders)) {
+        return;
+    }
+
+    if (prompt.empty() || contenders.size() < 2) {
+        throw std::invalid_argument("Usage: aith race \"prompt\" -m provider:model -m provider:model... "
+                                    "(at least two contenders), or aith race --stats");
+    }
+}
+
+/**
+ * @brief Gets the command name.
+ */
+std::string RaceCommand::getCommandName() const {
+    return "race";
+}
+
+/**
+ * @brief Splits the arguments into the prompt, the contenders and --stats.
+ */
+bool RaceCommand::parseArgs(std::string& prompt, std::vector<std::string>& contenders) const {
+    bool stats = false;
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+
+        if (arg == "--stats") {
+            stats = true;
+        } else if (arg.rfind("--model=", 0) == 0) {
+            contenders.push_back(arg.substr(8));
+        } else if (arg == "-m" || arg == "--model") {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument(arg + " option requires a value");
+            }
+            contenders.push_back(args[++i]);
+        } else if (arg.rfind("--", 0) == 0 || (arg.size() > 1 && arg[0] == '-')) {
+            throw std::invalid_argument("Unknown race option: " + arg);
+        } else if (prompt.empty()) {
+            prompt = arg;
+        } else {
+            throw std::invalid_argument("Unexpected race argument: " + arg + " (quote the prompt)");
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief Prints the accumulated race results per contender.
+ */
+void RaceCommand::displayStats() {
+    std::vector<RaceStats> stats = ChatRace::readStats();
+    if (stats.empty()) {
+        std::cout << "No races recorded in " << ChatRace::getLogPath() << std::endl;
+        return;
+    }
+
+    size_t labelWidth = 10;
+    for (const RaceStats& entry : stats) {
+        labelWidth = std::max(labelWidth, entry.label.size());
+    }
+
+    std::cout << std::left << std::setw(static_cast<int>(labelWidth) + 2) << "contender" << std::right
+              << std::setw(7) << "races" << std::setw(7) << "wins" << std::setw(9) << "failed"
+              << std::setw(13) << "mean win ms" << std::endl;
+    for (const RaceStats& entry : stats) {
+        std::cout << std::left << std::setw(static_cast<int>(labelWidth) + 2) << entry.label << std::right
+                  << std::setw(7) << entry.races << std::setw(7) << entry.wins << std::setw(9) << entry.failures
+                  << std::setw(13) << std::fixed << std::setprecision(0) << entry.getMeanWinMs() << std::endl;
+    }
+}
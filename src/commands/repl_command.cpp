@@ -0,0 +1,204 @@
+#include "commands/repl_command.h"
+#include "core/api_manager.h"
+#include "core/config_manager.h"
+#include "core/provider_manager.h"
+#include "api/api_helpers.h"
+#include "chat/history.h"
+#include "conversation_displayer.h"
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+/**
+ * @brief Constructs a ReplCommand with the provided configuration.
+ */
+ReplCommand::ReplCommand(const std::vector<std::string>& commandArgs,
+                         const ApplicationSetup::Config& config)
+    : Command(commandArgs, config.apiKey, config.provider, config.currentHistory, config.historyDir),
+      config_(config) {
+}
+
+/**
+ * @brief Reads and answers prompts until /exit or end of input.
+ */
+void ReplCommand::execute() {
+    validateArgs();
+
+    model_ = args.size() > 1 ? args[1] : ProviderManager::getDefaultModel();
+    if (!ApiValidator::validateProviderForChat(config_.provider, ProviderManager::getApiUrl(), model_)) {
+        return;
+    }
+
+    // Loaded once; every turn after this only appends to the history file
+    systemPrompt_ = ConfigManager::getDefaultPrompt();
+    session_.reset(new ChatSession(config_.currentHistory, systemPrompt_));
+    renderer_.setWordWrappingEnabled(true);
+
+    bool interactive = isatty(STDIN_FILENO) != 0;
+    if (interactive) {
+        displayStatus();
+        std::cout << "Type /help for commands, /exit or Ctrl-D to quit." << std::endl;
+    }
+
+    std::string line;
+    for (;;) {
+        if (interactive) {
+            std::cout << std::endl << model_ << "> " << std::flush;
+        }
+        if (!std::getline(std::cin, line)) {
+            break;
+        }
+
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '/') {
+            if (!runCommand(line)) {
+                break;
+            }
+        } else {
+            sendPrompt(line);
+        }
+    }
+}
+
+/**
+ * @brief Validates the optional model argument.
+ */
+void ReplCommand::validateArgs() const {
+    if (args.size() > 2) {
+        throw std::invalid_argument("Usage: aith [--provider=NAME] repl [model]");
+    }
+}
+
+/**
+ * @brief Gets the command name.
+ */
+std::string ReplCommand::getCommandName() const {
+    return "repl";
+}
+
+/**
+ * @brief Runs a slash command.
+ */
+bool ReplCommand::runCommand(const std::string& line) {
+    size_t split = line.find_first_of(" \t");
+    std::string name = line.substr(0, split);
+    std::string argument = split == std::string::npos ? "" : line.substr(line.find_first_not_of(" \t", split));
+
+    if (name == "/exit" || name == "/quit") {
+        return false;
+    }
+    if (name == "/model") {
+        if (!argument.empty() &&
+            ApiValidator::validateProviderForChat(config_.provider, ProviderManager::getApiUrl(), argument)) {
+            model_ = argument;
+        }
+        displayStatus();
+    } else if (name == "/provider") {
+        if (!argument.empty()) {
+            switchProvider(argument);
+        }
+        displayStatus();
+    } else if (name == "/new") {
+        startNew_ = true;
+        if (argument.empty()) {
+            std::cout << "The next prompt starts a new conversation." << std::endl;
+        } else {
+            sendPrompt(argument);
+        }
+    } else if (name == "/history") {
+        displayHistory();
+    } else if (name == "/help") {
+        displayHelp();
+    } else {
+        std::cerr << "Unknown command: " << name << " (type /help for commands)" << std::endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends a prompt and renders the reply.
+ */
+void ReplCommand::sendPrompt(const std::string& prompt) {
+    try {
+        if (startNew_) {
+            // Archives the current conversation; the new one is written once the reply arrives
+            config_.currentHistory = startNewHistoryPath(prompt, config_.historyDir, config_.currentHistory);
+            config_.currentConversationName = ApplicationSetup::getCurrentConversationName();
+            session_.reset(new ChatSession(config_.currentHistory, systemPrompt_));
+            startNew_ = false;
+        }
+        session_->addMessage("user", prompt);
+
+        if (ApiManager::send(*session_, model_, config_.apiKey, &renderer_)) {
+            return;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    // Keep the conversation as it is on disk, so the prompt can simply be sent again
+    session_->discardUnsaved();
+}
+
+/**
+ * @brief Switches to another provider and its default model.
+ */
+void ReplCommand::switchProvider(const std::string& name) {
+    std::string previous = config_.provider;
+    ProviderManager::setCommandLineProvider(name);
+
+    std::string key = ProviderManager::getApiKey();
+    std::string model = ProviderManager::getDefaultModel();
+    if (key.empty()) {
+        std::cerr << "Error: No API key found for provider '" << name << "'" << std::endl;
+    } else if (ApiValidator::validateProviderForChat(name, ProviderManager::getApiUrl(), model)) {
+        config_.provider = name;
+        config_.apiKey = key;
+        model_ = model;
+        return;
+    }
+    ProviderManager::setCommandLineProvider(previous);
+}
+
+/**
+ * @brief Prints the provider, model and conversation in use.
+ */
+void ReplCommand::displayStatus() const {
+    std::cout << "Using provider: " << config_.provider << std::endl;
+    std::cout << "Using model: " << model_ << std::endl;
+    std::cout << "Conversation: " << std::filesystem::path(session_->getHistoryPath()).filename().string()
+              << (startNew_ ? " (new one starts with the next prompt)" : "") << std::endl;
+}
+
+/**
+ * @brief Prints the conversation so far.
+ */
+void ReplCommand::displayHistory() const {
+    if (startNew_) {
+        std::cout << "The new conversation has no messages yet." << std::endl;
+        return;
+    }
+    ConversationDisplayer::displayConversation(session_->getMessages(),
+                                               std::filesystem::path(session_->getHistoryPath()).filename().string(),
+                                               false);
+}
+
+/**
+ * @brief Prints the available commands.
+ */
+void ReplCommand::displayHelp() {
+    std::cout << R"(Commands:
+    /model [NAME]        Show or switch the model
+    /provider [NAME]     Show or switch the provider (uses its default model)
+    /new [prompt]        Start a new conversation
+    /history             Show the current conversation
+    /help                Show this list
+    /exit, /quit         Leave the session (or press Ctrl-D)
+Any other line is sent as a prompt.)" << std::endl;
+}
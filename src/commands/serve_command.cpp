@@ -0,0 +1,113 @@
+#include "commands/serve_command.h"
+#include "core/config_manager.h"
+#include <stdexcept>
+
+/**
+ * @brief Constructs a ServeCommand with the provided configuration.
+ */
+ServeCommand::ServeCommand(const std::vector<std::string>& commandArgs,
+                           const ApplicationSetup::Config& config)
+    : Command(commandArgs, config.apiKey, config.provider, config.currentHistory, config.historyDir) {
+}
+
+/**
+ * @brief Starts the proxy and serves until the process ends.
+ */
+void ServeCommand::execute() {
+    validateArgs();
+
+    ProxyOptions options = parseArgs();
+    ProxyServer server(options);
+    if (!server.run()) {
+        throw std::runtime_error("Cannot serve on " + options.host + ":" + std::to_string(options.port));
+    }
+}
+
+/**
+ * @brief Validates the options.
+ */
+void ServeCommand::validateArgs() const {
+    parseArgs();
+}
+
+/**
+ * @brief Gets the command name.
+ */
+std::string ServeCommand::getCommandName() const {
+    return "serve";
+}
+
+/**
+ * @brief Reads the listen address, thread count, per-client limit and token.
+ */
+ProxyOptions ServeCommand::parseArgs() const {
+    ProxyOptions options;
+    options.token = ConfigManager::getConfigValue("SERVE_TOKEN");
+    for (size_t i = 1; i < args.size(); ++i) {
+        std::string arg = args[i];
+        std::string value;
+        size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && equals != std::string::npos) {
+            value = arg.substr(equals + 1);
+            arg = arg.substr(0, equals);
+        } else if (arg == "--listen" || arg == "--threads" || arg == "--max-per-client" || arg == "--token") {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument(arg + " option requires a value");
+            }
+            value = args[++i];
+        }
+
+        if (arg == "--listen") {
+            // HOST:PORT, or just PORT on 127.0.0.1
+            size_t colon = value.rfind(':');
+            if (colon != std::string::npos) {
+                options.host = value.substr(0, colon);
+                value = value.substr(colon + 1);
+            }
+            if (options.host.empty()) {
+                throw std::invalid_argument("--listen expects HOST:PORT, got: " + args[i]);
+            }
+            options.port = parsePositive(arg, value);
+            if (options.port > 65535) {
+                throw std::invalid_argument("--listen port out of range: " + value);
+            }
+        } else if (arg == "--threads") {
+            options.threads = parsePositive(arg, value);
+        } else if (arg == "--max-per-client") {
+            options.maxPerClient = parsePositive(arg, value);
+        } else if (arg == "--token") {
+            if (value.empty()) {
+                throw std::invalid_argument("--token expects a non-empty token");
+            }
+            options.token = value;
+        } else {
+            throw std::invalid_argument("Unknown serve option: " + args[i] +
+                                        " (usage: aith serve [--listen HOST:PORT] [--threads N] [--max-per-client N]"
+                                        " [--token TOKEN])");
+        }
+    }
+
+    // Anyone who can reach the port could spend the provider keys
+    if (!ProxyServer::isLoopback(options.host) && options.token.empty()) {
+        throw std::invalid_argument("Refusing to serve on " + options.host + " without a token; set --token or "
+                                    "SERVE_TOKEN, or listen on a loopback address");
+    }
+    return options;
+}
+
+/**
+ * @brief Parses a positive number option value.
+ */
+int ServeCommand::parsePositive(const std::string& option, const std::string& value) {
+    size_t parsed = 0;
+    int number = 0;
+    try {
+        number = std::stoi(value, &parsed);
+    } catch (const std::exception&) {
+        parsed = 0;
+    }
+    if (parsed == 0 || parsed != value.size() || number <= 0) {
+        throw std::invalid_argument(option + " expects a positive number, got: " + value);
+    }
+    return number;
+}
@@ -0,0 +1,149 @@
+#include "commands/tokens_command.h"
+#include "core/provider_manager.h"
+#include "tokenizer/token_counter.h"
+#include "file_operations.h"
+#include "history_storage.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a TokensCommand with the provided configuration.
+ */
+TokensCommand::TokensCommand(const std::vector<std::string>& commandArgs,
+                             const ApplicationSetup::Config& config)
+    : Command(commandArgs, config.apiKey, config.provider, config.currentHistory, config.historyDir) {
+}
+
+/**
+ * @brief Executes the tokens command.
+ */
+void TokensCommand::execute() {
+    validateArgs();
+
+    std::string tokenizerName;
+    std::vector<std::string> targets = parseArgs(tokenizerName);
+
+    std::shared_ptr<const BpeTokenizer> tokenizer = tokenizerName.empty()
+        ? TokenCounter::forModel(ProviderManager::getAgent(), ProviderManager::getDefaultModel())
+        : TokenCounter::byName(tokenizerName);
+
+    if (tokenizer) {
+        std::cout << "Tokenizer: " << tokenizer->getName() << " ("
+                  << tokenizer->getVocabularySize() << " tokens)" << std::endl;
+    } else {
+        std::cout << "Tokenizer: none installed in " << TokenCounter::getVocabularyDir()
+                  << ", estimating 1 token per " << TokenCounter::CHARS_PER_ESTIMATED_TOKEN
+                  << " characters" << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (const std::string& target : targets) {
+        total += countTarget(target, tokenizer.get());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (targets.size() > 1) {
+        std::cout << "total: " << total << " tokens" << std::endl;
+    }
+    if (seconds > 0) {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Counted in " << seconds * 1000.0 << " ms ("
+                  << static_cast<double>(total) / seconds / 1e6 << "M tokens/s)" << std::endl;
+    }
+}
+
+/**
+ * @brief Validates that at least one target is given.
+ */
+void TokensCommand::validateArgs() const {
+    std::string tokenizerName;
+    if (parseArgs(tokenizerName).empty()) {
+        throw std::invalid_argument("Usage: aith tokens [--tokenizer NAME|PATH] <file|history|->...");
+    }
+}
+
+/**
+ * @brief Gets the command name.
+ */
+std::string TokensCommand::getCommandName() const {
+    return "tokens";
+}
+
+/**
+ * @brief Splits the arguments into the --tokenizer value and the targets.
+ */
+std::vector<std::string> TokensCommand::parseArgs(std::string& tokenizerName) const {
+    std::vector<std::string> targets;
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+
+        if (arg.rfind("--tokenizer=", 0) == 0) {
+            tokenizerName = arg.substr(12);
+        } else if (arg == "--tokenizer") {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("--tokenizer option requires a value");
+            }
+            tokenizerName = args[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::invalid_argument("Unknown tokens option: " + arg);
+        } else {
+            targets.push_back(arg);
+        }
+    }
+    return targets;
+}
+
+/**
+ * @brief Resolves a target to a file path ("-" stays as is).
+ */
+std::string TokensCommand::resolveTarget(const std::string& target) const {
+    if (target == "-") {
+        return target;
+    }
+    if (target == "history" || target == "current") {
+        if (currentHistory.empty()) {
+            throw std::runtime_error("No current history file is set");
+        }
+        return currentHistory;
+    }
+    if (FileOperations::exists(target)) {
+        return target;
+    }
+    if (!historyDir.empty() && FileOperations::exists(historyDir + "/" + target)) {
+        return historyDir + "/" + target;
+    }
+    throw std::runtime_error("File not found: " + target);
+}
+
+/**
+ * @brief Counts the tokens of one target and prints the result.
+ */
+size_t TokensCommand::countTarget(const std::string& target, const BpeTokenizer* tokenizer) const {
+    std::string path = resolveTarget(target);
+
+    // Conversations are counted per message, as they are sent
+    if (path != "-" && HistoryStorage::isHistoryFile(path)) {
+        Json::Value messages = HistoryStorage::read(path);
+        size_t tokens = 0;
+        for (const Json::Value& message : messages) {
+            tokens += TokenCounter::countMessage(message, tokenizer);
+        }
+        std::cout << target << ": " << tokens << " tokens (" << messages.size() << " messages)" << std::endl;
+        return tokens;
+    }
+
+    std::string text;
+    if (path == "-") {
+        text.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else {
+        text = FileOperations::read(path);
+    }
+
+    size_t tokens = TokenCounter::count(text, tokenizer);
+    std::cout << target << ": " << tokens << " tokens (" << text.size() << " bytes)" << std::endl;
+    return tokens;
+}
@@ -7,20 +7,32 @@
 #include "http_client.h"
 #include "api/api_models.h"
 #include "api/api_helpers.h"
+#include "api/response_cache.h"
+#include "api/chat_race.h"
+#include "api/hedged_request.h"
+#include "api/failover_chain.h"
+#include "api/rate_limiter.h"
+#include "api/error_classifier.h"
+#include "trace/trace.h"
 #include <json/json.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <ctime>
 #include <filesystem>
+#include <stdexcept>
 #include "markdown/markdown.h"
-#include "history.h"
+#include "markdown/streaming_markdown_renderer.h"
+#include "chat_session.h"
+#include "context_window.h"
 
 /**
  * Lists all available aith models.
  * @param apiKey The API key for authentication.
+ * @param filter Only list models matching this owner / id prefix.
+ * @param refresh True to ignore the cached catalog.
  */
-void ApiManager::listModels(const std::string &apiKey) {
+void ApiManager::listModels(const std::string &apiKey, const ModelFilter &filter, bool refresh) {
     std::string apiUrl = ProviderManager::getApiUrl();
     std::string provider = ProviderManager::getAgent();
     
@@ -28,18 +40,19 @@ void ApiManager::listModels(const std::string &apiKey) {
         return;
     }
     
-    ApiConsole::displayModelsFetchStatus(provider);
-    
-    std::string result = HttpClient::get(apiUrl + "/models", apiKey);
-    
-    ModelsListResponse response(result, provider);
-    
-    if (response.hasError()) {
-        ApiConsole::displayError(response.getErrorMessage(), result);
+    ModelCatalogResult catalog;
+    try {
+        catalog = ModelCatalog::load(provider, apiUrl, apiKey, refresh);
+    } catch (const std::runtime_error& e) {
+        ApiConsole::displayError(e.what());
         return;
     }
     
-    response.printModels();
+    ApiConsole::displayModelCatalogStatus(provider, catalog);
+    
+    for (const auto& model : ModelCatalog::filter(catalog.models, filter)) {
+        std::cout << model.toString() << std::endl;
+    }
 }
 
 /**
@@ -61,39 +74,222 @@ void ApiManager::chat(const std::string &prompt, const std::string &model, const
         return;
     }
 
-    // Load default prompt using ConfigManager
-    std::string defaultPrompt = ConfigManager::getDefaultPrompt();
-
-    // Ensure history file exists
-    ensureHistoryFileExists(currentHistory);
+    // Load the conversation once; the default prompt is sent as system message
+    ChatSession session(currentHistory, ConfigManager::getDefaultPrompt());
 
     // Add user message to history if not a new chat
     if (!newChat) {
-        addToHistory("user", prompt, currentHistory);
+        session.addMessage("user", prompt);
     }
 
-    // Load and build chat history with system prompt
-    Json::Value history = loadChatHistory(currentHistory);
+    send(session, selectedModel, apiKey);
+}
 
-    history = buildChatHistoryWithSystem(history, defaultPrompt);
+/**
+ * Sends the conversation of a session to a model and adds the reply to it.
+ * @param session The conversation, ending with the new user message.
+ * @param selectedModel The model to use for the chat.
+ * @param apiKey The API key for authentication.
+ * @param renderer Renderer for the reply, or nullptr to use a new one.
+ * @return True if the reply was added to the session and persisted.
+ */
+bool ApiManager::send(ChatSession &session, const std::string &selectedModel, const std::string &apiKey,
+                      StreamingMarkdownRenderer *renderer) {
+    TRACE_SCOPE("ApiManager::send");
+    std::string apiUrl = ProviderManager::getApiUrl();
+    std::string provider = ProviderManager::getAgent();
+    const std::string& currentHistory = session.getHistoryPath();
+    
+    // Buffered replies go through the caller's renderer too when there is one
+    auto render = [renderer](const std::string& content) {
+        if (renderer == nullptr) {
+            renderMarkdown(content);
+            return;
+        }
+        renderer->feed(content);
+        renderer->flush();
+    };
 
-    // Create and send chat request
-    ChatRequest request(selectedModel, history);
+    // Identical requests are answered from the response cache when it is enabled
+    std::string cacheKey;
+    if (ResponseCache::isEnabled()) {
+        cacheKey = ResponseCache::makeKey(apiUrl, session.buildRequestPayload(selectedModel, false));
+        
+        std::string cachedContent;
+        if (ResponseCache::lookup(cacheKey, cachedContent)) {
+            ApiConsole::displayCachedResponseStatus(provider, selectedModel, ResponseCache::getStats());
+            render(cachedContent);
+            session.addMessage("assistant", cachedContent);
+            session.persist();
+            return true;
+        }
+    }
+    
+    // Build the request payload in place, without copying the message array
+    bool stream = ConfigManager::getConfigFlag("STREAM", true);
+    const Json::Value& fullPayload = session.buildRequestPayload(selectedModel, stream);
+    
+    // Fit the outgoing conversation into the token budget; the history file keeps everything
+    Json::Value trimmedPayload;
+    ContextWindow::Policy contextPolicy = ContextWindow::loadPolicy(provider, selectedModel);
+    ContextWindow::Summarizer summarizer = [&](const Json::Value& messages) {
+        ChatRequest request(selectedModel, messages);
+        Json::Value summaryPayload = request.toJson();
+        
+        // The summary is a full-history request of its own, so it waits for the rate limit too
+        RetryPolicy retry = ProviderManager::getRetryPolicy(provider);
+        RateLimiter::acquire(provider, summaryPayload, retry);
+        std::string summaryJson = HttpClient::post(apiUrl + "/chat/completions", apiKey, summaryPayload,
+                                                   nullptr, nullptr, &retry);
+        ChatResponse summary(summaryJson);
+        if (summary.hasError()) {
+            throw std::runtime_error(summary.getErrorMessage());
+        }
+        return summary.getContent();
+    };
+    bool trimmed = ContextWindow::fit(fullPayload, contextPolicy, currentHistory, summarizer, trimmedPayload);
+    const Json::Value& payload = trimmed ? trimmedPayload : fullPayload;
+    if (trimmed) {
+        ApiConsole::displayContextTrimmed(payload["messages"].size(), fullPayload["messages"].size(),
+                                          contextPolicy.tokenBudget);
+    }
     
     ApiConsole::displayChatRequestStatus(provider, selectedModel);
     
-    std::string responseJson = HttpClient::post(apiUrl + "/chat/completions", apiKey, request.toJson());
+    // With hedging, a request without a first byte after the threshold is duplicated
+    HedgePolicy hedgePolicy = HedgedRequest::loadPolicy(provider, selectedModel);
+    HedgeOutcome hedgeOutcome;
+    auto reportHedge = [&]() {
+        if (hedgeOutcome.fired) {
+            ApiConsole::displayHedgeResult(hedgePolicy, hedgeOutcome, HedgedRequest::getStats(provider, selectedModel));
+        }
+    };
     
-    // Parse response
-    ChatResponse response(responseJson);
+    // Walk the failover chain until a target answers; only the selected model is hedged and cached
+    std::vector<ModelTarget> chain = FailoverChain::load(ModelTarget{provider, selectedModel});
+    std::string content;
+    std::string rawResponse;
+    bool answeredByPrimary = false;
+    FailoverResult result = FailoverChain::run(chain, payload, stream, "chat", [&](const FailoverRequest& request) {
+        answeredByPrimary = request.index == 0;
+        rawResponse.clear();
+        bool hedged = answeredByPrimary && hedgePolicy.enabled;
+        auto sendHedged = [&](const HttpClient::ChunkCallback& onChunk) {
+            hedgeOutcome = HedgedRequest::send(provider, apiUrl, apiKey, payload, hedgePolicy, request.timeouts,
+                                               request.retry, onChunk);
+        };
+        
+        if (stream) {
+            // Render deltas as they arrive instead of waiting for the full completion
+            StreamingMarkdownRenderer ownRenderer;
+            StreamingMarkdownRenderer& streamRenderer = renderer != nullptr ? *renderer : ownRenderer;
+            streamRenderer.setWordWrappingEnabled(true);
+            
+            bool delivered = false;
+            ChatStreamParser parser([&streamRenderer, &delivered](const std::string& delta) {
+                delivered = true;
+                streamRenderer.feed(delta);
+            });
+            
+            HttpClient::ChunkCallback feed = [&parser](const char* data, size_t length) {
+                return parser.feed(data, length);
+            };
+            try {
+                if (hedged) {
+                    sendHedged(feed);
+                } else {
+                    HttpClient::postStream(request.apiUrl + "/chat/completions", request.apiKey, request.payload,
+                                           feed, nullptr, nullptr, request.timeouts, request.retry);
+                }
+            } catch (const std::exception& e) {
+                // A stream that broke off after its first delta cannot be handed to another target
+                streamRenderer.flush();
+                if (delivered) {
+                    return FailoverResult::failure(ErrorClassifier::classify(e), e.what(), true);
+                }
+                throw;
+            }
+            parser.finish();
+            streamRenderer.flush();
+            reportHedge();
+            
+            if (parser.hasError()) {
+                rawResponse = parser.getRawResponse();
+                return FailoverResult::failure(ErrorClassifier::classifyReply(parser.getErrorMessage()),
+                                               parser.getErrorMessage(), delivered);
+            }
+            content = parser.getContent();
+            return FailoverResult::success();
+        }
+        
+        std::string responseJson;
+        if (hedged) {
+            // Hedging needs a cancellable request; the buffered body arrives through the same callback
+            sendHedged([&responseJson](const char* data, size_t length) {
+                responseJson.append(data, length);
+                return true;
+            });
+        } else {
+            responseJson = HttpClient::post(request.apiUrl + "/chat/completions", request.apiKey, request.payload,
+                                            nullptr, request.timeouts, request.retry);
+        }
+        
+        ChatResponse response(responseJson);
+        if (response.hasError()) {
+            rawResponse = responseJson;
+            return FailoverResult::failure(ErrorClassifier::classifyReply(response.getErrorMessage()),
+                                           response.getErrorMessage());
+        }
+        content = response.getContent();
+        render(content);
+        reportHedge();
+        return FailoverResult::success();
+    });
     
-    if (response.hasError()) {
-        ApiConsole::displayError(response.getErrorMessage(), responseJson);
-        return;
+    if (!result.succeeded) {
+        ApiConsole::displayError(result.errorMessage, rawResponse);
+        return false;
     }
+    if (answeredByPrimary && !cacheKey.empty()) {
+        ResponseCache::store(provider, cacheKey, content);
+    }
+    
+    // Persist the user message and the answer in a single append
+    session.addMessage("assistant", content);
+    session.persist();
+    return true;
+}
 
-    // Display and save response
-    std::string content = response.getContent();
-    renderMarkdown(content);
-    addToHistory("assistant", content, currentHistory);
+/**
+ * Sends a prompt to several providers/models at once and keeps the first reply.
+ * @param prompt The input string to send to every contender.
+ * @param contenderSpecs The contenders as "provider:model" (or "provider").
+ * @param currentHistory The path to the history file.
+ */
+void ApiManager::race(const std::string &prompt, const std::vector<std::string> &contenderSpecs,
+                      const std::string &currentHistory) {
+    std::vector<ModelTarget> contenders;
+    for (const std::string& spec : contenderSpecs) {
+        contenders.push_back(ModelTarget::parse(spec));
+    }
+    
+    // Every contender gets the same conversation; only the winner is persisted
+    ChatSession session(currentHistory, ConfigManager::getDefaultPrompt());
+    session.addMessage("user", prompt);
+    
+    ApiConsole::displayRaceStart(contenders);
+    RaceResult result = ChatRace::run(contenders, session.getMessages());
+    ChatRace::record(result);
+    
+    if (!result.hasWinner()) {
+        ApiConsole::displayRaceResult(result);
+        ApiConsole::displayError("Every contender failed");
+        return;
+    }
+    
+    renderMarkdown(result.content);
+    session.addMessage("assistant", result.content);
+    session.persist();
+    
+    ApiConsole::displayRaceResult(result);
 }
@@ -2,15 +2,46 @@
 #include "commands/command_line_parser.h"
 #include "core/application_setup.h"
 #include "commands/command_factory.h"
+#include "daemon/daemon_client.h"
+#include "daemon/daemon_server.h"
+#include "core/config_manager.h"
+#include "core/provider_manager.h"
+#include "blacklist/blacklist_index.h"
+#include "tokenizer/token_counter.h"
+#include "metrics/metrics.h"
+#include "trace/trace.h"
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 
 int ApplicationController::run(int argc, char* argv[]) {
+    std::vector<std::string> commandLine(argv + 1, argv + argc);
+    
+    // Started as aithd: serve the commands of other aith processes
+    if (argc > 0 && std::filesystem::path(argv[0]).filename() == "aithd") {
+        return runDaemon();
+    }
+    
+    // A running daemon executes the command with its caches already loaded
+    int exitCode = 0;
+    if (isForwardable(commandLine) && DaemonClient::forward(commandLine, exitCode)) {
+        return exitCode;
+    }
+    
+    exitCode = runCommandLine(commandLine);
+    Metrics::stopFileExport(); // Writes the final values
+    Trace::finish();
+    return exitCode;
+}
+
+int ApplicationController::runCommandLine(const std::vector<std::string>& commandLine) {
     // Parse command line arguments
-    auto parsedArgs = CommandLineParser::parseArguments(argc, argv);
+    auto parsedArgs = CommandLineParser::parseArguments(commandLine);
     if (parsedArgs.hasError) {
         reportError(parsedArgs.errorMessage);
         return 1;
     }
+    TRACE_SCOPE("ApplicationController::runCommandLine");
     
     // Check if help was requested
     if (parsedArgs.showHelp) {
@@ -38,6 +69,11 @@ int ApplicationController::run(int argc, char* argv[]) {
         return 1;
     }
     
+    // Daemon control needs no provider setup
+    if (args[0] == "daemon") {
+        return runDaemonCommand(args);
+    }
+    
     // Initialize application configuration
     ApplicationSetup::Config config;
     try {
@@ -47,6 +83,12 @@ int ApplicationController::run(int argc, char* argv[]) {
         return 1;
     }
     
+    // Keep METRICS_FILE current; under aithd the daemon writes it from the totals of all commands
+    std::string metricsFile = ConfigManager::getConfigValue("METRICS_FILE");
+    if (!metricsFile.empty() && !forkedByDaemon_) {
+        Metrics::startFileExport(metricsFile, std::atoi(ConfigManager::getConfigValue("METRICS_INTERVAL").c_str()));
+    }
+    
     // Extract and execute the command
     std::string command = args[0];
     if (!executeCommand(command, args, config)) {
@@ -56,6 +98,81 @@ int ApplicationController::run(int argc, char* argv[]) {
     return 0;
 }
 
+int ApplicationController::runDaemon() {
+    // Runs in a forked child, which reports its metrics back instead of writing them
+    auto runCommand = [this](const std::vector<std::string>& commandLine) {
+        forkedByDaemon_ = true;
+        return runCommandLine(commandLine);
+    };
+    
+    // What every command loads first; the cached results are re-read only when their files change
+    auto warmUp = []() {
+        try {
+            ProviderManager::getApiKey();
+            BlacklistIndex::contains("", "");
+            TokenCounter::byName(TokenCounter::DEFAULT_VOCABULARY);
+        } catch (const std::exception&) {
+            // A command that needs them reports the problem in the client's terminal
+        }
+    };
+    return DaemonServer::run(runCommand, warmUp);
+}
+
+int ApplicationController::runDaemonCommand(const std::vector<std::string>& args) {
+    std::string action = args.size() > 1 ? args[1] : "start";
+    if (action == "start") {
+        return runDaemon();
+    }
+    if (action != "status" && action != "stop") {
+        reportError("Usage: aith daemon [start | status | stop]");
+        return 1;
+    }
+    
+    Json::Value reply;
+    if (!DaemonClient::control(action, reply)) {
+        std::cout << "aithd is not running" << std::endl;
+        return action == "stop" ? 0 : 1;
+    }
+    if (reply.isMember("error")) {
+        reportError("aithd: " + reply["error"].asString());
+        return 1;
+    }
+    if (action == "stop") {
+        std::cout << "aithd stopped" << std::endl;
+    } else {
+        std::cout << "aithd running (pid " << reply["pid"].asInt64() << ", " << reply["running"].asUInt64()
+                  << " commands running, " << reply["served"].asInt64() << " served, up "
+                  << reply["uptimeSeconds"].asInt64() << " s) on "
+                  << reply["socket"].asString() << std::endl;
+    }
+    return 0;
+}
+
+bool ApplicationController::isForwardable(const std::vector<std::string>& commandLine) {
+    if (!DaemonClient::isEnabled()) {
+        return false;
+    }
+    
+    // A trace records this process, so it must run the command itself
+    for (const std::string& arg : commandLine) {
+        if (arg == "--trace" || arg.rfind("--trace=", 0) == 0) {
+            return false;
+        }
+    }
+    
+    // Find the command behind the global flags
+    for (size_t i = 0; i < commandLine.size(); ++i) {
+        const std::string& arg = commandLine[i];
+        if (arg == "--provider" || arg == "-p") {
+            ++i;
+        } else if (arg.empty() || arg[0] != '-') {
+            // The daemon itself and the long-running commands stay in this process
+            return arg != "daemon" && arg != "repl" && arg != "serve";
+        }
+    }
+    return false;
+}
+
 void ApplicationController::displayUsage() const {
     std::cerr << "Usage: aith [--provider=NAME | -p NAME] [list | history | test | blacklist | new \"prompt\" | \"prompt\"] [model (optional)]" << std::endl;
 }
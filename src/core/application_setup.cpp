@@ -3,8 +3,9 @@
 #include "system_utils.h"
 #include "directory_operations.h"
 #include "file_operations.h"
-#include "json_file_handler.h"
 #include "filename_generator.h"
+#include "history_storage.h"
+#include "trace.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -13,6 +14,7 @@
  * This method extracts the initialization logic from main.cpp.
  */
 ApplicationSetup::Config ApplicationSetup::initialize() {
+    TRACE_SCOPE("ApplicationSetup::initialize");
     Config config;
     
     // Get current provider and API key
@@ -33,6 +35,7 @@ ApplicationSetup::Config ApplicationSetup::initialize() {
     
     // Handle backward compatibility migration
     migrateLegacyCurrentHistory(config);
+    migrateCurrentHistoryFormat(config);
     
     return config;
 }
@@ -86,9 +89,9 @@ std::string ApplicationSetup::getCurrentHistoryPath(const std::string& historyDi
     std::string conversationName = getCurrentConversationName();
     if (conversationName.empty()) {
         // Fallback to old naming for backward compatibility
-        return historyDir + "/current_history.json";
+        return historyDir + "/current_history" + HistoryStorage::EXTENSION;
     }
-    return historyDir + "/current_" + conversationName + ".json";
+    return historyDir + "/current_" + conversationName + HistoryStorage::EXTENSION;
 }
 
 /**
@@ -150,18 +153,7 @@ void ApplicationSetup::migrateLegacyCurrentHistory(Config& config) {
     if (FileOperations::exists(legacyPath) && config.currentConversationName.empty()) {
         try {
             // Read the legacy file to extract the first prompt
-            Json::Value history = JsonFileHandler::read(legacyPath);
-            std::string firstPrompt = "";
-            
-            if (history.isArray() && !history.empty()) {
-                for (const auto &message : history) {
-                    if (message.isMember("role") && message.isMember("content") && 
-                        message["role"].asString() == "user") {
-                        firstPrompt = message["content"].asString();
-                        break;
-                    }
-                }
-            }
+            std::string firstPrompt = HistoryStorage::findFirstMessage(legacyPath, "user");
             
             if (firstPrompt.empty()) {
                 firstPrompt = "conversation";
@@ -175,10 +167,10 @@ void ApplicationSetup::migrateLegacyCurrentHistory(Config& config) {
             config.currentConversationName = conversationName;
             config.currentHistory = getCurrentHistoryPath(config.historyDir);
             
-            // Rename the legacy file to the new name
-            FileOperations::rename(legacyPath, config.currentHistory);
+            // Convert the legacy file to the new name and format
+            HistoryStorage::migrate(legacyPath, config.currentHistory);
             
-            std::cout << "📁 Migrated legacy conversation to: current_" << conversationName << ".json" << std::endl;
+            std::cout << "📁 Migrated legacy conversation to: current_" << conversationName << HistoryStorage::EXTENSION << std::endl;
             
         } catch (const std::exception& e) {
             std::cerr << "Warning: Could not migrate legacy history file: " << e.what() << std::endl;
@@ -189,3 +181,26 @@ void ApplicationSetup::migrateLegacyCurrentHistory(Config& config) {
         }
     }
 }
+
+/**
+ * Converts the current conversation from the legacy JSON array file to the
+ * line-delimited format.
+ */
+void ApplicationSetup::migrateCurrentHistoryFormat(const Config& config) {
+    if (config.currentConversationName.empty()) {
+        return;
+    }
+    
+    std::string legacyPath = config.historyDir + "/current_" + config.currentConversationName +
+                             HistoryStorage::LEGACY_EXTENSION;
+    
+    if (!FileOperations::exists(legacyPath) || FileOperations::exists(config.currentHistory)) {
+        return;
+    }
+    
+    try {
+        HistoryStorage::migrate(legacyPath, config.currentHistory);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Could not convert history file " << legacyPath << ": " << e.what() << std::endl;
+    }
+}
@@ -2,7 +2,7 @@
 #include "blacklist_file_manager.h"
 #include "blacklist_parser.h"
 #include "blacklist_operation_factory.h"
-#include "blacklist_check_operation.h"
+#include "blacklist_index.h"
 #include "blacklist_list_operation.h"
 #include <iostream>
 #include <algorithm>
@@ -12,22 +12,8 @@
  */
 bool BlacklistManager::isModelBlacklisted(const std::string &provider, const std::string &modelName) {
     try {
-        // Use the factory to create a BlacklistCheckOperation
-        auto checkOperation = BlacklistOperationFactory::createOperation(
-            BlacklistOperationFactory::OperationType::CHECK, provider, modelName);
-        
-        // Execute the check
-        checkOperation->execute();
-        
-        // Cast to BlacklistCheckOperation to get the result
-        auto* checkOp = dynamic_cast<BlacklistCheckOperation*>(checkOperation.get());
-        if (checkOp) {
-            return checkOp->isBlacklisted();
-        }
-        
-        // Fallback - should not happen in normal operation
-        std::cerr << "Warning: Failed to cast to BlacklistCheckOperation" << std::endl;
-        return false;
+        // Answered from the process-wide index; the file is only re-parsed when it changed
+        return BlacklistIndex::contains(provider, modelName);
         
     } catch (const std::exception& e) {
         // Log error but don't crash - blacklist check should be resilient
@@ -42,6 +28,9 @@ bool BlacklistManager::isModelBlacklisted(const std::string &provider, const std
  */
 void BlacklistManager::addModelToBlacklist(const std::string &provider, const std::string &modelName, 
                                         const std::string &reason) {
+    // Check-then-append must not race with another thread adding the same model
+    std::lock_guard<std::mutex> lock(getWriteMutex());
+
     try {
         // Use the factory to create a BlacklistAddOperation
         auto addOperation = BlacklistOperationFactory::createOperation(
@@ -60,6 +49,8 @@ void BlacklistManager::addModelToBlacklist(const std::string &provider, const st
  * Removes a model from the blacklist for a specific provider.
  */
 void BlacklistManager::removeModelFromBlacklist(const std::string &provider, const std::string &modelName) {
+    std::lock_guard<std::mutex> lock(getWriteMutex());
+
     try {
         // Use the factory to create a BlacklistRemoveOperation
         auto removeOperation = BlacklistOperationFactory::createOperation(
@@ -102,3 +93,11 @@ std::vector<BlacklistEntry> BlacklistManager::getBlacklistedModels() {
         return std::vector<BlacklistEntry>();
     }
 }
+
+/**
+ * Gets the mutex that serializes modifications of the blacklist file.
+ */
+std::mutex& BlacklistManager::getWriteMutex() {
+    static std::mutex writeMutex;
+    return writeMutex;
+}
@@ -2,7 +2,22 @@
 #include "system_utils.h"
 #include "file_operations.h"
 #include "config_file_handler.h"
+#include "parsed_file_cache.h"
+#include "trace.h"
 #include <algorithm>
+#include <map>
+
+namespace {
+
+/**
+ * Parsed config files by path, shared by all lookups.
+ */
+ParsedFileCache<std::map<std::string, std::string>>& getConfigFileCache() {
+    static ParsedFileCache<std::map<std::string, std::string>> cache;
+    return cache;
+}
+
+} // namespace
 
 /**
  * Gets the main configuration directory path (~/.config/aith)
@@ -12,6 +27,19 @@ std::string ConfigManager::getConfigDir() {
     return home + "/.config/aith";
 }
 
+/**
+ * Gets the cache directory path.
+ * Follows XDG_CACHE_HOME when set, otherwise ~/.cache/aith.
+ */
+std::string ConfigManager::getCacheDir() {
+    std::string cacheHome = SystemUtils::getEnvVar("XDG_CACHE_HOME");
+    if (!cacheHome.empty()) {
+        return cacheHome + "/aith";
+    }
+    std::string home = SystemUtils::getEnvVar("HOME");
+    return home + "/.cache/aith";
+}
+
 /**
  * Gets a configuration value from environment variable or main config file.
  * Checks for the value in the following order:
@@ -33,6 +61,22 @@ std::string ConfigManager::getConfigValue(const std::string &key) {
     return readConfigFile(configPath, key);
 }
 
+/**
+ * Gets a boolean configuration value from environment variable or main config file.
+ */
+bool ConfigManager::getConfigFlag(const std::string &key, bool defaultValue) {
+    std::string value = getConfigValue(key);
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    
+    if (value == "true" || value == "yes" || value == "on" || value == "1") {
+        return true;
+    }
+    if (value == "false" || value == "no" || value == "off" || value == "0") {
+        return false;
+    }
+    return defaultValue;
+}
+
 /**
  * Gets a configuration value from a provider-specific config file.
  * Checks for the value in the following order:
@@ -61,13 +105,11 @@ std::string ConfigManager::getProviderConfigValue(const std::string &provider, c
     // Then check provider-specific config files
     std::vector<std::string> possibleConfigPaths = getProviderConfigPaths(provider);
     
-    // Try each possible config file path
+    // Try each possible config file path; missing files read as empty
     for (const auto& configPath : possibleConfigPaths) {
-        if (FileOperations::exists(configPath)) {
-            std::string value = readConfigFile(configPath, key);
-            if (!value.empty()) {
-                return value;
-            }
+        std::string value = readConfigFile(configPath, key);
+        if (!value.empty()) {
+            return value;
         }
     }
     
@@ -76,20 +118,83 @@ std::string ConfigManager::getProviderConfigValue(const std::string &provider, c
 }
 
 /**
- * Reads a configuration value from a specific file.
+ * Gets a configuration value for one model of a provider.
+ * Checks provider KEY@model, provider KEY, then main KEY.
  */
-std::string ConfigManager::readConfigFile(const std::string &configPath, const std::string &key) {
-    if (!FileOperations::exists(configPath)) {
-        return "";
+std::string ConfigManager::getModelConfigValue(const std::string &provider, const std::string &model,
+                                               const std::string &key) {
+    std::string value = getProviderConfigValue(provider, key + "@" + model);
+    if (value.empty()) {
+        value = getProviderConfigValue(provider, key);
+    }
+    if (value.empty()) {
+        value = getConfigValue(key);
+    }
+    return value;
+}
+
+/**
+ * Gets a numeric setting of a provider, or of one of its models.
+ * Unset, malformed and negative values give the default.
+ */
+double ConfigManager::getProviderNumber(const std::string &provider, const std::string &key, double defaultValue,
+                                        const std::string &model) {
+    std::string value = model.empty() ? getProviderConfigValue(provider, key) : getModelConfigValue(provider, model, key);
+    if (value.empty() && model.empty()) {
+        value = getConfigValue(key);
+    }
+    if (value.empty()) {
+        return defaultValue;
     }
     
     try {
-        std::string value = ConfigFileHandler::readValue(configPath, key);
-        return removeQuotes(value);
+        size_t end = 0;
+        double parsed = std::stod(value, &end);
+        if (end != value.size()) {
+            return defaultValue; // Trailing text such as "4abc" makes the value malformed
+        }
+        return parsed >= 0 ? parsed : defaultValue;
     } catch (const std::exception&) {
-        // If reading fails, return empty string (maintains existing behavior)
+        return defaultValue; // Ignore malformed values
+    }
+}
+
+/**
+ * Checks whether a provider has a config file of its own.
+ */
+bool ConfigManager::hasProviderConfig(const std::string &provider) {
+    if (provider.empty() || provider.front() == '.' || provider.find('/') != std::string::npos) {
+        return false;
+    }
+    for (const auto& configPath : getProviderConfigPaths(provider)) {
+        if (FileOperations::exists(configPath)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Reads a configuration value from a specific file.
+ * The file is parsed again only when its modification time or size changed.
+ */
+std::string ConfigManager::readConfigFile(const std::string &configPath, const std::string &key) {
+    TRACE_SCOPE("ConfigManager::readConfigFile");
+    auto values = getConfigFileCache().get(configPath,
+        [](const std::string& path, std::map<std::string, std::string>& parsed) {
+            try {
+                parsed = ConfigFileHandler::readAll(path);
+            } catch (const std::exception&) {
+                // If reading fails, the file has no values (maintains existing behavior)
+            }
+            return true;
+        });
+    if (!values) {
         return "";
     }
+    
+    auto value = values->find(key);
+    return value == values->end() ? "" : removeQuotes(value->second);
 }
 
 /**
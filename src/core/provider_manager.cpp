@@ -1,6 +1,8 @@
 #include "provider_manager.h"
 #include "config_manager.h"
 #include "system_utils.h"
+#include <algorithm>
+#include <stdexcept>
 
 // Static variable to store the provider specified via command line
 std::string ProviderManager::commandLineProvider = "";
@@ -54,10 +56,16 @@ std::string ProviderManager::getDefaultProvider() {
 
 /**
  * Gets the default model for the current provider.
- * Checks provider-specific config first, then falls back to main config.
  */
 std::string ProviderManager::getDefaultModel() {
-    std::string provider = ProviderManager::getAgent();
+    return getDefaultModel(getAgent());
+}
+
+/**
+ * Gets the default model for a provider.
+ * Checks provider-specific config first, then falls back to main config.
+ */
+std::string ProviderManager::getDefaultModel(const std::string &provider) {
     std::string model = ConfigManager::getProviderConfigValue(provider, "DEFAULT_MODEL");
     if (model.empty()) {
         // Fall back to main config file
@@ -68,10 +76,16 @@ std::string ProviderManager::getDefaultModel() {
 
 /**
  * Gets the API URL for the current provider.
- * Checks provider-specific config first, then falls back to main config.
  */
 std::string ProviderManager::getApiUrl() {
-    std::string provider = ProviderManager::getAgent();
+    return getApiUrl(getAgent());
+}
+
+/**
+ * Gets the API URL for a provider.
+ * Checks provider-specific config first, then falls back to main config.
+ */
+std::string ProviderManager::getApiUrl(const std::string &provider) {
     std::string url = ConfigManager::getProviderConfigValue(provider, "API_URL");
     if (url.empty()) {
         // Fall back to main config file
@@ -82,15 +96,20 @@ std::string ProviderManager::getApiUrl() {
 
 /**
  * Gets the API key for the current provider.
+ */
+std::string ProviderManager::getApiKey() {
+    return getApiKey(getAgent());
+}
+
+/**
+ * Gets the API key for a provider.
  * Checks for the API key in the following order:
  * 1. Environment variable with provider prefix (e.g., GROQ_API_KEY)
  * 2. Provider-specific config file (~/.config/aith/provider.conf)
  * 3. Generic API_KEY from main config file
  * 4. For backward compatibility: GROQ_API_KEY for groq provider
  */
-std::string ProviderManager::getApiKey() {
-    std::string provider = ProviderManager::getAgent();
-    
+std::string ProviderManager::getApiKey(const std::string &provider) {
     // Try agent-specific environment variable
     std::string envVarName = provider + "_API_KEY";
     std::string apiKey = SystemUtils::getEnvVar(envVarName);
@@ -115,3 +134,16 @@ std::string ProviderManager::getApiKey() {
     // Try generic API_KEY from main config file as last resort
     return ConfigManager::getConfigValue("API_KEY");
 }
+
+/**
+ * Gets the retry policy for a provider.
+ * Each setting is read from the provider-specific config, then the main config.
+ */
+RetryPolicy ProviderManager::getRetryPolicy(const std::string &provider) {
+    RetryPolicy policy;
+    policy.maxAttempts = std::max(1, static_cast<int>(
+        ConfigManager::getProviderNumber(provider, "RETRY_MAX_ATTEMPTS", policy.maxAttempts)));
+    policy.baseBackoffMs = static_cast<int>(ConfigManager::getProviderNumber(provider, "RETRY_BASE_MS", policy.baseBackoffMs));
+    policy.maxBackoffMs = static_cast<int>(ConfigManager::getProviderNumber(provider, "RETRY_MAX_MS", policy.maxBackoffMs));
+    return policy;
+}
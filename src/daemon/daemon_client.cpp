@@ -0,0 +1,73 @@
+#include "daemon_client.h"
+#include "daemon_protocol.h"
+#include "system_utils.h"
+#include <iostream>
+#include <unistd.h>
+
+extern char** environ;
+
+/**
+ * Checks if commands may be forwarded at all.
+ */
+bool DaemonClient::isEnabled() {
+    return SystemUtils::getEnvVar("AITH_NO_DAEMON").empty();
+}
+
+/**
+ * Lets the daemon run a command line, if one is running.
+ */
+bool DaemonClient::forward(const std::vector<std::string>& args, int& exitCode) {
+    int socket = DaemonProtocol::connectToDaemon();
+    if (socket < 0) {
+        return false;
+    }
+
+    Json::Value request(Json::objectValue);
+    request["version"] = DaemonProtocol::VERSION;
+    Json::Value& argList = request["args"] = Json::Value(Json::arrayValue);
+    for (const std::string& arg : args) {
+        argList.append(arg);
+    }
+    char cwd[4096];
+    if (::getcwd(cwd, sizeof(cwd)) != nullptr) {
+        request["cwd"] = cwd;
+    }
+    Json::Value& env = request["env"] = Json::Value(Json::arrayValue);
+    for (char** entry = environ; *entry != nullptr; ++entry) {
+        env.append(*entry);
+    }
+
+    // Nothing has run until the daemon accepts; otherwise run in-process
+    Json::Value reply;
+    if (!DaemonProtocol::send(socket, request, {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO}) ||
+        !DaemonProtocol::receive(socket, reply) || !reply["accepted"].asBool()) {
+        ::close(socket);
+        return false;
+    }
+
+    if (DaemonProtocol::receive(socket, reply) && reply["exit"].isInt()) {
+        exitCode = reply["exit"].asInt();
+    } else {
+        std::cerr << "Error: aithd stopped before the command finished" << std::endl;
+        exitCode = 1;
+    }
+    ::close(socket);
+    return true;
+}
+
+/**
+ * Sends a control request to the daemon.
+ */
+bool DaemonClient::control(const std::string& control, Json::Value& reply) {
+    int socket = DaemonProtocol::connectToDaemon();
+    if (socket < 0) {
+        return false;
+    }
+
+    Json::Value request(Json::objectValue);
+    request["version"] = DaemonProtocol::VERSION;
+    request["control"] = control;
+    bool answered = DaemonProtocol::send(socket, request) && DaemonProtocol::receive(socket, reply);
+    ::close(socket);
+    return answered;
+}
@@ -0,0 +1,206 @@
+#include "daemon_protocol.h"
+#include "config_manager.h"
+#include "system_utils.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const int DaemonProtocol::VERSION = 1;
+
+namespace {
+
+const uint32_t MAX_MESSAGE_BYTES = 16 * 1024 * 1024;
+const size_t MAX_PASSED_FDS = 8;
+
+} // namespace
+
+/**
+ * Gets the path of the daemon socket.
+ */
+std::string DaemonProtocol::getSocketPath() {
+    std::string runtimeDir = SystemUtils::getEnvVar("XDG_RUNTIME_DIR");
+    if (!runtimeDir.empty()) {
+        return runtimeDir + "/aith/aithd.sock";
+    }
+    return ConfigManager::getCacheDir() + "/aithd.sock";
+}
+
+/**
+ * Connects to the daemon socket.
+ */
+int DaemonProtocol::connectToDaemon() {
+    std::string path = getSocketPath();
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        // Missing socket or a stale one left by a daemon that is gone
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Sends a message, with optional file descriptors.
+ */
+bool DaemonProtocol::send(int socket, const Json::Value& message, const std::vector<int>& fds) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+    std::string body = Json::writeString(builder, message);
+    if (body.size() > MAX_MESSAGE_BYTES || fds.size() > MAX_PASSED_FDS) {
+        return false;
+    }
+
+    uint32_t length = htonl(static_cast<uint32_t>(body.size()));
+    if (fds.empty()) {
+        return writeAll(socket, reinterpret_cast<const char*>(&length), sizeof(length)) &&
+               writeAll(socket, body.data(), body.size());
+    }
+
+    // The descriptors ride along with the length prefix
+    iovec vector{&length, sizeof(length)};
+    char control[CMSG_SPACE(sizeof(int) * MAX_PASSED_FDS)] = {};
+    msghdr header{};
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+    cmsghdr* rights = CMSG_FIRSTHDR(&header);
+    rights->cmsg_level = SOL_SOCKET;
+    rights->cmsg_type = SCM_RIGHTS;
+    rights->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    std::memcpy(CMSG_DATA(rights), fds.data(), sizeof(int) * fds.size());
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(socket, &header, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent <= 0) {
+        return false;
+    }
+
+    const char* rest = reinterpret_cast<const char*>(&length) + sent;
+    return writeAll(socket, rest, sizeof(length) - static_cast<size_t>(sent)) &&
+           writeAll(socket, body.data(), body.size());
+}
+
+/**
+ * Receives a message and any file descriptors sent with it.
+ */
+bool DaemonProtocol::receive(int socket, Json::Value& message, std::vector<int>* fds) {
+    uint32_t length = 0;
+    iovec vector{&length, sizeof(length)};
+    char control[CMSG_SPACE(sizeof(int) * MAX_PASSED_FDS)] = {};
+    msghdr header{};
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = ::recvmsg(socket, &header, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0) {
+        return false;
+    }
+
+    std::vector<int> passed;
+    for (cmsghdr* rights = CMSG_FIRSTHDR(&header); rights != nullptr; rights = CMSG_NXTHDR(&header, rights)) {
+        if (rights->cmsg_level == SOL_SOCKET && rights->cmsg_type == SCM_RIGHTS) {
+            size_t count = (rights->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            passed.resize(count);
+            std::memcpy(passed.data(), CMSG_DATA(rights), sizeof(int) * count);
+        }
+    }
+    auto discardPassed = [&passed]() {
+        for (int fd : passed) {
+            ::close(fd);
+        }
+    };
+
+    char* rest = reinterpret_cast<char*>(&length) + received;
+    if ((header.msg_flags & MSG_CTRUNC) != 0 ||
+        !readAll(socket, rest, sizeof(length) - static_cast<size_t>(received))) {
+        discardPassed();
+        return false;
+    }
+
+    length = ntohl(length);
+    if (length > MAX_MESSAGE_BYTES) {
+        discardPassed();
+        return false;
+    }
+    std::string body(length, '\0');
+    if (!readAll(socket, &body[0], body.size())) {
+        discardPassed();
+        return false;
+    }
+
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errors;
+    if (!reader->parse(body.data(), body.data() + body.size(), &message, &errors) || !message.isObject()) {
+        discardPassed();
+        return false;
+    }
+
+    if (fds != nullptr) {
+        *fds = std::move(passed);
+    } else {
+        discardPassed();
+    }
+    return true;
+}
+
+/**
+ * Writes a buffer completely, retrying on interrupts.
+ */
+bool DaemonProtocol::writeAll(int socket, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::send(socket, data, length, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * Reads a buffer completely, retrying on interrupts.
+ */
+bool DaemonProtocol::readAll(int socket, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = ::recv(socket, data, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
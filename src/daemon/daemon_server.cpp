@@ -0,0 +1,408 @@
+#include "daemon_server.h"
+#include "daemon_protocol.h"
+#include "config_manager.h"
+#include "directory_operations.h"
+#include "metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const size_t DaemonServer::MAX_RUNNING_COMMANDS = 64;
+
+namespace {
+
+std::atomic<bool> stopRequested(false);
+const auto startTime = std::chrono::steady_clock::now();
+long served = 0;
+
+void requestStop(int) {
+    stopRequested = true;
+}
+
+/**
+ * Writes a buffer completely to a pipe, retrying on interrupts.
+ */
+void writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t count = ::write(fd, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return;
+        }
+        written += static_cast<size_t>(count);
+    }
+}
+
+} // namespace
+
+/**
+ * Listens on the daemon socket and serves clients until stopped.
+ */
+int DaemonServer::run(const CommandRunner& runCommand, const WarmUp& warmUp) {
+    std::string path = DaemonProtocol::getSocketPath();
+    int listener = openListener(path);
+    if (listener < 0) {
+        return 1;
+    }
+
+    // A client that goes away must not take the daemon with it; signals interrupt poll() to stop
+    std::signal(SIGPIPE, SIG_IGN);
+    struct sigaction stop {};
+    stop.sa_handler = requestStop;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+
+    // The daemon stays single-threaded so that forking is safe; it writes the metrics file itself
+    std::string metricsFile = ConfigManager::getConfigValue("METRICS_FILE");
+    int metricsInterval = std::atoi(ConfigManager::getConfigValue("METRICS_INTERVAL").c_str());
+    std::chrono::seconds exportInterval(metricsInterval > 0 ? metricsInterval
+                                                            : Metrics::DEFAULT_EXPORT_INTERVAL_SECONDS);
+    auto nextExport = std::chrono::steady_clock::now() + exportInterval;
+
+    warmUp();
+    std::cerr << "aithd: listening on " << path << " (pid " << ::getpid() << ")" << std::endl;
+
+    std::vector<RunningCommand> running;
+    bool accepting = true;
+    while (accepting || !running.empty()) {
+        if (accepting && stopRequested) {
+            ::close(listener);
+            ::unlink(path.c_str());
+            accepting = false;
+            if (!running.empty()) {
+                std::cerr << "aithd: waiting for " << running.size() << " running commands" << std::endl;
+            }
+            continue;
+        }
+
+        // Each command contributes its result pipe and its client connection
+        std::vector<pollfd> fds;
+        for (const RunningCommand& command : running) {
+            fds.push_back({command.resultPipe, POLLIN, 0});
+            fds.push_back({command.client, POLLIN, 0});   // Ignored by poll() once -1
+        }
+        if (accepting) {
+            fds.push_back({listener, POLLIN, 0});
+        }
+
+        int timeout = -1;
+        if (!metricsFile.empty()) {
+            auto untilExport = std::chrono::duration_cast<std::chrono::milliseconds>(
+                nextExport - std::chrono::steady_clock::now()).count();
+            timeout = static_cast<int>(std::max<long long>(untilExport, 0));
+        }
+        int ready = ::poll(fds.data(), fds.size(), timeout);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "aithd: poll failed: " << std::strerror(errno) << std::endl;
+            stopRequested = true;
+            continue;
+        }
+
+        if (!metricsFile.empty() && std::chrono::steady_clock::now() >= nextExport) {
+            Metrics::writeFile(metricsFile);
+            nextExport = std::chrono::steady_clock::now() + exportInterval;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        for (size_t i = 0; i < running.size(); ++i) {
+            RunningCommand& command = running[i];
+            // The client sends nothing after its request, so any event means it went away
+            if (command.client >= 0 && fds[2 * i + 1].revents != 0) {
+                ::kill(command.pid, SIGINT);
+                ::close(command.client);
+                command.client = -1;
+            }
+            if (fds[2 * i].revents != 0) {
+                char buffer[4096];
+                ssize_t count = ::read(command.resultPipe, buffer, sizeof(buffer));
+                if (count > 0) {
+                    command.metrics.append(buffer, static_cast<size_t>(count));
+                } else if (count == 0 || errno != EINTR) {
+                    finish(command);
+                }
+            }
+        }
+        running.erase(std::remove_if(running.begin(), running.end(),
+                                     [](const RunningCommand& command) { return command.resultPipe < 0; }),
+                      running.end());
+
+        if (accepting && (fds.back().revents & POLLIN) != 0) {
+            int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0 && isPeerTrusted(client)) {
+                if (!serve(client, listener, running, runCommand, warmUp)) {
+                    stopRequested = true;
+                }
+            } else if (client >= 0) {
+                ::close(client);
+            }
+        }
+    }
+
+    if (!metricsFile.empty()) {
+        Metrics::writeFile(metricsFile);
+    }
+    std::cerr << "aithd: stopped" << std::endl;
+    return 0;
+}
+
+/**
+ * Creates the listening socket, replacing a stale socket file.
+ */
+int DaemonServer::openListener(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "aithd: socket path too long: " << path << std::endl;
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int running = DaemonProtocol::connectToDaemon();
+    if (running >= 0) {
+        ::close(running);
+        std::cerr << "aithd: already running on " << path << std::endl;
+        return -1;
+    }
+
+    try {
+        DirectoryOperations::create(std::filesystem::path(path).parent_path().string());
+    } catch (const std::exception& e) {
+        std::cerr << "aithd: " << e.what() << std::endl;
+        return -1;
+    }
+    ::unlink(path.c_str()); // Left behind by a daemon that did not shut down cleanly
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        std::cerr << "aithd: cannot create socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    // Only the owner may connect
+    mode_t previousMask = ::umask(0177);
+    int bound = ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    ::umask(previousMask);
+    if (bound != 0 || ::listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "aithd: cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+/**
+ * Checks that a client runs as the same user as the daemon.
+ */
+bool DaemonServer::isPeerTrusted(int client) {
+    ucred credentials{};
+    socklen_t length = sizeof(credentials);
+    return ::getsockopt(client, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 &&
+           credentials.uid == ::getuid();
+}
+
+/**
+ * Reads a client's request; answers control requests and starts commands.
+ */
+bool DaemonServer::serve(int client, int listener, std::vector<RunningCommand>& running,
+                         const CommandRunner& runCommand, const WarmUp& warmUp) {
+    // A client that connects but never sends must not hold up the others
+    timeval receiveTimeout{5, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+
+    Json::Value request;
+    std::vector<int> fds;
+    if (!DaemonProtocol::receive(client, request, &fds)) {
+        ::close(client);
+        return true;
+    }
+    auto closeFds = [&fds]() {
+        for (int fd : fds) {
+            ::close(fd);
+        }
+    };
+    auto reply = [client, &closeFds](const Json::Value& message) {
+        DaemonProtocol::send(client, message);
+        closeFds();
+        ::close(client);
+    };
+
+    Json::Value answer(Json::objectValue);
+    if (!request["version"].isInt() || request["version"].asInt() != DaemonProtocol::VERSION) {
+        answer["error"] = "protocol version " + std::to_string(DaemonProtocol::VERSION) + " expected";
+        reply(answer);
+        return true;
+    }
+
+    std::string control = request["control"].asString();
+    if (control == "status") {
+        answer["pid"] = static_cast<Json::Int64>(::getpid());
+        answer["served"] = static_cast<Json::Int64>(served);
+        answer["running"] = static_cast<Json::UInt64>(running.size());
+        answer["uptimeSeconds"] = static_cast<Json::Int64>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        answer["socket"] = DaemonProtocol::getSocketPath();
+        reply(answer);
+        return true;
+    }
+    if (control == "stop") {
+        answer["stopped"] = true;
+        reply(answer);
+        return false;
+    }
+
+    if (!request["args"].isArray() || fds.size() != 3) {
+        answer["error"] = "malformed request";
+        reply(answer);
+        return true;
+    }
+    // Over the limit the client runs the command itself
+    if (running.size() >= MAX_RUNNING_COMMANDS) {
+        answer["error"] = "busy";
+        reply(answer);
+        return true;
+    }
+
+    warmUp();
+    RunningCommand command = start(request, fds, client, listener, running, runCommand);
+    closeFds();
+    if (command.pid < 0) {
+        answer["error"] = std::string("cannot start command: ") + std::strerror(errno);
+        DaemonProtocol::send(client, answer);
+        ::close(client);
+        return true;
+    }
+
+    // The command is already running, so the client must not fall back even if it missed this
+    answer["accepted"] = true;
+    DaemonProtocol::send(client, answer);
+    running.push_back(command);
+    return true;
+}
+
+/**
+ * Forks a child that runs a forwarded command on the client's descriptors.
+ */
+DaemonServer::RunningCommand DaemonServer::start(const Json::Value& request, const std::vector<int>& fds,
+                                                 int client, int listener,
+                                                 const std::vector<RunningCommand>& running,
+                                                 const CommandRunner& runCommand) {
+    RunningCommand command{-1, client, -1, ""};
+    int resultPipe[2];
+    if (::pipe2(resultPipe, O_CLOEXEC) != 0) {
+        return command;
+    }
+
+    // Buffered output would otherwise be written twice
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    command.pid = ::fork();
+    if (command.pid < 0) {
+        ::close(resultPipe[0]);
+        ::close(resultPipe[1]);
+        return command;
+    }
+    if (command.pid > 0) {
+        ::close(resultPipe[1]);
+        command.resultPipe = resultPipe[0];
+        return command;
+    }
+
+    // Child: become the client's aith process
+    ::close(listener);
+    ::close(client);
+    ::close(resultPipe[0]);
+    for (const RunningCommand& other : running) {
+        ::close(other.resultPipe);
+        if (other.client >= 0) {
+            ::close(other.client);
+        }
+    }
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGPIPE, SIG_DFL);
+
+    for (int i = 0; i < 3; ++i) {
+        ::dup2(fds[i], i);
+        ::close(fds[i]);
+    }
+    ::clearenv();
+    for (const Json::Value& entry : request["env"]) {
+        std::string variable = entry.asString();
+        size_t split = variable.find('=');
+        if (split != std::string::npos && split > 0) {
+            ::setenv(variable.substr(0, split).c_str(), variable.c_str() + split + 1, 1);
+        }
+    }
+
+    int exitCode = 1;
+    std::string cwd = request["cwd"].asString();
+    if (!cwd.empty() && ::chdir(cwd.c_str()) != 0) {
+        std::cerr << "Error: cannot change to " << cwd << ": " << std::strerror(errno) << std::endl;
+    } else {
+        std::vector<std::string> args;
+        for (const Json::Value& arg : request["args"]) {
+            args.push_back(arg.asString());
+        }
+        Metrics::reset();
+        try {
+            exitCode = runCommand(args);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    writeAll(resultPipe[1], Metrics::snapshot());
+    std::exit(exitCode);
+}
+
+/**
+ * Reaps a finished child, adds its metrics and sends the exit status to its client.
+ */
+void DaemonServer::finish(RunningCommand& command) {
+    ::close(command.resultPipe);
+    command.resultPipe = -1;
+
+    int status = 0;
+    while (::waitpid(command.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status)
+                 : WIFSIGNALED(status) ? 128 + WTERMSIG(status) : 1;
+    if (!command.metrics.empty()) {
+        Metrics::merge(command.metrics);
+    }
+    ++served;
+
+    if (command.client >= 0) {
+        Json::Value result(Json::objectValue);
+        result["exit"] = exitCode;
+        DaemonProtocol::send(command.client, result);
+        ::close(command.client);
+        command.client = -1;
+    }
+}
@@ -0,0 +1,41 @@
+#include "http_cancellation.h"
+
+/**
+ * Aborts the request, or the next one started with this object.
+ */
+void HttpCancellation::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    if (client_ != nullptr) {
+        // Shuts the socket down; the blocked send() in the other thread fails at once
+        client_->stop();
+    }
+}
+
+/**
+ * Checks if cancel() has been called.
+ */
+bool HttpCancellation::isCancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+/**
+ * Registers the client about to send the request.
+ */
+bool HttpCancellation::attach(httplib::Client& client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cancelled_) {
+        return false;
+    }
+    client_ = &client;
+    return true;
+}
+
+/**
+ * Unregisters the client once its request has returned.
+ */
+void HttpCancellation::detach() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_ = nullptr;
+}
@@ -1,7 +1,16 @@
 #include "http_client.h"
+#include "http_connection_pool.h"
+#include "http_request_timer.h"
+#include "metrics.h"
+#include "trace.h"
 #include <httplib.h>
 #include <stdexcept>
 #include <regex>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 // ====================================================================
 // HTTP client methods using httplib library
@@ -11,78 +20,434 @@
  * HTTP GET request using httplib library.
  * Offers excellent performance, error handling, and security.
  */
-std::string HttpClient::get(const std::string& url, const std::string& apiKey) {
+std::string HttpClient::get(const std::string& url, const std::string& apiKey, HttpTimings* timings) {
+    TRACE_SCOPE("HttpClient::get");
     // Parse URL to extract base URL and path
     auto [baseUrl, path] = parseUrl(url);
     
-    // Create HTTP client with base URL only
-    httplib::Client client(baseUrl);
-    configureClient(client);
-    
-    // Set headers
-    httplib::Headers headers = {
+    httplib::Request request;
+    request.method = "GET";
+    request.path = path;
+    request.headers = {
         {"Authorization", "Bearer " + apiKey},
         {"User-Agent", "aith/1.0"}
     };
     
-    // Make the request with the correct path
-    auto response = client.Get(path, headers);
+    // Make the request with the correct path on a pooled connection
+    auto response = sendTimed(baseUrl, request, timings);
     validateResponse(response, "GET");
     
     return response->body;
 }
 
+/**
+ * HTTP GET request revalidating a cached copy.
+ * A 304 response is reported as notModified instead of failing.
+ */
+HttpClient::ConditionalResponse HttpClient::getConditional(const std::string& url, const std::string& apiKey,
+                                                           const std::string& etag, const std::string& lastModified,
+                                                           HttpTimings* timings) {
+    TRACE_SCOPE("HttpClient::getConditional");
+    // Parse URL to extract base URL and path
+    auto [baseUrl, path] = parseUrl(url);
+    
+    httplib::Request request;
+    request.method = "GET";
+    request.path = path;
+    request.headers = {
+        {"Authorization", "Bearer " + apiKey},
+        {"User-Agent", "aith/1.0"}
+    };
+    if (!etag.empty()) {
+        request.set_header("If-None-Match", etag);
+    }
+    if (!lastModified.empty()) {
+        request.set_header("If-Modified-Since", lastModified);
+    }
+    
+    // Make the request with the correct path on a pooled connection
+    auto response = sendTimed(baseUrl, request, timings);
+    validateResponse(response, "GET");
+    
+    ConditionalResponse result;
+    result.notModified = response->status == 304;
+    result.etag = response->get_header_value("ETag");
+    result.lastModified = response->get_header_value("Last-Modified");
+    if (!result.notModified) {
+        result.body = response->body;
+    }
+    
+    return result;
+}
+
 /**
  * HTTP POST request with JSON payload using httplib library.
  * Offers excellent performance, error handling, and security.
  */
 std::string HttpClient::post(const std::string& url, const std::string& apiKey, 
-                            const Json::Value& payload) {
+                            const Json::Value& payload, HttpTimings* timings,
+                            const Timeouts* timeouts, const RetryPolicy* retry) {
+    TRACE_SCOPE("HttpClient::post");
     // Parse URL to extract base URL and path
     auto [baseUrl, path] = parseUrl(url);
     
-    // Create HTTP client with base URL only
-    httplib::Client client(baseUrl);
-    configureClient(client);
-    
-    // Convert JSON payload to string
-    Json::StreamWriterBuilder writer;
-    std::string jsonData = Json::writeString(writer, payload);
-   
-    // Set headers
-    httplib::Headers headers = {
+    httplib::Request request;
+    request.method = "POST";
+    request.path = path;
+    request.body = serializePayload(payload);
+    request.headers = {
         {"Authorization", "Bearer " + apiKey},
         {"Content-Type", "application/json"},
         {"User-Agent", "aith/1.0"}
     };
     
-    // Make the request with the correct path
-    auto response = client.Post(path, headers, jsonData, "application/json");
+    // Make the request with the correct path on a pooled connection
+    auto response = sendRetried(baseUrl, request, timings, nullptr, nullptr, timeouts, retry);
     validateResponse(response, "POST");
     
     return response->body;
 }
 
+/**
+ * Streaming HTTP POST request with JSON payload.
+ * Body chunks are handed to the callback as they are read from the socket.
+ */
+void HttpClient::postStream(const std::string& url, const std::string& apiKey,
+                            const Json::Value& payload, const ChunkCallback& onChunk,
+                            HttpTimings* timings, HttpCancellation* cancellation,
+                            const Timeouts* timeouts, const RetryPolicy* retry) {
+    TRACE_SCOPE("HttpClient::postStream");
+    // Parse URL to extract base URL and path
+    auto [baseUrl, path] = parseUrl(url);
+    
+    httplib::Request request;
+    request.method = "POST";
+    request.path = path;
+    request.body = serializePayload(payload);
+    request.headers = {
+        {"Authorization", "Bearer " + apiKey},
+        {"Content-Type", "application/json"},
+        {"Accept", "text/event-stream"},
+        {"User-Agent", "aith/1.0"}
+    };
+    
+    // Error bodies are collected for the error message instead of being streamed
+    int status = 0;
+    std::string errorBody;
+    bool delivered = false;
+    bool aborted = false;
+    size_t received = 0;
+    
+    request.response_handler = [&](const httplib::Response& response) {
+        status = response.status;
+        errorBody.clear(); // Only the last attempt's error is reported
+        return true;
+    };
+    request.content_receiver = [&](const char* data, size_t length, uint64_t, uint64_t) {
+        received += length;
+        if (status >= 400) {
+            errorBody.append(data, length);
+            return true;
+        }
+        delivered = true;
+        aborted = !onChunk(data, length);
+        return !aborted;
+    };
+    
+    // Make the request on a pooled connection; never replay once data was delivered
+    auto response = sendRetried(baseUrl, request, timings, [&]() { return !delivered; }, cancellation,
+                                timeouts, retry);
+    Metrics::recordHttpReceived(baseUrl, received);
+    
+    if (!response) {
+        if (aborted || (cancellation != nullptr && cancellation->isCancelled())) {
+            return; // Stopped on purpose by the callback or the caller
+        }
+        throw HttpError("HTTP POST request failed: Connection error or timeout ("
+                        + httplib::to_string(response.error()) + ")", 0);
+    }
+    
+    validateStatus(response->status, errorBody, "POST");
+}
+
+/**
+ * Enables or disables printing the timing breakdown of every request.
+ */
+void HttpClient::setTimingsEnabled(bool enabled) {
+    timingsEnabled().store(enabled);
+}
+
+/**
+ * Checks if the timing breakdown of every request is printed.
+ */
+bool HttpClient::isTimingsEnabled() {
+    return timingsEnabled().load();
+}
+
+/**
+ * Formats a timing breakdown as a single line.
+ */
+std::string HttpClient::formatTimings(const HttpTimings& timings) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1)
+         << "dns " << timings.dnsMs << "ms"
+         << ", connect " << timings.connectMs << "ms"
+         << ", tls " << timings.tlsMs << "ms"
+         << ", write " << timings.requestWriteMs << "ms"
+         << ", ttfb " << timings.firstByteMs << "ms"
+         << ", transfer " << timings.transferMs << "ms"
+         << ", total " << timings.totalMs << "ms"
+         << " | sent " << timings.bytesSent << "B, received " << timings.bytesReceived << "B"
+         << (timings.connectionReused ? ", reused connection" : ", new connection");
+    if (timings.attempts > 1) {
+        line << " | " << timings.attempts << " attempts, backoff " << timings.backoffMs << "ms";
+    }
+    return line.str();
+}
+
 // ====================================================================
 // Private utility methods for httplib implementation
 // ====================================================================
 
+/**
+ * Sends a request on a pooled client, retrying once on a fresh connection
+ * if a reused keep-alive socket turns out to be stale.
+ */
+httplib::Result HttpClient::sendPooled(const std::string& baseUrl,
+                                       const std::function<httplib::Result(httplib::Client&)>& sendRequest,
+                                       bool idempotent, const std::function<bool()>& canRetry,
+                                       HttpCancellation* cancellation,
+                                       const Timeouts* timeouts) {
+    // Keep the client registered while it sends, so cancel() can stop its socket
+    auto sendCancellable = [&](httplib::Client& client) {
+        if (cancellation == nullptr) {
+            return sendRequest(client);
+        }
+        if (!cancellation->attach(client)) {
+            return httplib::Result(nullptr, httplib::Error::Canceled);
+        }
+        auto result = sendRequest(client);
+        cancellation->detach();
+        return result;
+    };
+    
+    // Pooled clients are shared, so per-request timeouts are reset afterwards
+    auto send = [&](httplib::Client& client) {
+        if (timeouts == nullptr) {
+            return sendCancellable(client);
+        }
+        if (timeouts->connectMs > 0) {
+            client.set_connection_timeout(timeouts->connectMs / 1000, (timeouts->connectMs % 1000) * 1000);
+        }
+        if (timeouts->readMs > 0) {
+            client.set_read_timeout(timeouts->readMs / 1000, (timeouts->readMs % 1000) * 1000);
+        }
+        auto result = sendCancellable(client);
+        client.set_connection_timeout(CONNECTION_TIMEOUT_SECONDS, 0);
+        client.set_read_timeout(READ_TIMEOUT_SECONDS, 0);
+        return result;
+    };
+    
+    auto lease = HttpConnectionPool::acquire(baseUrl);
+    Metrics::recordConnection(baseUrl, lease.isReused());
+    if (!lease.isReused()) {
+        configureClient(lease.client());
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    auto response = send(lease.client());
+    
+    if (response) {
+        return response;
+    }
+    
+    // Never hand a client that just failed back to the pool
+    lease.markBroken();
+    
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    if (!lease.isReused() || !isStaleConnectionError(response.error(), elapsed.count(), idempotent)) {
+        return response;
+    }
+    
+    if ((canRetry && !canRetry()) || (cancellation != nullptr && cancellation->isCancelled())) {
+        return response;
+    }
+    
+    // Retry once on a brand new connection
+    auto freshLease = HttpConnectionPool::acquire(baseUrl, true);
+    Metrics::recordConnection(baseUrl, false);
+    configureClient(freshLease.client());
+    
+    auto retryResponse = send(freshLease.client());
+    if (!retryResponse) {
+        freshLease.markBroken();
+    }
+    return retryResponse;
+}
+
+/**
+ * Sends a request on a pooled client, measuring its phases when asked to.
+ */
+httplib::Result HttpClient::sendTimed(const std::string& baseUrl, const httplib::Request& request,
+                                      HttpTimings* timings, const std::function<bool()>& canRetry,
+                                      HttpCancellation* cancellation, const Timeouts* timeouts) {
+    TRACE_SCOPE("HttpClient::send");
+    Metrics::HttpInFlight inFlight(baseUrl);
+    auto startTime = std::chrono::steady_clock::now();
+    
+    bool report = timings == nullptr && isTimingsEnabled();
+    bool idempotent = request.method == "GET" || request.method == "HEAD";
+    httplib::Result response;
+    if (timings == nullptr && !report) {
+        response = sendPooled(baseUrl, [&](httplib::Client& client) {
+            return client.send(request);
+        }, idempotent, canRetry, cancellation, timeouts);
+    } else {
+        // Each attempt is timed separately, so the breakdown describes the last one
+        HttpTimings measured;
+        response = sendPooled(baseUrl, [&](httplib::Client& client) {
+            HttpRequestTimer timer(client, measured);
+            return timer.send(request);
+        }, idempotent, canRetry, cancellation, timeouts);
+        
+        if (timings != nullptr) {
+            *timings = measured;
+        } else {
+            reportTimings(request.method, baseUrl + request.path, measured);
+        }
+    }
+    
+    // Streamed bodies bypass response->body; postStream adds their bytes itself
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    Metrics::recordHttpRequest(baseUrl, request.method, response ? response->status : 0, elapsed.count(),
+                               request.body.size(), response ? response->body.size() : 0);
+    return response;
+}
+
+/**
+ * Sends a request like sendTimed, repeating it while the retry policy allows.
+ */
+httplib::Result HttpClient::sendRetried(const std::string& baseUrl, const httplib::Request& request,
+                                        HttpTimings* timings, const std::function<bool()>& canRetry,
+                                        HttpCancellation* cancellation, const Timeouts* timeouts,
+                                        const RetryPolicy* retry) {
+    // The report describes the request as a whole, so it is printed after the last attempt
+    HttpTimings reported;
+    if (timings == nullptr && isTimingsEnabled()) {
+        timings = &reported;
+    }
+    
+    int attempts = 0;
+    double backoffMs = 0.0;
+    auto startTime = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> retried(0.0);
+    
+    for (;;) {
+        ++attempts;
+        if (attempts > 1) {
+            retried = std::chrono::steady_clock::now() - startTime;
+        }
+        auto response = sendTimed(baseUrl, request, timings, canRetry, cancellation, timeouts);
+        if (response && retry != nullptr) {
+            reportRateLimit(*retry, *response);
+        }
+        
+        double delayMs = -1.0;
+        if (retry != nullptr && HttpRetry::isRetryable(response) && (!canRetry || canRetry()) &&
+            (cancellation == nullptr || !cancellation->isCancelled())) {
+            double serverDelayMs = response ? HttpRetry::getServerDelayMs(*response) : -1.0;
+            delayMs = HttpRetry::getDelayMs(*retry, attempts, serverDelayMs);
+        }
+        
+        if (delayMs < 0) {
+            if (timings != nullptr) {
+                timings->attempts = attempts;
+                timings->backoffMs = backoffMs;
+                timings->retriedMs = retried.count();
+            }
+            if (timings == &reported) {
+                reportTimings(request.method, baseUrl + request.path, reported);
+            }
+            return response;
+        }
+        
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delayMs));
+        backoffMs += delayMs;
+        if (retry->beforeRetry) {
+            retry->beforeRetry();
+        }
+    }
+}
+
+/**
+ * Prints the timing breakdown of a request to stderr.
+ */
+void HttpClient::reportTimings(const std::string& method, const std::string& url,
+                               const HttpTimings& timings) {
+    // One write per line keeps lines from concurrent requests intact
+    std::string line = "[timings] " + method + " " + url + ": " + formatTimings(timings) + "\n";
+    std::cerr << line << std::flush;
+}
+
+/**
+ * Passes the rate limit headers of a response to the retry policy's hook, if it has one.
+ */
+void HttpClient::reportRateLimit(const RetryPolicy& retry, const httplib::Response& response) {
+    if (!retry.onRateLimit) {
+        return;
+    }
+    
+    HttpRateLimit rateLimit = HttpRetry::getRateLimit(response);
+    if (!rateLimit.isEmpty()) {
+        retry.onRateLimit(rateLimit);
+    }
+}
+
+/**
+ * Gets the flag enabling the timing report for every request.
+ */
+std::atomic<bool>& HttpClient::timingsEnabled() {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+}
+
+/**
+ * Determines whether a failed request on a reused client looks like a
+ * stale keep-alive socket.
+ */
+bool HttpClient::isStaleConnectionError(httplib::Error error, double elapsedMs, bool idempotent) {
+    if (elapsedMs > STALE_CONNECTION_WINDOW_MS) {
+        return false;
+    }
+    // httplib checks a kept-alive socket before writing, so a POST rarely gets this far
+    return error == httplib::Error::Write || (idempotent && error == httplib::Error::Read);
+}
+
 /**
  * Validates HTTP response and throws appropriate errors.
  */
 void HttpClient::validateResponse(const httplib::Result& response, 
                                  const std::string& operation) {
     if (!response) {
-        throw std::runtime_error("HTTP " + operation + " request failed: Connection error or timeout");
+        throw HttpError("HTTP " + operation + " request failed: Connection error or timeout ("
+                        + httplib::to_string(response.error()) + ")", 0);
     }
     
+    validateStatus(response->status, response->body, operation);
+}
+
+/**
+ * Validates an HTTP status code and throws appropriate errors.
+ */
+void HttpClient::validateStatus(int status, const std::string& body,
+                                const std::string& operation) {
     // Check for HTTP error status codes
-    if (response->status >= 400) {
+    if (status >= 400) {
         std::string errorMsg = "HTTP " + operation + " request failed with status " + 
-                              std::to_string(response->status);
+                              std::to_string(status);
         
         // Add more specific error messages for common status codes
-        switch (response->status) {
+        switch (status) {
             case 400:
                 errorMsg += " (Bad Request)";
                 break;
@@ -110,14 +475,24 @@ void HttpClient::validateResponse(const httplib::Result& response,
         }
         
         // Include response body if available for debugging
-        if (!response->body.empty()) {
-            errorMsg += ". Response: " + response->body;
+        if (!body.empty()) {
+            errorMsg += ". Response: " + body;
         }
         
-        throw std::runtime_error(errorMsg);
+        throw HttpError(errorMsg, status);
     }
 }
 
+/**
+ * Serializes a JSON payload into a compact request body.
+ */
+std::string HttpClient::serializePayload(const Json::Value& payload) {
+    TRACE_SCOPE("HttpClient::serializePayload");
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, payload);
+}
+
 /**
  * Parses a full URL into base URL and path components.
  * @param url The full URL to parse
@@ -0,0 +1,150 @@
+#include "http_connection_pool.h"
+#include <utility>
+
+// ====================================================================
+// Lease
+// ====================================================================
+
+/**
+ * Constructs a lease owning a client for the given base URL.
+ */
+HttpConnectionPool::Lease::Lease(const std::string& baseUrl, std::unique_ptr<httplib::Client> client, bool reused)
+    : baseUrl_(baseUrl), client_(std::move(client)), reused_(reused), broken_(false) {
+}
+
+/**
+ * Move constructor - transfers ownership of the client.
+ */
+HttpConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : baseUrl_(std::move(other.baseUrl_)), client_(std::move(other.client_)),
+      reused_(other.reused_), broken_(other.broken_) {
+}
+
+/**
+ * Move assignment - releases the current client and takes over the other one.
+ */
+HttpConnectionPool::Lease& HttpConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        baseUrl_ = std::move(other.baseUrl_);
+        client_ = std::move(other.client_);
+        reused_ = other.reused_;
+        broken_ = other.broken_;
+    }
+    return *this;
+}
+
+/**
+ * Destructor returns the client to the pool.
+ */
+HttpConnectionPool::Lease::~Lease() {
+    release();
+}
+
+/**
+ * Returns the client to the pool (or discards it) and empties the lease.
+ */
+void HttpConnectionPool::Lease::release() {
+    if (!client_) {
+        return;
+    }
+
+    if (broken_) {
+        client_.reset();
+        return;
+    }
+
+    HttpConnectionPool::release(baseUrl_, std::move(client_));
+}
+
+// ====================================================================
+// Pool
+// ====================================================================
+
+/**
+ * Acquires a client for the given base URL.
+ */
+HttpConnectionPool::Lease HttpConnectionPool::acquire(const std::string& baseUrl, bool freshConnection) {
+    if (!freshConnection) {
+        std::lock_guard<std::mutex> lock(getMutex());
+        auto& idleClients = getIdleClients()[baseUrl];
+        Clock::time_point now = Clock::now();
+
+        // Take the most recently used client first - it is the most likely to be warm
+        while (!idleClients.empty()) {
+            IdleClient idle = std::move(idleClients.back());
+            idleClients.pop_back();
+
+            if (!isStale(idle, now)) {
+                return Lease(baseUrl, std::move(idle.client), true);
+            }
+            // Stale client is discarded when it goes out of scope
+        }
+    }
+
+    return Lease(baseUrl, std::make_unique<httplib::Client>(baseUrl), false);
+}
+
+/**
+ * Closes and discards all idle clients.
+ */
+void HttpConnectionPool::clear() {
+    std::lock_guard<std::mutex> lock(getMutex());
+    getIdleClients().clear();
+}
+
+/**
+ * Gets the number of idle clients currently pooled for a base URL.
+ */
+size_t HttpConnectionPool::idleCount(const std::string& baseUrl) {
+    std::lock_guard<std::mutex> lock(getMutex());
+    auto& idleClients = getIdleClients();
+    auto it = idleClients.find(baseUrl);
+    return it == idleClients.end() ? 0 : it->second.size();
+}
+
+/**
+ * Returns a client to the idle pool, evicting the oldest one if the host is full.
+ */
+void HttpConnectionPool::release(const std::string& baseUrl, std::unique_ptr<httplib::Client> client) {
+    std::unique_ptr<httplib::Client> evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(getMutex());
+        auto& idleClients = getIdleClients()[baseUrl];
+
+        if (idleClients.size() >= MAX_IDLE_PER_HOST) {
+            // Oldest entries sit at the front
+            evicted = std::move(idleClients.front().client);
+            idleClients.erase(idleClients.begin());
+        }
+
+        idleClients.push_back(IdleClient{std::move(client), Clock::now()});
+    }
+
+    // The evicted client closes its socket here, outside the lock
+}
+
+/**
+ * Checks whether an idle client has been unused long enough that the
+ * server has likely closed its connection.
+ */
+bool HttpConnectionPool::isStale(const IdleClient& idle, Clock::time_point now) {
+    return now - idle.lastUsed > std::chrono::seconds(IDLE_TIMEOUT_SECONDS);
+}
+
+/**
+ * Gets the mutex guarding the idle client map.
+ */
+std::mutex& HttpConnectionPool::getMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/**
+ * Gets the idle client map keyed by base URL.
+ */
+std::unordered_map<std::string, std::vector<HttpConnectionPool::IdleClient>>& HttpConnectionPool::getIdleClients() {
+    static std::unordered_map<std::string, std::vector<IdleClient>> idleClients;
+    return idleClients;
+}
@@ -0,0 +1,270 @@
+#include "http_request_timer.h"
+#include <map>
+#include <utility>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/**
+ * Starts timing and installs the connection hooks on the client.
+ */
+HttpRequestTimer::HttpRequestTimer(httplib::Client& client, HttpTimings& timings)
+    : client_(client), timings_(timings), bytesReceived_(0), addressIndex_(0) {
+    timings_ = HttpTimings();
+    start_ = Clock::now();
+
+    resolveHost();
+    dnsEnd_ = Clock::now();
+
+    // Only called when httplib opens a new socket (after name resolution)
+    client_.set_socket_options([this](int) {
+        socketCreated_ = Clock::now();
+    });
+
+    attachTls();
+}
+
+/**
+ * Removes the hooks from the client.
+ */
+HttpRequestTimer::~HttpRequestTimer() {
+    client_.set_socket_options(nullptr);
+    if (!addresses_.empty()) {
+        client_.set_hostname_addr_map({});
+    }
+    detachTls();
+}
+
+/**
+ * Sends a request on the client with timing hooks, then finishes timing.
+ */
+httplib::Result HttpRequestTimer::send(const httplib::Request& request) {
+    httplib::Request timed = instrument(request);
+    httplib::Result result = client_.send(timed);
+
+    // The request never left, so another address of the host can take it
+    while (!result && (result.error() == httplib::Error::Connection ||
+                       result.error() == httplib::Error::ConnectionTimeout) && pinNextAddress()) {
+        result = client_.send(timed);
+    }
+
+    finish(result);
+    return result;
+}
+
+/**
+ * Creates a copy of the request with timing hooks added.
+ */
+httplib::Request HttpRequestTimer::instrument(const httplib::Request& request) {
+    httplib::Request timed = request;
+
+    if (!timed.body.empty()) {
+        // httplib asks a content provider for the body only once the
+        // connection is up and the request headers have been written
+        body_ = std::move(timed.body);
+        timed.body.clear();
+        timed.content_length_ = body_.size();
+        timed.content_provider_ = [this](size_t offset, size_t length, httplib::DataSink& sink) {
+            if (offset == 0) {
+                writeStart_ = Clock::now();
+            }
+            if (!sink.write(body_.data() + offset, length)) {
+                return false;
+            }
+            if (offset + length >= body_.size()) {
+                writeEnd_ = Clock::now();
+            }
+            return true;
+        };
+    }
+
+    httplib::ResponseHandler responseHandler = request.response_handler;
+    timed.response_handler = [this, responseHandler](const httplib::Response& response) {
+        firstByte_ = Clock::now();
+        return responseHandler ? responseHandler(response) : true;
+    };
+
+    if (request.content_receiver) {
+        httplib::ContentReceiverWithProgress contentReceiver = request.content_receiver;
+        timed.content_receiver = [this, contentReceiver](const char* data, size_t length,
+                                                         uint64_t offset, uint64_t total) {
+            bytesReceived_ += length;
+            return contentReceiver(data, length, offset, total);
+        };
+    }
+
+    return timed;
+}
+
+/**
+ * Stops timing and computes the phase durations.
+ */
+void HttpRequestTimer::finish(const httplib::Result& result) {
+    Clock::time_point end = Clock::now();
+
+    timings_.connectionReused = !isSet(socketCreated_);
+    timings_.dnsMs = msBetween(start_, dnsEnd_);
+
+    // The connection is ready right away when reused, after the handshake for
+    // HTTPS and, for plain HTTP, when the first body byte is requested
+    Clock::time_point ready = dnsEnd_;
+    if (!timings_.connectionReused) {
+        if (isSet(tlsEnd_)) {
+            ready = tlsEnd_;
+            timings_.connectMs = msBetween(socketCreated_, tlsStart_);
+            timings_.tlsMs = msBetween(tlsStart_, tlsEnd_);
+        } else if (isSet(writeStart_)) {
+            ready = writeStart_;
+            timings_.connectMs = msBetween(socketCreated_, writeStart_);
+        }
+    }
+
+    // Without a body there is no write marker; the write counts as waiting time
+    Clock::time_point sent = isSet(writeEnd_) ? writeEnd_ : ready;
+    if (isSet(writeEnd_)) {
+        timings_.requestWriteMs = msBetween(ready, writeEnd_);
+    }
+
+    if (isSet(firstByte_)) {
+        timings_.firstByteMs = msBetween(sent, firstByte_);
+        timings_.transferMs = msBetween(firstByte_, end);
+    }
+    timings_.totalMs = msBetween(start_, end);
+
+    timings_.bytesSent = body_.size();
+    timings_.bytesReceived = bytesReceived_;
+    if (timings_.bytesReceived == 0 && result) {
+        timings_.bytesReceived = result->body.size();
+    }
+}
+
+/**
+ * Resolves the client's host and pins the address for this request.
+ */
+void HttpRequestTimer::resolveHost() {
+    if (client_.is_socket_open()) {
+        return; // httplib reuses the open connection; nothing to resolve
+    }
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addresses = nullptr;
+    std::string port = std::to_string(client_.port());
+    if (::getaddrinfo(client_.host().c_str(), port.c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+        return; // Let httplib resolve (and report) it as usual
+    }
+
+    for (struct addrinfo* entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        char text[INET6_ADDRSTRLEN] = {};
+        const void* address = nullptr;
+        if (entry->ai_family == AF_INET) {
+            address = &reinterpret_cast<struct sockaddr_in*>(entry->ai_addr)->sin_addr;
+        } else if (entry->ai_family == AF_INET6) {
+            address = &reinterpret_cast<struct sockaddr_in6*>(entry->ai_addr)->sin6_addr;
+        }
+        if (address != nullptr && ::inet_ntop(entry->ai_family, address, text, sizeof(text)) != nullptr) {
+            addresses_.push_back(text);
+        }
+    }
+    ::freeaddrinfo(addresses);
+
+    if (!addresses_.empty()) {
+        client_.set_hostname_addr_map({{client_.host(), addresses_.front()}});
+    }
+}
+
+/**
+ * Pins the next resolved address of the host.
+ */
+bool HttpRequestTimer::pinNextAddress() {
+    if (addressIndex_ + 1 >= addresses_.size()) {
+        return false;
+    }
+    ++addressIndex_;
+    client_.set_hostname_addr_map({{client_.host(), addresses_[addressIndex_]}});
+    return true;
+}
+
+/**
+ * Gets the duration between two recorded timestamps.
+ */
+double HttpRequestTimer::msBetween(const Clock::time_point& begin, const Clock::time_point& end) {
+    if (!isSet(begin) || !isSet(end) || end < begin) {
+        return 0.0;
+    }
+    std::chrono::duration<double, std::milli> duration = end - begin;
+    return duration.count();
+}
+
+/**
+ * Checks if a timestamp was recorded.
+ */
+bool HttpRequestTimer::isSet(const Clock::time_point& point) {
+    return point != Clock::time_point();
+}
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+
+/**
+ * Installs the OpenSSL info callback on the client's SSL context.
+ */
+void HttpRequestTimer::attachTls() {
+    SSL_CTX* context = client_.ssl_context();
+    if (context == nullptr) {
+        return; // Plain HTTP
+    }
+    // Each pooled client has its own context and serves one request at a time
+    SSL_CTX_set_ex_data(context, getTlsDataIndex(), this);
+    SSL_CTX_set_info_callback(context, &HttpRequestTimer::onTlsInfo);
+}
+
+/**
+ * Removes the OpenSSL info callback and its data from the client's SSL context.
+ */
+void HttpRequestTimer::detachTls() {
+    SSL_CTX* context = client_.ssl_context();
+    if (context != nullptr) {
+        SSL_CTX_set_info_callback(context, nullptr);
+        SSL_CTX_set_ex_data(context, getTlsDataIndex(), nullptr);
+    }
+}
+
+/**
+ * OpenSSL info callback recording the handshake start and end.
+ */
+void HttpRequestTimer::onTlsInfo(const SSL* ssl, int where, int) {
+    auto* timer = static_cast<HttpRequestTimer*>(
+        SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), getTlsDataIndex()));
+    if (timer == nullptr) {
+        return;
+    }
+
+    // TLS 1.3 session tickets report another start/done pair later; keep the first
+    if ((where & SSL_CB_HANDSHAKE_START) && !isSet(timer->tlsStart_)) {
+        timer->tlsStart_ = Clock::now();
+    }
+    if ((where & SSL_CB_HANDSHAKE_DONE) && !isSet(timer->tlsEnd_)) {
+        timer->tlsEnd_ = Clock::now();
+    }
+}
+
+/**
+ * Gets the SSL_CTX ex-data slot holding the active timer.
+ */
+int HttpRequestTimer::getTlsDataIndex() {
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+#else
+
+void HttpRequestTimer::attachTls() {
+}
+
+void HttpRequestTimer::detachTls() {
+}
+
+#endif
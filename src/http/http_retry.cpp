@@ -0,0 +1,194 @@
+#include "http_retry.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <random>
+
+namespace {
+
+/**
+ * Gets the current wall clock time in milliseconds since the epoch.
+ */
+double nowEpochMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Parses a plain non-negative number.
+ * @return The number, or -1 if the value is not one
+ */
+double parseNumber(const std::string& value) {
+    if (value.empty() || value.find_first_not_of("0123456789.") != std::string::npos) {
+        return -1.0;
+    }
+    try {
+        return std::stod(value);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+} // namespace
+
+/**
+ * Checks if a request may be repeated after this result.
+ */
+bool HttpRetry::isRetryable(const httplib::Result& response) {
+    if (!response) {
+        // Only failures before the request reached the server are safe to repeat
+        httplib::Error error = response.error();
+        return error == httplib::Error::Connection || error == httplib::Error::ConnectionTimeout ||
+               error == httplib::Error::SSLConnection;
+    }
+    int status = response->status;
+    return status == 429 || status == 502 || status == 503;
+}
+
+/**
+ * Gets the delay the server asked for before the next request.
+ */
+double HttpRetry::getServerDelayMs(const httplib::Response& response) {
+    if (response.has_header("retry-after-ms")) {
+        return parseNumber(response.get_header_value("retry-after-ms"));
+    }
+    if (response.has_header("Retry-After")) {
+        return parseRetryAfterMs(response.get_header_value("Retry-After"));
+    }
+    if (response.status != 429) {
+        return -1.0;
+    }
+
+    // Wait for the reset of whichever limit is exhausted (Groq, OpenAI)
+    double delayMs = -1.0;
+    for (const char* limit : {"requests", "tokens"}) {
+        std::string remaining = response.get_header_value(std::string("x-ratelimit-remaining-") + limit);
+        std::string reset = response.get_header_value(std::string("x-ratelimit-reset-") + limit);
+        if (remaining == "0" && !reset.empty()) {
+            delayMs = std::max(delayMs, parseDurationMs(reset));
+        }
+    }
+    if (delayMs < 0 && response.has_header("x-ratelimit-reset")) {
+        delayMs = parseResetMs(response.get_header_value("x-ratelimit-reset"));
+    }
+    return delayMs;
+}
+
+/**
+ * Reads the rate limit headers of a response.
+ */
+HttpRateLimit HttpRetry::getRateLimit(const httplib::Response& response) {
+    HttpRateLimit rateLimit;
+    rateLimit.status = response.status;
+
+    auto readHeader = [&response](const std::string& name, double (*parse)(const std::string&)) {
+        return response.has_header(name) ? parse(response.get_header_value(name)) : -1.0;
+    };
+    rateLimit.remainingRequests = readHeader("x-ratelimit-remaining-requests", parseNumber);
+    rateLimit.remainingTokens = readHeader("x-ratelimit-remaining-tokens", parseNumber);
+    rateLimit.resetRequestsMs = readHeader("x-ratelimit-reset-requests", parseDurationMs);
+    rateLimit.resetTokensMs = readHeader("x-ratelimit-reset-tokens", parseDurationMs);
+    if (rateLimit.remainingRequests < 0) {
+        rateLimit.remainingRequests = readHeader("x-ratelimit-remaining", parseNumber);
+        rateLimit.resetRequestsMs = readHeader("x-ratelimit-reset", parseResetMs);
+    }
+    if (response.status == 429 || response.status == 503) {
+        rateLimit.retryAfterMs = getServerDelayMs(response);
+    }
+    return rateLimit;
+}
+
+/**
+ * Gets the wait before the next attempt.
+ */
+double HttpRetry::getDelayMs(const RetryPolicy& policy, int attempt, double serverDelayMs) {
+    if (attempt >= policy.maxAttempts) {
+        return -1.0;
+    }
+    if (serverDelayMs >= 0) {
+        return serverDelayMs > policy.maxBackoffMs ? -1.0 : serverDelayMs;
+    }
+
+    // Full jitter: anywhere between 0 and the exponential bound
+    double bound = std::min<double>(policy.maxBackoffMs,
+                                    policy.baseBackoffMs * std::pow(2.0, std::max(attempt - 1, 0)));
+    thread_local std::mt19937 generator(std::random_device{}());
+    return std::uniform_real_distribution<double>(0.0, std::max(bound, 0.0))(generator);
+}
+
+/**
+ * Parses a rate limit reset duration such as "6s", "120ms" or "2m59.56s".
+ */
+double HttpRetry::parseDurationMs(const std::string& value) {
+    double plain = parseNumber(value);
+    if (plain >= 0) {
+        return plain * 1000.0; // Bare numbers are seconds
+    }
+
+    double totalMs = 0.0;
+    size_t pos = 0;
+    while (pos < value.size()) {
+        size_t numberEnd = value.find_first_not_of("0123456789.", pos);
+        size_t unitEnd = numberEnd == std::string::npos ? std::string::npos
+                                                        : value.find_first_of("0123456789.", numberEnd);
+        if (numberEnd == pos || numberEnd == std::string::npos) {
+            return -1.0;
+        }
+
+        double number = parseNumber(value.substr(pos, numberEnd - pos));
+        std::string unit = value.substr(numberEnd, unitEnd == std::string::npos ? std::string::npos
+                                                                                : unitEnd - numberEnd);
+        if (number < 0) {
+            return -1.0;
+        }
+        if (unit == "h") {
+            totalMs += number * 3600000.0;
+        } else if (unit == "m") {
+            totalMs += number * 60000.0;
+        } else if (unit == "s") {
+            totalMs += number * 1000.0;
+        } else if (unit == "ms") {
+            totalMs += number;
+        } else {
+            return -1.0;
+        }
+        pos = unitEnd == std::string::npos ? value.size() : unitEnd;
+    }
+    return value.empty() ? -1.0 : totalMs;
+}
+
+/**
+ * Parses a Retry-After value: delay seconds or an HTTP date.
+ */
+double HttpRetry::parseRetryAfterMs(const std::string& value) {
+    double seconds = parseNumber(value);
+    if (seconds >= 0) {
+        return seconds * 1000.0;
+    }
+
+    std::tm date = {};
+    if (strptime(value.c_str(), "%a, %d %b %Y %H:%M:%S", &date) == nullptr) {
+        return -1.0;
+    }
+    double dateMs = static_cast<double>(timegm(&date)) * 1000.0;
+    return std::max(dateMs - nowEpochMs(), 0.0);
+}
+
+/**
+ * Parses an x-ratelimit-reset value: a duration or an epoch timestamp.
+ */
+double HttpRetry::parseResetMs(const std::string& value) {
+    double number = parseNumber(value);
+    if (number < 0) {
+        return parseDurationMs(value);
+    }
+    if (number > 1e12) {
+        return std::max(number - nowEpochMs(), 0.0);            // Epoch milliseconds
+    }
+    if (number > 1e9) {
+        return std::max(number * 1000.0 - nowEpochMs(), 0.0);   // Epoch seconds
+    }
+    return number * 1000.0;
+}
@@ -1,4 +1,5 @@
 #include "markdown/common/word_wrapper.h"
+#include "trace/trace.h"
 #include <iostream>
 #include <sstream>
 #include <sys/ioctl.h>
@@ -99,6 +100,7 @@ size_t WordWrapper::calculateLineIndentation(const std::string& line) const {
 }
 
 std::string WordWrapper::wrapText(const std::string& formattedText) const {
+    TRACE_SCOPE("WordWrapper::wrapText");
     if (!enabled_) {
         return formattedText;
     }
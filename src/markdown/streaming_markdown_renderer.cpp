@@ -0,0 +1,355 @@
+#include "markdown/streaming_markdown_renderer.h"
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * Creates a streaming renderer writing to the given stream.
+ */
+StreamingMarkdownRenderer::StreamingMarkdownRenderer(std::ostream& out, bool redrawTail)
+    : out_(out), redrawTail_(redrawTail), scanPos_(0), afterBlankLine_(false),
+      inFence_(false), fenceAtTopLevel_(false), fenceChar_(0), fenceLength_(0),
+      tailRows_(0), tailTooTall_(false) {
+}
+
+/**
+ * Creates a streaming renderer writing to stdout.
+ */
+StreamingMarkdownRenderer::StreamingMarkdownRenderer()
+    : StreamingMarkdownRenderer(std::cout, isatty(STDOUT_FILENO) != 0) {
+}
+
+/**
+ * Feeds the next chunk of markdown.
+ */
+void StreamingMarkdownRenderer::feed(const std::string& chunk) {
+    pending_ += chunk;
+
+    size_t boundary = findCommitBoundary();
+    bool committed = boundary > 0;
+    if (committed) {
+        commit(boundary);
+    }
+
+    if (!redrawTail_) {
+        out_.flush();
+        return;
+    }
+
+    // Redraw right after a commit, otherwise at most once per interval
+    if (!committed && Clock::now() - lastRedraw_ < std::chrono::milliseconds(REDRAW_INTERVAL_MS)) {
+        return;
+    }
+
+    redrawTail();
+}
+
+/**
+ * Renders everything that has not been committed yet.
+ */
+void StreamingMarkdownRenderer::flush() {
+    clearTail();
+
+    if (!pending_.empty()) {
+        out_ << renderer_.render(pending_);
+    }
+    out_.flush();
+
+    pending_.clear();
+    scanPos_ = 0;
+    afterBlankLine_ = false;
+    inFence_ = false;
+    tailTooTall_ = false;
+}
+
+/**
+ * Scans newly completed lines for the last safe commit position.
+ *
+ * A position is safe when every block before it is closed at the top level:
+ * - before a line at column 0 following a blank line, unless that line
+ *   continues a list with another item
+ * - after a fenced code block opened at column 0 has been closed
+ * - before a fence opened at column 0 and after an ATX heading at column 0,
+ *   both of which interrupt any open paragraph, list or blockquote
+ * Blank lines inside fenced code never create a boundary.
+ */
+size_t StreamingMarkdownRenderer::findCommitBoundary() {
+    size_t boundary = 0;
+    size_t newline;
+
+    // Only complete lines are classified; a partial line stays in the tail
+    while ((newline = pending_.find('\n', scanPos_)) != std::string::npos) {
+        size_t start = scanPos_;
+        size_t end = newline;
+        if (end > start && pending_[end - 1] == '\r') {
+            end--;
+        }
+        scanPos_ = newline + 1;
+
+        char fenceChar;
+        size_t fenceLength;
+        size_t infoStart;
+
+        if (inFence_) {
+            if (parseFence(pending_, start, end, fenceChar, fenceLength, infoStart) &&
+                fenceChar == fenceChar_ && fenceLength >= fenceLength_ &&
+                isBlankLine(pending_, infoStart, end)) {
+                inFence_ = false;
+                if (fenceAtTopLevel_) {
+                    boundary = scanPos_;
+                }
+            }
+            continue;
+        }
+
+        if (isBlankLine(pending_, start, end)) {
+            afterBlankLine_ = true;
+            continue;
+        }
+
+        size_t indent = countIndent(pending_, start, end);
+        if (indent == 0 && afterBlankLine_ && !isListMarkerLine(pending_, start, end)) {
+            boundary = start;
+        }
+        afterBlankLine_ = false;
+
+        if (parseFence(pending_, start, end, fenceChar, fenceLength, infoStart) &&
+            (fenceChar == '~' || pending_.find('`', infoStart) >= end)) {
+            inFence_ = true;
+            fenceAtTopLevel_ = (indent == 0);
+            fenceChar_ = fenceChar;
+            fenceLength_ = fenceLength;
+            if (fenceAtTopLevel_) {
+                boundary = start;
+            }
+            continue;
+        }
+
+        if (indent == 0 && isAtxHeadingLine(pending_, start, end)) {
+            boundary = scanPos_;
+        }
+    }
+
+    return boundary;
+}
+
+/**
+ * Renders and writes the first length bytes of pending_ for good.
+ */
+void StreamingMarkdownRenderer::commit(size_t length) {
+    clearTail();
+
+    // Each committed segment starts at the top level, so a fresh RenderState is exact
+    out_ << renderer_.render(pending_.substr(0, length));
+
+    pending_.erase(0, length);
+    scanPos_ -= length;
+    tailTooTall_ = false;
+}
+
+/**
+ * Re-renders the tail and draws it in place of the previous one.
+ */
+void StreamingMarkdownRenderer::redrawTail() {
+    if (tailTooTall_) {
+        return;
+    }
+    lastRedraw_ = Clock::now();
+
+    std::string rendered;
+    if (!pending_.empty()) {
+        rendered = renderer_.render(pending_);
+    }
+
+    // Keep the cursor on the last drawn line so the tail can be erased again
+    while (!rendered.empty() && rendered.back() == '\n') {
+        rendered.pop_back();
+    }
+
+    clearTail();
+
+    if (rendered.empty()) {
+        out_.flush();
+        return;
+    }
+
+    size_t width;
+    size_t height;
+    getTerminalSize(width, height);
+
+    size_t rows = countRows(rendered);
+    if (rows >= height) {
+        // Cursor movement cannot reach above the screen; wait for the block to commit
+        tailTooTall_ = true;
+        out_.flush();
+        return;
+    }
+
+    out_ << rendered << std::flush;
+    tailRows_ = rows;
+}
+
+/**
+ * Erases the previously drawn tail from the terminal.
+ */
+void StreamingMarkdownRenderer::clearTail() {
+    if (tailRows_ == 0) {
+        return;
+    }
+
+    out_ << "\r";
+    if (tailRows_ > 1) {
+        out_ << "\033[" << (tailRows_ - 1) << "A";
+    }
+    out_ << "\033[J";
+    tailRows_ = 0;
+}
+
+/**
+ * Counts the terminal rows a rendered text occupies.
+ */
+size_t StreamingMarkdownRenderer::countRows(const std::string& rendered) const {
+    size_t width;
+    size_t height;
+    getTerminalSize(width, height);
+
+    size_t rows = 0;
+    size_t lineWidth = 0;
+    bool inAnsiSequence = false;
+
+    for (size_t i = 0; i <= rendered.size(); ++i) {
+        if (i == rendered.size() || rendered[i] == '\n') {
+            // Lines wider than the terminal (e.g. tables) wrap onto extra rows
+            rows += lineWidth == 0 ? 1 : (lineWidth + width - 1) / width;
+            lineWidth = 0;
+            continue;
+        }
+
+        unsigned char c = static_cast<unsigned char>(rendered[i]);
+        if (c == '\033') {
+            inAnsiSequence = true;
+        } else if (inAnsiSequence) {
+            if (c >= '@' && c <= '~' && c != '[') {
+                inAnsiSequence = false;
+            }
+        } else if ((c & 0xC0) != 0x80) {
+            // Count UTF-8 lead bytes only
+            lineWidth++;
+        }
+    }
+
+    return rows;
+}
+
+/**
+ * Gets the terminal width and height.
+ */
+void StreamingMarkdownRenderer::getTerminalSize(size_t& width, size_t& height) const {
+    width = 80;
+    height = 24;
+
+    struct winsize terminalSize;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &terminalSize) == 0) {
+        if (terminalSize.ws_col > 0) {
+            width = terminalSize.ws_col;
+        }
+        if (terminalSize.ws_row > 0) {
+            height = terminalSize.ws_row;
+        }
+    }
+
+    if (renderer_.getCustomTerminalWidth() > 0) {
+        width = renderer_.getCustomTerminalWidth();
+    }
+}
+
+/**
+ * Checks whether a line contains only whitespace.
+ */
+bool StreamingMarkdownRenderer::isBlankLine(const std::string& text, size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+        if (text[i] != ' ' && text[i] != '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks whether a line starts with a list item marker ("- ", "* ", "+ ", "1. ", "1) ").
+ */
+bool StreamingMarkdownRenderer::isListMarkerLine(const std::string& text, size_t start, size_t end) {
+    size_t i = start + countIndent(text, start, end);
+    if (i >= end) {
+        return false;
+    }
+
+    if (text[i] == '-' || text[i] == '*' || text[i] == '+') {
+        return i + 1 == end || text[i + 1] == ' ' || text[i + 1] == '\t';
+    }
+
+    size_t digits = 0;
+    while (i < end && digits < 10 && text[i] >= '0' && text[i] <= '9') {
+        ++i;
+        ++digits;
+    }
+    if (digits == 0 || i >= end || (text[i] != '.' && text[i] != ')')) {
+        return false;
+    }
+    return i + 1 == end || text[i + 1] == ' ' || text[i + 1] == '\t';
+}
+
+/**
+ * Checks whether a line is an ATX heading ("# Title").
+ */
+bool StreamingMarkdownRenderer::isAtxHeadingLine(const std::string& text, size_t start, size_t end) {
+    size_t i = start + countIndent(text, start, end);
+    size_t level = 0;
+    while (i < end && text[i] == '#') {
+        ++i;
+        ++level;
+    }
+    return level >= 1 && level <= 6 && (i == end || text[i] == ' ' || text[i] == '\t');
+}
+
+/**
+ * Counts the leading spaces of a line (a tab counts as four).
+ */
+size_t StreamingMarkdownRenderer::countIndent(const std::string& text, size_t start, size_t end) {
+    size_t indent = 0;
+    for (size_t i = start; i < end; ++i) {
+        if (text[i] == ' ') {
+            indent++;
+        } else if (text[i] == '\t') {
+            indent += 4;
+        } else {
+            break;
+        }
+    }
+    return indent;
+}
+
+/**
+ * Parses a code fence marker indented by at most 3 spaces.
+ */
+bool StreamingMarkdownRenderer::parseFence(const std::string& text, size_t start, size_t end,
+                                           char& fenceChar, size_t& fenceLength, size_t& infoStart) {
+    size_t indent = countIndent(text, start, end);
+    if (indent > 3) {
+        return false;
+    }
+
+    size_t i = start + indent;
+    if (i >= end || (text[i] != '`' && text[i] != '~')) {
+        return false;
+    }
+
+    fenceChar = text[i];
+    fenceLength = 0;
+    while (i < end && text[i] == fenceChar) {
+        ++i;
+        ++fenceLength;
+    }
+    infoStart = i;
+
+    return fenceLength >= 3;
+}
@@ -1,4 +1,5 @@
 #include "markdown/terminal_markdown_renderer.h"
+#include "trace/trace.h"
 #include <md4c.h>
 #include <iostream>
 #include <sstream>
@@ -73,7 +74,11 @@ std::string TerminalMarkdownRenderer::render(const std::string& markdown) {
     };
     
     // Parse the decoded markdown
-    int result = md_parse(decodedMarkdown.c_str(), decodedMarkdown.size(), &parser, &state);
+    int result;
+    {
+        TRACE_SCOPE("md_parse");
+        result = md_parse(decodedMarkdown.c_str(), decodedMarkdown.size(), &parser, &state);
+    }
     
     if (result != 0) {
         // Fallback to plain text if parsing fails
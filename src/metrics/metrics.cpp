@@ -0,0 +1,573 @@
+#include "metrics.h"
+#include <json/json.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+const int Metrics::DEFAULT_EXPORT_INTERVAL_SECONDS = 15;
+
+namespace {
+
+enum class Family : uint8_t {
+    HttpRequests,
+    HttpDuration,
+    HttpSentBytes,
+    HttpReceivedBytes,
+    HttpConnections,
+    HttpInFlight,
+    ModelRequests,
+    ModelDuration,
+    ModelInFlight,
+    CacheLookups,
+    Count
+};
+
+enum class FamilyType : uint8_t { Counter, Gauge, Histogram };
+
+struct FamilyInfo {
+    const char* name;
+    FamilyType type;
+    const char* help;
+};
+
+const FamilyInfo FAMILIES[] = {
+    {"aith_http_requests_total", FamilyType::Counter, "HTTP request attempts by response status"},
+    {"aith_http_request_duration_seconds", FamilyType::Histogram, "HTTP request attempt duration"},
+    {"aith_http_sent_bytes_total", FamilyType::Counter, "HTTP request body bytes sent"},
+    {"aith_http_received_bytes_total", FamilyType::Counter, "HTTP response body bytes received"},
+    {"aith_http_connections_total", FamilyType::Counter, "Requests sent on new or reused pooled connections"},
+    {"aith_http_requests_in_flight", FamilyType::Gauge, "HTTP requests waiting for a response"},
+    {"aith_model_requests_total", FamilyType::Counter, "Model requests by result or error class"},
+    {"aith_model_request_duration_seconds", FamilyType::Histogram, "Model request duration"},
+    {"aith_model_requests_in_flight", FamilyType::Gauge, "Model requests in progress"},
+    {"aith_response_cache_lookups_total", FamilyType::Counter, "Response cache lookups by result"},
+};
+
+// Upper bounds in seconds; chat completions range from sub-second to minutes
+const double BUCKETS[] = {0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0, 120.0};
+constexpr size_t BUCKET_COUNT = sizeof(BUCKETS) / sizeof(BUCKETS[0]);
+constexpr size_t SLOTS_PER_SHARD = 512;
+
+/**
+ * One series in one thread's shard. Only the owning thread writes it.
+ */
+struct Slot {
+    Family family = Family::Count;
+    std::string labels;
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> gauge{0};
+    std::atomic<uint64_t> sumMicros{0};
+    std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+};
+
+/**
+ * The series of one thread. Slots below `used` are initialized and never move.
+ */
+struct Shard {
+    Slot slots[SLOTS_PER_SHARD];
+    std::atomic<size_t> used{0};
+    std::atomic<uint64_t> dropped{0};
+    std::unordered_map<std::string, Slot*> index;   // Owner thread only
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<Shard*> unused;
+};
+
+// Never destroyed: threads may still record while static objects are torn down
+Registry& getRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+/**
+ * Holds a shard for the lifetime of a thread.
+ */
+struct ShardLease {
+    Shard* shard;
+
+    ShardLease() {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (!registry.unused.empty()) {
+            shard = registry.unused.back();
+            registry.unused.pop_back();
+        } else {
+            registry.shards.push_back(std::make_unique<Shard>());
+            shard = registry.shards.back().get();
+        }
+    }
+
+    ~ShardLease() {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.unused.push_back(shard);
+    }
+};
+
+Shard& getLocalShard() {
+    thread_local ShardLease lease;
+    return *lease.shard;
+}
+
+// Single writer per slot, so a plain load and store replaces a locked read-modify-write
+template <typename T>
+void add(std::atomic<T>& value, T amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * Finds or creates this thread's slot of a series.
+ * @return The slot, or nullptr if the shard is full
+ */
+Slot* getSlot(Family family, const std::string& labels) {
+    Shard& shard = getLocalShard();
+    std::string key;
+    key.reserve(labels.size() + 1);
+    key += static_cast<char>(family);
+    key += labels;
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        return it->second;
+    }
+
+    size_t used = shard.used.load(std::memory_order_relaxed);
+    if (used >= SLOTS_PER_SHARD) {
+        add<uint64_t>(shard.dropped, 1);
+        return nullptr;
+    }
+    Slot* slot = &shard.slots[used];
+    slot->family = family;
+    slot->labels = labels;
+    shard.used.store(used + 1, std::memory_order_release); // Publishes family and labels to render()
+    shard.index.emplace(std::move(key), slot);
+    return slot;
+}
+
+void increment(Family family, const std::string& labels, uint64_t amount = 1) {
+    if (Slot* slot = getSlot(family, labels)) {
+        add(slot->count, amount);
+    }
+}
+
+void adjustGauge(Family family, const std::string& labels, int64_t delta) {
+    if (Slot* slot = getSlot(family, labels)) {
+        add(slot->gauge, delta);
+    }
+}
+
+void observe(Family family, const std::string& labels, double seconds) {
+    Slot* slot = getSlot(family, labels);
+    if (slot == nullptr) {
+        return;
+    }
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT && seconds > BUCKETS[bucket]) {
+        ++bucket;
+    }
+    if (bucket < BUCKET_COUNT) {
+        add<uint64_t>(slot->buckets[bucket], 1);
+    }
+    add<uint64_t>(slot->count, 1);
+    add<uint64_t>(slot->sumMicros, static_cast<uint64_t>(seconds > 0.0 ? seconds * 1e6 : 0.0));
+}
+
+/**
+ * Escapes a label value for the text format.
+ */
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Builds a label set from name/value pairs.
+ */
+std::string makeLabels(std::initializer_list<std::pair<const char*, std::string>> labels) {
+    std::string text;
+    for (const auto& label : labels) {
+        if (!text.empty()) {
+            text += ',';
+        }
+        text += label.first;
+        text += "=\"";
+        text += escapeLabel(label.second);
+        text += '"';
+    }
+    return text;
+}
+
+/**
+ * Shortens a base URL to the host for labels.
+ */
+std::string getHostLabel(const std::string& baseUrl) {
+    size_t scheme = baseUrl.find("://");
+    return scheme == std::string::npos ? baseUrl : baseUrl.substr(scheme + 3);
+}
+
+/**
+ * A series summed over all shards.
+ */
+struct Total {
+    uint64_t count = 0;
+    int64_t gauge = 0;
+    uint64_t sumMicros = 0;
+    uint64_t buckets[BUCKET_COUNT] = {};
+};
+
+struct Exporter {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    bool stopping = false;
+};
+
+Exporter& getExporter() {
+    static Exporter* exporter = new Exporter();
+    return *exporter;
+}
+
+} // namespace
+
+/**
+ * Starts a request.
+ */
+Metrics::ModelRequest::ModelRequest(const std::string& source, const std::string& provider,
+                                    const std::string& model)
+    : source_(source), provider_(provider), model_(model), start_(std::chrono::steady_clock::now()) {
+    adjustGauge(Family::ModelInFlight, makeLabels({{"source", source_}}), 1);
+}
+
+Metrics::ModelRequest::~ModelRequest() {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    recordModelRequest(source_, provider_, model_, elapsed.count(), result_);
+    adjustGauge(Family::ModelInFlight, makeLabels({{"source", source_}}), -1);
+}
+
+Metrics::HttpInFlight::HttpInFlight(const std::string& host) : host_(getHostLabel(host)) {
+    adjustGauge(Family::HttpInFlight, makeLabels({{"host", host_}}), 1);
+}
+
+Metrics::HttpInFlight::~HttpInFlight() {
+    adjustGauge(Family::HttpInFlight, makeLabels({{"host", host_}}), -1);
+}
+
+/**
+ * Records one HTTP attempt.
+ */
+void Metrics::recordHttpRequest(const std::string& host, const std::string& method, int status,
+                                double seconds, size_t bytesSent, size_t bytesReceived) {
+    std::string hostLabel = getHostLabel(host);
+    std::string hostLabels = makeLabels({{"host", hostLabel}});
+    std::string statusLabel = status > 0 ? std::to_string(status) : "error";
+    increment(Family::HttpRequests, makeLabels({{"host", hostLabel}, {"method", method}, {"status", statusLabel}}));
+    observe(Family::HttpDuration, hostLabels, seconds);
+    increment(Family::HttpSentBytes, hostLabels, bytesSent);
+    if (bytesReceived > 0) {
+        increment(Family::HttpReceivedBytes, hostLabels, bytesReceived);
+    }
+}
+
+/**
+ * Adds streamed response bytes, which recordHttpRequest cannot see.
+ */
+void Metrics::recordHttpReceived(const std::string& host, size_t bytes) {
+    increment(Family::HttpReceivedBytes, makeLabels({{"host", getHostLabel(host)}}), bytes);
+}
+
+/**
+ * Records that a request was sent on a new or a reused pooled connection.
+ */
+void Metrics::recordConnection(const std::string& host, bool reused) {
+    increment(Family::HttpConnections, makeLabels({{"host", getHostLabel(host)}, {"reused", reused ? "true" : "false"}}));
+}
+
+/**
+ * Records a completed model request without a ModelRequest scope.
+ */
+void Metrics::recordModelRequest(const std::string& source, const std::string& provider,
+                                 const std::string& model, double seconds, const char* result) {
+    increment(Family::ModelRequests, makeLabels({{"source", source}, {"provider", provider}, {"model", model},
+                                                 {"result", result}}));
+    observe(Family::ModelDuration, makeLabels({{"source", source}, {"provider", provider}, {"model", model}}),
+            seconds);
+}
+
+/**
+ * Records a response cache lookup.
+ */
+void Metrics::recordCacheLookup(bool hit) {
+    static const std::string hitLabels = makeLabels({{"result", "hit"}});
+    static const std::string missLabels = makeLabels({{"result", "miss"}});
+    increment(Family::CacheLookups, hit ? hitLabels : missLabels);
+}
+
+/**
+ * Renders all series in the Prometheus text exposition format.
+ */
+std::string Metrics::render() {
+    // Sum the shards; slots are only ever appended, so reading them needs no lock on the writers
+    std::map<std::string, Total> totals[static_cast<size_t>(Family::Count)];
+    uint64_t dropped = 0;
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const std::unique_ptr<Shard>& shard : registry.shards) {
+            size_t used = shard->used.load(std::memory_order_acquire);
+            for (size_t i = 0; i < used; ++i) {
+                const Slot& slot = shard->slots[i];
+                Total& total = totals[static_cast<size_t>(slot.family)][slot.labels];
+                total.count += slot.count.load(std::memory_order_relaxed);
+                total.gauge += slot.gauge.load(std::memory_order_relaxed);
+                total.sumMicros += slot.sumMicros.load(std::memory_order_relaxed);
+                for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+                    total.buckets[b] += slot.buckets[b].load(std::memory_order_relaxed);
+                }
+            }
+            dropped += shard->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::ostringstream out;
+    out << std::setprecision(12);
+    for (size_t f = 0; f < static_cast<size_t>(Family::Count); ++f) {
+        const FamilyInfo& info = FAMILIES[f];
+        const char* type = info.type == FamilyType::Counter ? "counter"
+                         : info.type == FamilyType::Gauge ? "gauge" : "histogram";
+        out << "# HELP " << info.name << " " << info.help << "\n"
+            << "# TYPE " << info.name << " " << type << "\n";
+
+        for (const auto& [labels, total] : totals[f]) {
+            if (info.type == FamilyType::Counter) {
+                out << info.name << "{" << labels << "} " << total.count << "\n";
+            } else if (info.type == FamilyType::Gauge) {
+                out << info.name << "{" << labels << "} " << total.gauge << "\n";
+            } else {
+                std::string base = std::string(info.name);
+                std::string prefix = labels.empty() ? "" : labels + ",";
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+                    cumulative += total.buckets[b];
+                    out << base << "_bucket{" << prefix << "le=\"" << BUCKETS[b] << "\"} " << cumulative << "\n";
+                }
+                out << base << "_bucket{" << prefix << "le=\"+Inf\"} " << total.count << "\n"
+                    << base << "_sum{" << labels << "} " << total.sumMicros / 1e6 << "\n"
+                    << base << "_count{" << labels << "} " << total.count << "\n";
+            }
+        }
+    }
+
+    // Ratios over the process lifetime, so a scrape needs no PromQL to show them
+    auto ratio = [](uint64_t part, uint64_t whole) { return whole == 0 ? 0.0 : double(part) / double(whole); };
+    uint64_t reused = 0;
+    uint64_t connections = 0;
+    for (const auto& [labels, total] : totals[static_cast<size_t>(Family::HttpConnections)]) {
+        connections += total.count;
+        if (labels.find("reused=\"true\"") != std::string::npos) {
+            reused += total.count;
+        }
+    }
+    uint64_t hits = 0;
+    uint64_t lookups = 0;
+    for (const auto& [labels, total] : totals[static_cast<size_t>(Family::CacheLookups)]) {
+        lookups += total.count;
+        if (labels.find("result=\"hit\"") != std::string::npos) {
+            hits += total.count;
+        }
+    }
+    out << "# HELP aith_http_connection_reuse_ratio Share of requests sent on a reused pooled connection\n"
+        << "# TYPE aith_http_connection_reuse_ratio gauge\n"
+        << "aith_http_connection_reuse_ratio " << ratio(reused, connections) << "\n"
+        << "# HELP aith_response_cache_hit_ratio Share of response cache lookups that hit\n"
+        << "# TYPE aith_response_cache_hit_ratio gauge\n"
+        << "aith_response_cache_hit_ratio " << ratio(hits, lookups) << "\n"
+        << "# HELP aith_metrics_dropped_total Samples dropped because a thread had too many series\n"
+        << "# TYPE aith_metrics_dropped_total counter\n"
+        << "aith_metrics_dropped_total " << dropped << "\n";
+    return out.str();
+}
+
+/**
+ * Rewrites a file with render() periodically, on a background thread.
+ */
+void Metrics::startFileExport(const std::string& path, int intervalSeconds) {
+    Exporter& exporter = getExporter();
+    std::lock_guard<std::mutex> lock(exporter.mutex);
+    if (exporter.thread.joinable()) {
+        return;
+    }
+
+    exporter.stopping = false;
+    std::chrono::seconds interval(intervalSeconds > 0 ? intervalSeconds : DEFAULT_EXPORT_INTERVAL_SECONDS);
+    exporter.thread = std::thread([&exporter, path, interval]() {
+        bool warned = false;
+        std::unique_lock<std::mutex> lock(exporter.mutex);
+        for (;;) {
+            bool stopping = exporter.wake.wait_for(lock, interval, [&exporter]() { return exporter.stopping; });
+            lock.unlock();
+            if (!writeFile(path) && !warned) {
+                std::cerr << "Warning: Cannot write metrics to " << path << std::endl;
+                warned = true;
+            }
+            lock.lock();
+            if (stopping) {
+                return;
+            }
+        }
+    });
+}
+
+/**
+ * Stops the file export after writing the final values.
+ */
+void Metrics::stopFileExport() {
+    Exporter& exporter = getExporter();
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(exporter.mutex);
+        if (!exporter.thread.joinable()) {
+            return;
+        }
+        exporter.stopping = true;
+        thread = std::move(exporter.thread);
+    }
+    exporter.wake.notify_all();
+    thread.join();
+}
+
+/**
+ * Writes render() to a file through a temporary file and a rename.
+ */
+bool Metrics::writeFile(const std::string& path) {
+    // Readers never see a half-written file
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << render();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * Zeroes every series.
+ */
+void Metrics::reset() {
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const std::unique_ptr<Shard>& shard : registry.shards) {
+        size_t used = shard->used.load(std::memory_order_acquire);
+        for (size_t i = 0; i < used; ++i) {
+            Slot& slot = shard->slots[i];
+            slot.count.store(0, std::memory_order_relaxed);
+            slot.gauge.store(0, std::memory_order_relaxed);
+            slot.sumMicros.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t>& bucket : slot.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        shard->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Serializes the counters and histograms recorded so far.
+ */
+std::string Metrics::snapshot() {
+    Json::Value series(Json::arrayValue);
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const std::unique_ptr<Shard>& shard : registry.shards) {
+            size_t used = shard->used.load(std::memory_order_acquire);
+            for (size_t i = 0; i < used; ++i) {
+                const Slot& slot = shard->slots[i];
+                uint64_t count = slot.count.load(std::memory_order_relaxed);
+                if (count == 0) {
+                    continue;
+                }
+                Json::Value entry;
+                entry["family"] = FAMILIES[static_cast<size_t>(slot.family)].name;
+                entry["labels"] = slot.labels;
+                entry["count"] = static_cast<Json::UInt64>(count);
+                if (FAMILIES[static_cast<size_t>(slot.family)].type == FamilyType::Histogram) {
+                    entry["sumMicros"] = static_cast<Json::UInt64>(slot.sumMicros.load(std::memory_order_relaxed));
+                    Json::Value& buckets = entry["buckets"] = Json::Value(Json::arrayValue);
+                    for (const std::atomic<uint64_t>& bucket : slot.buckets) {
+                        buckets.append(static_cast<Json::UInt64>(bucket.load(std::memory_order_relaxed)));
+                    }
+                }
+                series.append(entry);
+            }
+        }
+    }
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, series);
+}
+
+/**
+ * Adds the series of another process's snapshot() to this thread's shard.
+ */
+bool Metrics::merge(const std::string& snapshot) {
+    Json::Value series;
+    Json::CharReaderBuilder reader;
+    std::string errs;
+    std::istringstream stream(snapshot);
+    if (!Json::parseFromStream(reader, stream, &series, &errs) || !series.isArray()) {
+        return false;
+    }
+
+    for (const Json::Value& entry : series) {
+        std::string name = entry["family"].asString();
+        size_t family = 0;
+        while (family < static_cast<size_t>(Family::Count) && name != FAMILIES[family].name) {
+            ++family;
+        }
+        if (family == static_cast<size_t>(Family::Count) || !entry["labels"].isString()) {
+            continue;
+        }
+        Slot* slot = getSlot(static_cast<Family>(family), entry["labels"].asString());
+        if (slot == nullptr) {
+            continue;
+        }
+        add<uint64_t>(slot->count, entry["count"].asUInt64());
+        add<uint64_t>(slot->sumMicros, entry["sumMicros"].asUInt64());
+        const Json::Value& buckets = entry["buckets"];
+        for (Json::ArrayIndex b = 0; b < buckets.size() && b < BUCKET_COUNT; ++b) {
+            add<uint64_t>(slot->buckets[b], buckets[b].asUInt64());
+        }
+    }
+    return true;
+}
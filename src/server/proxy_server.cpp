@@ -0,0 +1,465 @@
+#include "proxy_server.h"
+#include "api_models.h"
+#include "config_manager.h"
+#include "error_classifier.h"
+#include "failover_chain.h"
+#include "http_client.h"
+#include "http_error.h"
+#include "metrics.h"
+#include "model_catalog.h"
+#include "provider_manager.h"
+#include "response_cache.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Maps an error class to the error type OpenAI clients know.
+ */
+const char* getErrorType(ErrorClass errorClass) {
+    switch (errorClass) {
+        case ErrorClass::RateLimited:
+            return "rate_limit_exceeded";
+        case ErrorClass::Auth:
+            return "authentication_error";
+        case ErrorClass::ModelUnavailable:
+        case ErrorClass::BadRequest:
+            return "invalid_request_error";
+        default:
+            return "server_error";
+    }
+}
+
+/**
+ * Builds one chunk of a streamed chat completion.
+ */
+Json::Value makeChunk(const std::string& model, const Json::Value& delta, const Json::Value& finishReason) {
+    Json::Value chunk(Json::objectValue);
+    chunk["id"] = "aith-cache";
+    chunk["object"] = "chat.completion.chunk";
+    chunk["created"] = static_cast<Json::Int64>(std::time(nullptr));
+    chunk["model"] = model;
+    Json::Value choice(Json::objectValue);
+    choice["index"] = 0;
+    choice["delta"] = delta;
+    choice["finish_reason"] = finishReason;
+    chunk["choices"].append(choice);
+    return chunk;
+}
+
+} // namespace
+
+/**
+ * @brief One request in flight for a client; released when destroyed.
+ */
+class ProxyServer::ClientSlot {
+public:
+    ClientSlot(ProxyServer& server, const std::string& clientId) : server_(server), clientId_(clientId) {}
+
+    ~ClientSlot() {
+        std::lock_guard<std::mutex> lock(server_.clientsMutex_);
+        auto it = server_.activeRequests_.find(clientId_);
+        if (it != server_.activeRequests_.end() && --it->second <= 0) {
+            server_.activeRequests_.erase(it);
+        }
+    }
+
+private:
+    ProxyServer& server_;
+    std::string clientId_;
+};
+
+/**
+ * Creates a server; nothing listens until run() is called.
+ */
+ProxyServer::ProxyServer(const ProxyOptions& options) : options_(options) {
+}
+
+/**
+ * Listens and serves requests until the process ends.
+ */
+bool ProxyServer::run() {
+    size_t threads = static_cast<size_t>(std::max(options_.threads, 1));
+    server_.new_task_queue = [threads]() { return new httplib::ThreadPool(threads); };
+
+    if (!options_.token.empty()) {
+        server_.set_pre_routing_handler([this](const httplib::Request& request, httplib::Response& response) {
+            if (isAuthorized(request)) {
+                return httplib::Server::HandlerResponse::Unhandled;
+            }
+            sendError(response, 401, "Missing or wrong bearer token", "authentication_error");
+            return httplib::Server::HandlerResponse::Handled;
+        });
+    }
+    server_.Post("/v1/chat/completions", [this](const httplib::Request& request, httplib::Response& response) {
+        handleChatCompletions(request, response);
+    });
+    server_.Get("/v1/models", [this](const httplib::Request& request, httplib::Response& response) {
+        handleModels(request, response);
+    });
+    server_.Get("/metrics", [](const httplib::Request&, httplib::Response& response) {
+        response.set_content(Metrics::render(), "text/plain; version=0.0.4");
+    });
+    server_.set_logger([](const httplib::Request& request, const httplib::Response& response) {
+        std::cerr << request.remote_addr << " " << request.method << " " << request.path << " "
+                  << response.status << std::endl;
+    });
+
+    if (!server_.bind_to_port(options_.host, options_.port)) {
+        std::cerr << "Error: Cannot listen on " << options_.host << ":" << options_.port << std::endl;
+        return false;
+    }
+    std::cerr << "Serving on http://" << options_.host << ":" << options_.port << "/v1 ("
+              << threads << " threads, " << options_.maxPerClient << " requests per client"
+              << (options_.token.empty() ? "" : ", bearer token required") << ")" << std::endl;
+    return server_.listen_after_bind();
+}
+
+/**
+ * Reserves a request slot for a client.
+ */
+std::shared_ptr<ProxyServer::ClientSlot> ProxyServer::acquireSlot(const std::string& clientId) {
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        int& active = activeRequests_[clientId];
+        if (options_.maxPerClient > 0 && active >= options_.maxPerClient) {
+            return nullptr;
+        }
+        ++active;
+    }
+    return std::make_shared<ClientSlot>(*this, clientId);
+}
+
+/**
+ * Handles POST /v1/chat/completions.
+ */
+void ProxyServer::handleChatCompletions(const httplib::Request& request, httplib::Response& response) {
+    Json::Value payload;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errors;
+    if (!reader->parse(request.body.data(), request.body.data() + request.body.size(), &payload, &errors) ||
+        !payload.isObject() || !payload["messages"].isArray()) {
+        sendError(response, 400, "Expected a JSON object with a \"messages\" array", "invalid_request_error");
+        return;
+    }
+
+    std::vector<ModelTarget> chain;
+    try {
+        chain = FailoverChain::load(resolveTarget(payload["model"].asString()));
+    } catch (const std::exception& e) {
+        sendError(response, 400, e.what(), "invalid_request_error");
+        return;
+    }
+    payload["model"] = chain.front().model;
+
+    std::shared_ptr<ClientSlot> slot = acquireSlot(getClientId(request));
+    if (!slot) {
+        response.set_header("Retry-After", "1");
+        sendError(response, 429, "Too many concurrent requests from this client (limit " +
+                  std::to_string(options_.maxPerClient) + ")", "rate_limit_exceeded");
+        return;
+    }
+
+    // Identical requests to the selected model are answered from the response cache
+    bool stream = payload["stream"].asBool();
+    const ModelTarget& primary = chain.front();
+    std::string cacheKey;
+    if (ResponseCache::isEnabled()) {
+        Json::Value keyPayload = payload;
+        keyPayload.removeMember("stream");
+        keyPayload.removeMember("stream_options");
+        cacheKey = ResponseCache::makeKey(ProviderManager::getApiUrl(primary.provider), keyPayload);
+
+        std::string content;
+        if (ResponseCache::lookup(cacheKey, content)) {
+            response.set_header("X-Aith-Provider", primary.provider);
+            response.set_header("X-Aith-Model", primary.model);
+            response.set_header("X-Aith-Cache", "hit");
+            if (!stream) {
+                response.set_content(toJson(makeCompletion(primary.model, content)), "application/json");
+                return;
+            }
+
+            Json::Value delta(Json::objectValue);
+            delta["role"] = "assistant";
+            delta["content"] = content;
+            std::string events = "data: " + toJson(makeChunk(primary.model, delta, Json::nullValue)) + "\n\n" +
+                                 "data: " + toJson(makeChunk(primary.model, Json::Value(Json::objectValue), "stop")) +
+                                 "\n\n" + "data: [DONE]\n\n";
+            response.set_content(events, "text/event-stream");
+            return;
+        }
+    }
+
+    if (!stream) {
+        forwardBuffered(chain, payload, cacheKey, response);
+        return;
+    }
+
+    // The slot stays taken until the stream is finished
+    response.set_header("X-Aith-Provider", primary.provider);
+    response.set_header("X-Aith-Model", primary.model);
+    response.set_chunked_content_provider("text/event-stream",
+        [chain, payload, cacheKey, slot](size_t, httplib::DataSink& sink) {
+            forwardStreamed(chain, payload, cacheKey, sink);
+            sink.done();
+            return true;
+        });
+}
+
+/**
+ * Handles GET /v1/models.
+ */
+void ProxyServer::handleModels(const httplib::Request& request, httplib::Response& response) {
+    bool named = request.has_param("provider");
+    std::string provider = named ? request.get_param_value("provider") : ProviderManager::getAgent();
+    
+    // A client-supplied name must not reach file paths, nor pair one provider's key with another's URL
+    if (named && !ConfigManager::hasProviderConfig(provider)) {
+        sendError(response, 400, "Unknown provider: " + provider, "invalid_request_error");
+        return;
+    }
+
+    ModelCatalogResult catalog;
+    try {
+        catalog = ModelCatalog::load(provider, ProviderManager::getApiUrl(provider),
+                                     ProviderManager::getApiKey(provider));
+    } catch (const std::exception& e) {
+        sendError(response, 502, e.what(), "server_error");
+        return;
+    }
+
+    // Models of another provider than the default are listed as "provider:model"
+    Json::Value list(Json::objectValue);
+    list["object"] = "list";
+    Json::Value& data = list["data"] = Json::Value(Json::arrayValue);
+    for (const ModelInfo& model : catalog.models) {
+        if (model.isBlacklisted) {
+            continue;
+        }
+        Json::Value entry(Json::objectValue);
+        entry["id"] = named ? provider + ":" + model.id : model.id;
+        entry["object"] = "model";
+        entry["created"] = static_cast<Json::Int64>(model.created);
+        entry["owned_by"] = model.ownedBy;
+        data.append(entry);
+    }
+    response.set_content(toJson(list), "application/json");
+}
+
+/**
+ * Sends a buffered request along the failover chain and answers with the first reply.
+ */
+void ProxyServer::forwardBuffered(const std::vector<ModelTarget>& chain, const Json::Value& payload,
+                                  const std::string& cacheKey, httplib::Response& response) {
+    int status = 502;
+    FailoverResult result = FailoverChain::run(chain, payload, false, "proxy", [&](const FailoverRequest& request) {
+        status = 502;
+        try {
+            std::string body = HttpClient::post(request.apiUrl + "/chat/completions", request.apiKey,
+                                                request.payload, nullptr, request.timeouts, request.retry);
+            ChatResponse reply(body);
+            if (reply.hasError()) {
+                return FailoverResult::failure(ErrorClassifier::classifyReply(reply.getErrorMessage()),
+                                               reply.getErrorMessage());
+            }
+            if (request.index == 0 && !cacheKey.empty()) {
+                ResponseCache::store(request.target.provider, cacheKey, reply.getContent());
+            }
+            response.set_header("X-Aith-Provider", request.target.provider);
+            response.set_header("X-Aith-Model", request.target.model);
+            response.set_content(body, "application/json");
+            return FailoverResult::success();
+        } catch (const std::exception& e) {
+            // The client sees the provider's status where there was one
+            const HttpError* httpError = dynamic_cast<const HttpError*>(&e);
+            if (httpError != nullptr && httpError->getStatus() > 0) {
+                status = httpError->getStatus();
+            }
+            return FailoverResult::failure(ErrorClassifier::classify(e), e.what());
+        }
+    });
+
+    if (!result.succeeded) {
+        sendError(response, status, result.errorMessage, getErrorType(result.errorClass));
+    }
+}
+
+/**
+ * Streams a request along the failover chain into the client's connection.
+ */
+void ProxyServer::forwardStreamed(const std::vector<ModelTarget>& chain, const Json::Value& payload,
+                                  const std::string& cacheKey, httplib::DataSink& sink) {
+    bool errorPassedThrough = false;
+    FailoverResult result = FailoverChain::run(chain, payload, true, "proxy", [&](const FailoverRequest& request) {
+        // Chunks are held back until the first delta, so an early error can still fail over
+        bool started = false;
+        bool clientGone = false;
+        std::string held;
+        ChatStreamParser parser([&started](const std::string&) { started = true; });
+
+        try {
+            HttpClient::postStream(request.apiUrl + "/chat/completions", request.apiKey, request.payload,
+                [&](const char* data, size_t length) {
+                    parser.feed(data, length);
+                    if (!started) {
+                        held.append(data, length);
+                        return true;
+                    }
+                    if (!held.empty()) {
+                        held.append(data, length);
+                        clientGone = !sink.write(held.data(), held.size());
+                        held.clear();
+                    } else {
+                        clientGone = !sink.write(data, length);
+                    }
+                    return !clientGone;
+                },
+                nullptr, nullptr, request.timeouts, request.retry);
+        } catch (const std::exception& e) {
+            if (clientGone) {
+                return FailoverResult::cancel();
+            }
+            return FailoverResult::failure(ErrorClassifier::classify(e), e.what(), started);
+        }
+        if (clientGone) {
+            return FailoverResult::cancel();
+        }
+
+        parser.finish();
+        if (parser.hasError()) {
+            // After the first delta the provider's error event went out with the stream
+            errorPassedThrough = started;
+            return FailoverResult::failure(ErrorClassifier::classifyReply(parser.getErrorMessage()),
+                                           parser.getErrorMessage(), started);
+        }
+        if (!held.empty()) {
+            sink.write(held.data(), held.size()); // A reply without any content
+        }
+        if (request.index == 0 && !cacheKey.empty()) {
+            ResponseCache::store(request.target.provider, cacheKey, parser.getContent());
+        }
+        return FailoverResult::success();
+    });
+
+    // Any other failure ends the stream with an error event
+    if (!result.succeeded && !result.cancelled && !errorPassedThrough) {
+        std::string event = "data: " + toJson(makeError(result.errorMessage, getErrorType(result.errorClass))) + "\n\n";
+        sink.write(event.data(), event.size());
+    }
+}
+
+/**
+ * Finds the provider and model a request names.
+ */
+ModelTarget ProxyServer::resolveTarget(const std::string& model) {
+    // Model ids may contain ':' themselves (e.g. ":free"), so only a provider with its own config counts
+    size_t colon = model.find(':');
+    if (colon != std::string::npos && ConfigManager::hasProviderConfig(model.substr(0, colon)) &&
+        !ConfigManager::getProviderConfigValue(model.substr(0, colon), "API_URL").empty()) {
+        return ModelTarget::parse(model);
+    }
+
+    ModelTarget target;
+    target.provider = ProviderManager::getAgent();
+    target.model = model.empty() ? ProviderManager::getDefaultModel(target.provider) : model;
+    if (target.model.empty()) {
+        throw std::invalid_argument("No model given and no DEFAULT_MODEL configured for provider " +
+                                    target.provider);
+    }
+    return target;
+}
+
+/**
+ * Checks if a host name or address only accepts local connections.
+ */
+bool ProxyServer::isLoopback(const std::string& host) {
+    if (host == "localhost") {
+        return true;
+    }
+    std::string address = host.size() > 2 && host.front() == '[' && host.back() == ']'
+                        ? host.substr(1, host.size() - 2) : host;
+    in_addr ipv4{};
+    in6_addr ipv6{};
+    if (::inet_pton(AF_INET, address.c_str(), &ipv4) == 1) {
+        return (ntohl(ipv4.s_addr) >> 24) == 127;
+    }
+    return ::inet_pton(AF_INET6, address.c_str(), &ipv6) == 1 && IN6_IS_ADDR_LOOPBACK(&ipv6);
+}
+
+/**
+ * Checks a request's bearer token against options.token.
+ */
+bool ProxyServer::isAuthorized(const httplib::Request& request) const {
+    if (options_.token.empty()) {
+        return true;
+    }
+    std::string expected = "Bearer " + options_.token;
+    std::string given = request.get_header_value("Authorization");
+
+    // Compare every byte, so the time taken does not reveal how much of the token matched
+    unsigned char difference = given.size() == expected.size() ? 0 : 1;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        difference |= static_cast<unsigned char>(expected[i] ^ (i < given.size() ? given[i] : 0));
+    }
+    return difference == 0;
+}
+
+/**
+ * Gets the identity a per-client limit applies to.
+ */
+std::string ProxyServer::getClientId(const httplib::Request& request) {
+    return request.remote_addr;
+}
+
+/**
+ * Builds an OpenAI-style error body.
+ */
+Json::Value ProxyServer::makeError(const std::string& message, const std::string& type) {
+    Json::Value body(Json::objectValue);
+    body["error"]["message"] = message;
+    body["error"]["type"] = type;
+    return body;
+}
+
+/**
+ * Answers a request with an OpenAI-style error.
+ */
+void ProxyServer::sendError(httplib::Response& response, int status, const std::string& message,
+                            const std::string& type) {
+    response.status = status;
+    response.set_content(toJson(makeError(message, type)), "application/json");
+}
+
+/**
+ * Builds a chat completion object around cached content.
+ */
+Json::Value ProxyServer::makeCompletion(const std::string& model, const std::string& content) {
+    Json::Value completion(Json::objectValue);
+    completion["id"] = "aith-cache";
+    completion["object"] = "chat.completion";
+    completion["created"] = static_cast<Json::Int64>(std::time(nullptr));
+    completion["model"] = model;
+    Json::Value choice(Json::objectValue);
+    choice["index"] = 0;
+    choice["message"]["role"] = "assistant";
+    choice["message"]["content"] = content;
+    choice["finish_reason"] = "stop";
+    completion["choices"].append(choice);
+    return completion;
+}
+
+/**
+ * Serializes JSON compactly.
+ */
+std::string ProxyServer::toJson(const Json::Value& value) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    builder["emitUTF8"] = true;
+    return Json::writeString(builder, value);
+}
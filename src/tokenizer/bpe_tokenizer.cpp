@@ -0,0 +1,321 @@
+#include "bpe_tokenizer.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Byte classes of the pre-tokenizer.
+ * Bytes of multi-byte UTF-8 sequences are treated as letters.
+ */
+inline bool isLetter(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+inline bool isDigit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool isNewline(unsigned char c) {
+    return c == '\n' || c == '\r';
+}
+
+inline bool isSpace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isOther(unsigned char c) {
+    return !isSpace(c) && !isLetter(c) && !isDigit(c);
+}
+
+/**
+ * Gets the length of an English contraction suffix ('s, 't, 're, 've, 'm, 'll, 'd) at a position.
+ */
+size_t contractionLength(std::string_view text, size_t pos) {
+    if (text[pos] != '\'' || pos + 1 >= text.size()) {
+        return 0;
+    }
+    auto lower = [&text](size_t i) {
+        char c = text[i];
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    };
+    char first = lower(pos + 1);
+    if (first == 's' || first == 't' || first == 'm' || first == 'd') {
+        return 2;
+    }
+    if (pos + 2 < text.size()) {
+        char second = lower(pos + 2);
+        if ((first == 'r' && second == 'e') || (first == 'v' && second == 'e') || (first == 'l' && second == 'l')) {
+            return 3;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+/**
+ * Loads a vocabulary file.
+ */
+std::shared_ptr<const BpeTokenizer> BpeTokenizer::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open tokenizer vocabulary: " + path);
+    }
+
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer());
+
+    size_t slash = path.find_last_of('/');
+    std::string fileName = slash == std::string::npos ? path : path.substr(slash + 1);
+    tokenizer->name_ = fileName.substr(0, fileName.find('.'));
+
+    // First collect all tokens so the byte buffer never moves once views point into it
+    struct Entry {
+        size_t offset;
+        size_t length;
+        uint32_t rank;
+    };
+    std::vector<Entry> entries;
+    std::string line;
+    std::string decoded;
+    while (std::getline(file, line)) {
+        size_t space = line.find(' ');
+        if (space == std::string::npos) {
+            continue;
+        }
+        decoded.clear();
+        if (!decodeBase64(std::string_view(line).substr(0, space), decoded)) {
+            continue;
+        }
+        unsigned long rank = std::strtoul(line.c_str() + space + 1, nullptr, 10);
+        entries.push_back({tokenizer->tokenBytes_.size(), decoded.size(), static_cast<uint32_t>(rank)});
+        tokenizer->tokenBytes_ += decoded;
+    }
+
+    if (entries.empty()) {
+        throw std::runtime_error("Tokenizer vocabulary contains no tokens: " + path);
+    }
+
+    tokenizer->ranks_.reserve(entries.size());
+    std::string_view bytes(tokenizer->tokenBytes_);
+    for (const Entry& entry : entries) {
+        tokenizer->ranks_.emplace(bytes.substr(entry.offset, entry.length), entry.rank);
+    }
+
+    return tokenizer;
+}
+
+/**
+ * Encodes text into token ids.
+ */
+std::vector<uint32_t> BpeTokenizer::encode(std::string_view text) const {
+    std::vector<uint32_t> tokens;
+    tokens.reserve(text.size() / 3 + 1);
+    std::vector<size_t> boundaries;
+
+    splitPieces(text, [&](std::string_view piece) {
+        uint32_t rank = rankOf(piece);
+        if (rank != NO_RANK) {
+            tokens.push_back(rank);
+            return;
+        }
+
+        mergePiece(piece, boundaries);
+        for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+            uint32_t tokenRank = rankOf(piece.substr(boundaries[i], boundaries[i + 1] - boundaries[i]));
+            // Vocabularies without all 256 single bytes cannot encode every byte
+            tokens.push_back(tokenRank == NO_RANK ? static_cast<unsigned char>(piece[boundaries[i]]) : tokenRank);
+        }
+    });
+
+    return tokens;
+}
+
+/**
+ * Counts the tokens of a text without building the id list.
+ */
+size_t BpeTokenizer::count(std::string_view text) const {
+    size_t tokens = 0;
+    std::vector<size_t> boundaries;
+
+    splitPieces(text, [&](std::string_view piece) {
+        if (rankOf(piece) != NO_RANK) {
+            ++tokens;
+            return;
+        }
+        mergePiece(piece, boundaries);
+        tokens += boundaries.size() - 1;
+    });
+
+    return tokens;
+}
+
+/**
+ * Gets the vocabulary name.
+ */
+const std::string& BpeTokenizer::getName() const {
+    return name_;
+}
+
+/**
+ * Gets the number of tokens in the vocabulary.
+ */
+size_t BpeTokenizer::getVocabularySize() const {
+    return ranks_.size();
+}
+
+/**
+ * Splits text into the pieces that are encoded independently.
+ * Follows the cl100k pattern, in order of precedence:
+ *   's|'t|'re|'ve|'m|'ll|'d  |  [^\r\n L N]?L+  |  N{1,3}  |  ' '?[^\s L N]+[\r\n]*
+ *   \s*[\r\n]+  |  \s+(?!\S)  |  \s+
+ */
+template<typename Callback>
+void BpeTokenizer::splitPieces(std::string_view text, Callback&& onPiece) {
+    const size_t length = text.size();
+    size_t pos = 0;
+
+    while (pos < length) {
+        const unsigned char c = static_cast<unsigned char>(text[pos]);
+        size_t end = pos;
+
+        if (size_t contraction = contractionLength(text, pos)) {
+            end = pos + contraction;
+        } else if (isLetter(c) ||
+                   (!isNewline(c) && !isDigit(c) && pos + 1 < length &&
+                    isLetter(static_cast<unsigned char>(text[pos + 1])))) {
+            // Letter run with an optional leading non-letter (e.g. " word")
+            end = pos + 1;
+            while (end < length && isLetter(static_cast<unsigned char>(text[end]))) {
+                ++end;
+            }
+        } else if (isDigit(c)) {
+            end = pos + 1;
+            while (end < length && end - pos < 3 && isDigit(static_cast<unsigned char>(text[end]))) {
+                ++end;
+            }
+        } else if (isOther(c) ||
+                   (c == ' ' && pos + 1 < length && isOther(static_cast<unsigned char>(text[pos + 1])))) {
+            // Punctuation run with an optional leading space and trailing newlines
+            end = c == ' ' ? pos + 1 : pos;
+            while (end < length && isOther(static_cast<unsigned char>(text[end]))) {
+                ++end;
+            }
+            while (end < length && isNewline(static_cast<unsigned char>(text[end]))) {
+                ++end;
+            }
+        } else {
+            // Whitespace run
+            end = pos;
+            size_t lastNewline = std::string_view::npos;
+            while (end < length && isSpace(static_cast<unsigned char>(text[end]))) {
+                if (isNewline(static_cast<unsigned char>(text[end]))) {
+                    lastNewline = end;
+                }
+                ++end;
+            }
+            if (lastNewline != std::string_view::npos) {
+                end = lastNewline + 1;          // \s*[\r\n]+
+            } else if (end < length && end - pos > 1) {
+                --end;                          // \s+(?!\S): leave the last space to the next word
+            }
+        }
+
+        onPiece(text.substr(pos, end - pos));
+        pos = end;
+    }
+}
+
+/**
+ * Merges a piece and reports the boundaries of its tokens.
+ * Repeatedly merges the adjacent pair with the lowest rank, as tiktoken does.
+ */
+void BpeTokenizer::mergePiece(std::string_view piece, std::vector<size_t>& boundaries) const {
+    // parts[i] = (start offset, rank of merging part i with part i + 1)
+    struct Part {
+        size_t start;
+        uint32_t rank;
+    };
+    std::vector<Part> parts;
+    parts.reserve(piece.size() + 1);
+
+    for (size_t i = 0; i + 1 < piece.size(); ++i) {
+        parts.push_back({i, rankOf(piece.substr(i, 2))});
+    }
+    parts.push_back({piece.size() - 1, NO_RANK});
+    parts.push_back({piece.size(), NO_RANK});
+
+    auto pairRank = [&](size_t i) -> uint32_t {
+        if (i + 3 < parts.size()) {
+            return rankOf(piece.substr(parts[i].start, parts[i + 3].start - parts[i].start));
+        }
+        return NO_RANK;
+    };
+
+    while (parts.size() > 2) {
+        size_t best = 0;
+        uint32_t bestRank = NO_RANK;
+        for (size_t i = 0; i + 1 < parts.size(); ++i) {
+            if (parts[i].rank < bestRank) {
+                bestRank = parts[i].rank;
+                best = i;
+            }
+        }
+        if (bestRank == NO_RANK) {
+            break;
+        }
+
+        if (best > 0) {
+            parts[best - 1].rank = pairRank(best - 1);
+        }
+        parts[best].rank = pairRank(best);
+        parts.erase(parts.begin() + best + 1);
+    }
+
+    boundaries.clear();
+    for (const Part& part : parts) {
+        boundaries.push_back(part.start);
+    }
+}
+
+/**
+ * Looks up the rank of a byte sequence.
+ */
+uint32_t BpeTokenizer::rankOf(std::string_view bytes) const {
+    auto it = ranks_.find(bytes);
+    return it == ranks_.end() ? NO_RANK : it->second;
+}
+
+/**
+ * Decodes one base64 field of a vocabulary line.
+ */
+bool BpeTokenizer::decodeBase64(std::string_view encoded, std::string& decoded) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : encoded) {
+        if (c == '=') {
+            break;
+        }
+        int v = value(c);
+        if (v < 0) {
+            return false;
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            decoded += static_cast<char>((buffer >> bits) & 0xff);
+        }
+    }
+    return !decoded.empty();
+}
@@ -0,0 +1,107 @@
+#include "token_counter.h"
+#include "config_manager.h"
+#include "file_operations.h"
+#include <map>
+#include <mutex>
+
+const std::string TokenCounter::DEFAULT_VOCABULARY = "cl100k_base";
+const size_t TokenCounter::CHARS_PER_ESTIMATED_TOKEN = 4;
+const size_t TokenCounter::MESSAGE_OVERHEAD_TOKENS = 4;
+
+namespace {
+
+/**
+ * Loaded vocabularies by path, shared by all callers.
+ */
+struct VocabularyCache {
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const BpeTokenizer>> tokenizers;
+};
+
+VocabularyCache& getVocabularyCache() {
+    static VocabularyCache cache;
+    return cache;
+}
+
+} // namespace
+
+/**
+ * Gets the tokenizer for a provider and model.
+ */
+std::shared_ptr<const BpeTokenizer> TokenCounter::forModel(const std::string& provider, const std::string& model) {
+    std::string name = ConfigManager::getModelConfigValue(provider, model, "TOKENIZER");
+    if (name.empty()) {
+        // Use the default vocabulary only if it is installed
+        if (!FileOperations::exists(resolvePath(DEFAULT_VOCABULARY))) {
+            return nullptr;
+        }
+        name = DEFAULT_VOCABULARY;
+    }
+
+    return byName(name);
+}
+
+/**
+ * Gets a tokenizer by vocabulary name or path.
+ */
+std::shared_ptr<const BpeTokenizer> TokenCounter::byName(const std::string& nameOrPath) {
+    std::string path = resolvePath(nameOrPath);
+    VocabularyCache& cache = getVocabularyCache();
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.tokenizers.find(path);
+    if (it != cache.tokenizers.end()) {
+        return it->second;
+    }
+
+    std::shared_ptr<const BpeTokenizer> tokenizer = BpeTokenizer::load(path);
+    cache.tokenizers.emplace(path, tokenizer);
+    return tokenizer;
+}
+
+/**
+ * Counts the tokens of a text.
+ */
+size_t TokenCounter::count(std::string_view text, const BpeTokenizer* tokenizer) {
+    return tokenizer ? tokenizer->count(text) : estimate(text);
+}
+
+/**
+ * Counts the tokens of a chat message, including its framing.
+ */
+size_t TokenCounter::countMessage(const Json::Value& message, const BpeTokenizer* tokenizer) {
+    const Json::Value& content = message["content"];
+    if (!content.isString()) {
+        return MESSAGE_OVERHEAD_TOKENS;
+    }
+
+    // Borrow the string without copying it
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    content.getString(&begin, &end);
+    return count(std::string_view(begin, static_cast<size_t>(end - begin)), tokenizer) + MESSAGE_OVERHEAD_TOKENS;
+}
+
+/**
+ * Estimates the tokens of a text from its length.
+ */
+size_t TokenCounter::estimate(std::string_view text) {
+    return (text.size() + CHARS_PER_ESTIMATED_TOKEN - 1) / CHARS_PER_ESTIMATED_TOKEN;
+}
+
+/**
+ * Gets the directory holding vocabulary files.
+ */
+std::string TokenCounter::getVocabularyDir() {
+    return ConfigManager::getConfigDir() + "/tokenizers";
+}
+
+/**
+ * Resolves a vocabulary name to a file path.
+ */
+std::string TokenCounter::resolvePath(const std::string& nameOrPath) {
+    if (nameOrPath.find('/') != std::string::npos) {
+        return nameOrPath;
+    }
+    return getVocabularyDir() + "/" + nameOrPath + ".tiktoken";
+}
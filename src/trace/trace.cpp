@@ -0,0 +1,171 @@
+#include "trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+struct Event {
+    const char* name;
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+/**
+ * The spans of one thread. Its mutex is only contended while finish() copies it.
+ */
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    int tid = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;   // Kept after their thread exits
+    std::string path;
+    int nextTid = 1;
+};
+
+Registry& getRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+ThreadBuffer& getLocalBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto created = std::make_shared<ThreadBuffer>();
+        created->tid = registry.nextTid++;
+        created->name = "thread " + std::to_string(created->tid);
+        registry.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+/**
+ * Escapes a string for a JSON string literal.
+ */
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+/**
+ * Checks if this build was compiled with trace spans.
+ */
+bool Trace::isAvailable() {
+#ifdef AITH_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Starts recording spans; the calling thread is named "main".
+ */
+void Trace::start(const std::string& path) {
+    ThreadBuffer& buffer = getLocalBuffer();
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.name = "main";
+    }
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.path = path;
+    }
+    enabled_.store(true);
+}
+
+/**
+ * Stops recording and writes the trace file, if start() was called.
+ */
+bool Trace::finish() {
+    if (!enabled_.exchange(false)) {
+        return true;
+    }
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::ofstream file(registry.path, std::ios::trunc);
+    if (!file) {
+        std::cerr << "Warning: Cannot write trace to " << registry.path << std::endl;
+        return false;
+    }
+
+    long pid = static_cast<long>(::getpid());
+    size_t spans = 0;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separate = [&file, &first]() {
+        file << (first ? "" : ",\n");
+        first = false;
+    };
+
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry.buffers) {
+        std::vector<Event> events;
+        std::string name;
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            events.swap(buffer->events);
+            name = buffer->name;
+        }
+        if (events.empty()) {
+            continue;
+        }
+
+        separate();
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+             << ",\"args\":{\"name\":\"" << escapeJson(name) << "\"}}";
+
+        // Outer spans first where they start together, so viewers nest them correctly
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.startUs != b.startUs ? a.startUs < b.startUs : a.durationUs > b.durationUs;
+        });
+        for (const Event& event : events) {
+            separate();
+            file << "{\"name\":\"" << escapeJson(event.name) << "\",\"cat\":\"aith\",\"ph\":\"X\",\"ts\":"
+                 << event.startUs << ",\"dur\":" << event.durationUs << ",\"pid\":" << pid
+                 << ",\"tid\":" << buffer->tid << "}";
+        }
+        spans += events.size();
+    }
+    file << "\n]}\n";
+
+    if (!file.flush()) {
+        std::cerr << "Warning: Cannot write trace to " << registry.path << std::endl;
+        return false;
+    }
+    std::cerr << "Trace with " << spans << " spans written to " << registry.path << std::endl;
+    return true;
+}
+
+/**
+ * Adds a finished span to the calling thread's buffer.
+ */
+void Trace::record(const char* name, int64_t startUs, int64_t endUs) {
+    ThreadBuffer& buffer = getLocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(Event{name, startUs, endUs - startUs});
+}
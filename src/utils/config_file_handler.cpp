@@ -12,32 +12,70 @@ std::string ConfigFileHandler::readValue(const std::string& configPath, const st
     }
     
     std::string line;
+    std::string fileKey;
+    std::string fileValue;
     while (std::getline(file, line)) {
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-        
-        size_t pos = line.find('=');
-        if (pos != std::string::npos) {
-            std::string fileKey = line.substr(0, pos);
-            std::string fileValue = line.substr(pos + 1);
-            
-            // Trim whitespace
-            fileKey.erase(0, fileKey.find_first_not_of(" \t"));
-            fileKey.erase(fileKey.find_last_not_of(" \t") + 1);
-            fileValue.erase(0, fileValue.find_first_not_of(" \t"));
-            fileValue.erase(fileValue.find_last_not_of(" \t") + 1);
-            
-            if (fileKey == key) {
-                return fileValue;
-            }
+        if (parseLine(line, fileKey, fileValue) && fileKey == key) {
+            return fileValue;
         }
     }
     
     return ""; // Key not found
 }
 
+std::map<std::string, std::string> ConfigFileHandler::readAll(const std::string& configPath) {
+    std::ifstream file(configPath);
+    
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open config file: " + configPath);
+    }
+    
+    std::map<std::string, std::string> values;
+    std::string line;
+    std::string fileKey;
+    std::string fileValue;
+    while (std::getline(file, line)) {
+        // The first occurrence of a key wins, as in readValue
+        if (parseLine(line, fileKey, fileValue)) {
+            values.emplace(fileKey, fileValue);
+        }
+    }
+    
+    return values;
+}
+
+bool ConfigFileHandler::parseLine(const std::string& line, std::string& key, std::string& value) {
+    // Skip empty lines and comments
+    if (line.empty() || line[0] == '#') {
+        return false;
+    }
+    
+    size_t pos = line.find('=');
+    if (pos == std::string::npos) {
+        return false;
+    }
+    key = line.substr(0, pos);
+    value = line.substr(pos + 1);
+    
+    // Drop a trailing "# comment"; a '#' inside quotes or words (URL fragments) is kept
+    bool quoted = false;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '"') {
+            quoted = !quoted;
+        } else if (value[i] == '#' && !quoted && i > 0 && (value[i - 1] == ' ' || value[i - 1] == '\t')) {
+            value.erase(i);
+            break;
+        }
+    }
+    
+    // Trim whitespace
+    key.erase(0, key.find_first_not_of(" \t"));
+    key.erase(key.find_last_not_of(" \t") + 1);
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t") + 1);
+    return true;
+}
+
 void ConfigFileHandler::writeValue(const std::string& configPath, const std::string& key, 
                                    const std::string& value) {
     // Read existing config
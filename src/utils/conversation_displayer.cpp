@@ -1,5 +1,5 @@
 #include "conversation_displayer.h"
-#include "json_file_handler.h"
+#include "history_storage.h"
 #include "string_utils.h"
 #include <iostream>
 #include <iomanip>
@@ -8,10 +8,10 @@
 #include <filesystem>
 
 /**
- * Displays a complete conversation from a JSON file
+ * Displays a complete conversation from a history file (JSONL or legacy JSON)
  */
 void ConversationDisplayer::displayConversation(const std::string& filePath, bool showStats) {
-    Json::Value conversation = JsonFileHandler::read(filePath);
+    Json::Value conversation = HistoryStorage::read(filePath);
     std::string filename = extractDisplayName(filePath);
     displayConversation(conversation, filename, showStats);
 }
@@ -196,10 +196,8 @@ std::string ConversationDisplayer::extractDisplayName(const std::string& filepat
     std::filesystem::path path(filepath);
     std::string filename = path.filename().string();
     
-    // Remove .json extension
-    if (filename.length() > 5 && filename.substr(filename.length() - 5) == ".json") {
-        filename = filename.substr(0, filename.length() - 5);
-    }
+    // Remove .jsonl / .json extension
+    filename = HistoryStorage::stripExtension(filename);
     
     // Handle different filename patterns
     if (filename.substr(0, 8) == "current_") {
@@ -1,8 +1,12 @@
 #include "file_operations.h"
+#include <atomic>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
 
 // File existence and basic operations
 bool FileOperations::exists(const std::string& filePath) {
@@ -104,6 +108,35 @@ bool FileOperations::rename(const std::string& oldPath, const std::string& newPa
     }
 }
 
+bool FileOperations::updateLocked(const std::string& filePath,
+                                  const std::function<std::string(const std::string&)>& update) {
+    int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (::flock(fd, LOCK_EX) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    std::string content;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = ::pread(fd, buffer, sizeof(buffer), static_cast<off_t>(content.size()))) > 0) {
+        content.append(buffer, static_cast<size_t>(length));
+    }
+    
+    bool written = false;
+    if (length == 0) {
+        std::string updated = update(content);
+        written = ::ftruncate(fd, 0) == 0 &&
+                  ::pwrite(fd, updated.data(), updated.size(), 0) == static_cast<ssize_t>(updated.size());
+    }
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    return written;
+}
+
 bool FileOperations::copy(const std::string& sourcePath, const std::string& destPath) {
     try {
         std::filesystem::copy_file(sourcePath, destPath, 
@@ -116,6 +149,12 @@ bool FileOperations::copy(const std::string& sourcePath, const std::string& dest
     }
 }
 
+std::string FileOperations::makeTempPath(const std::string& filePath) {
+    // The pid separates processes, the counter the threads of one process (aith serve)
+    static std::atomic<unsigned long> counter{0};
+    return filePath + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+}
+
 // File metadata
 std::size_t FileOperations::getSize(const std::string& filePath) {
     try {